@@ -20,6 +20,7 @@
 #include <connectivityqt/openvpn-connection.h>
 #include <connectivityqt/internal/dbus-property-cache.h>
 #include <dbus-types.h>
+#include <vpn-fields.h>
 
 #include <OpenVpnConnectionInterface.h>
 
@@ -49,18 +50,6 @@ void OpenvpnConnection::set##uppername(type value)\
     d->m_propertyCache->set(strname, static_cast<int>(value));\
 }
 
-#define DEFINE_PROPERTY_UPDATE(varname, strname, conversion)\
-else if (name == strname)\
-{\
-    Q_EMIT p.varname##Changed(value.conversion());\
-}
-
-#define DEFINE_PROPERTY_UPDATE_ENUM(varname, strname, type)\
-else if (name == strname)\
-{\
-    Q_EMIT p.varname##Changed(static_cast<type>(value.toInt()));\
-}
-
 namespace connectivityqt
 {
 
@@ -77,64 +66,7 @@ public:
 public Q_SLOTS:
     void propertyChanged(const QString& name, const QVariant& value)
     {
-        if (name == "") {}
-
-        // Basic properties
-
-        DEFINE_PROPERTY_UPDATE(ca, "ca", toString)
-        DEFINE_PROPERTY_UPDATE_ENUM(connectionType, "connectionType", ConnectionType)
-        DEFINE_PROPERTY_UPDATE(certPass, "certPass", toString)
-        DEFINE_PROPERTY_UPDATE(cert, "cert", toString)
-        DEFINE_PROPERTY_UPDATE(key, "key", toString)
-        DEFINE_PROPERTY_UPDATE(localIp, "localIp", toString)
-        DEFINE_PROPERTY_UPDATE(password, "password", toString)
-        DEFINE_PROPERTY_UPDATE(remote, "remote", toString)
-        DEFINE_PROPERTY_UPDATE(remoteIp, "remoteIp", toString)
-        DEFINE_PROPERTY_UPDATE(staticKey, "staticKey", toString)
-        DEFINE_PROPERTY_UPDATE_ENUM(staticKeyDirection, "staticKeyDirection", KeyDir)
-        DEFINE_PROPERTY_UPDATE(username, "username", toString)
-
-        // Advanced general properties
-        DEFINE_PROPERTY_UPDATE(port, "port", toInt)
-        DEFINE_PROPERTY_UPDATE(portSet, "portSet", toBool)
-        DEFINE_PROPERTY_UPDATE(renegSeconds, "renegSeconds", toInt)
-        DEFINE_PROPERTY_UPDATE(renegSecondsSet, "renegSecondsSet", toBool)
-        DEFINE_PROPERTY_UPDATE(compLzo, "compLzo", toBool)
-        DEFINE_PROPERTY_UPDATE(protoTcp, "protoTcp", toBool)
-        DEFINE_PROPERTY_UPDATE(dev, "dev", toString)
-        DEFINE_PROPERTY_UPDATE_ENUM(devType, "devType", DevType)
-        DEFINE_PROPERTY_UPDATE(devTypeSet, "devTypeSet", toBool)
-        DEFINE_PROPERTY_UPDATE(tunnelMtu, "tunnelMtu", toInt)
-        DEFINE_PROPERTY_UPDATE(tunnelMtuSet, "tunnelMtuSet", toBool)
-        DEFINE_PROPERTY_UPDATE(fragmentSize, "fragmentSize", toInt)
-        DEFINE_PROPERTY_UPDATE(fragmentSizeSet, "fragmentSizeSet", toBool)
-        DEFINE_PROPERTY_UPDATE(mssFix, "mssFix", toBool)
-        DEFINE_PROPERTY_UPDATE(remoteRandom, "remoteRandom", toBool)
-
-        // Advanced security properties
-
-        DEFINE_PROPERTY_UPDATE_ENUM(cipher, "cipher", Cipher)
-        DEFINE_PROPERTY_UPDATE(keysize, "keysize", toInt)
-        DEFINE_PROPERTY_UPDATE(keysizeSet, "keysizeSet", toBool)
-        DEFINE_PROPERTY_UPDATE_ENUM(auth, "auth", Auth)
-
-        // Advanced TLS auth properties
-
-        DEFINE_PROPERTY_UPDATE(tlsRemote, "tlsRemote", toString)
-        DEFINE_PROPERTY_UPDATE_ENUM(remoteCertTls, "remoteCertTls", TlsType)
-        DEFINE_PROPERTY_UPDATE(remoteCertTlsSet, "remoteCertTlsSet", toBool)
-        DEFINE_PROPERTY_UPDATE(ta, "ta", toString)
-        DEFINE_PROPERTY_UPDATE_ENUM(taDir, "taDir", KeyDir)
-        DEFINE_PROPERTY_UPDATE(taSet, "taSet", toBool)
-
-        // Advanced proxy settings
-
-        DEFINE_PROPERTY_UPDATE_ENUM(proxyType, "proxyType", ProxyType)
-        DEFINE_PROPERTY_UPDATE(proxyServer, "proxyServer", toString)
-        DEFINE_PROPERTY_UPDATE(proxyPort, "proxyPort", toInt)
-        DEFINE_PROPERTY_UPDATE(proxyRetry, "proxyRetry", toBool)
-        DEFINE_PROPERTY_UPDATE(proxyUsername, "proxyUsername", toString)
-        DEFINE_PROPERTY_UPDATE(proxyPassword, "proxyPassword", toString)
+        vpnfields::notify(vpnfields::openvpn::FIELDS, p, name, value);
     }
 
 public:
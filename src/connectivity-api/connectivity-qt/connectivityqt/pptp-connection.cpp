@@ -20,6 +20,7 @@
 #include <connectivityqt/pptp-connection.h>
 #include <connectivityqt/internal/dbus-property-cache.h>
 #include <dbus-types.h>
+#include <vpn-fields.h>
 
 #include <PptpConnectionInterface.h>
 
@@ -49,18 +50,6 @@ void PptpConnection::set##uppername(type value)\
     d->m_propertyCache->set(strname, static_cast<int>(value));\
 }
 
-#define DEFINE_PROPERTY_UPDATE(varname, strname, conversion)\
-else if (name == strname)\
-{\
-    Q_EMIT p.varname##Changed(value.conversion());\
-}
-
-#define DEFINE_PROPERTY_UPDATE_ENUM(varname, strname, type)\
-else if (name == strname)\
-{\
-    Q_EMIT p.varname##Changed(static_cast<type>(value.toInt()));\
-}
-
 namespace connectivityqt
 {
 
@@ -77,29 +66,7 @@ public:
 public Q_SLOTS:
     void propertyChanged(const QString& name, const QVariant& value)
     {
-        if (name == "") {}
-
-        // Basic properties
-
-        DEFINE_PROPERTY_UPDATE(gateway, "gateway", toString)
-        DEFINE_PROPERTY_UPDATE(user, "user", toString)
-        DEFINE_PROPERTY_UPDATE(password, "password", toString)
-        DEFINE_PROPERTY_UPDATE(domain, "domain", toString)
-
-        // Advanced properties
-
-        DEFINE_PROPERTY_UPDATE(allowPap, "allowPap", toBool)
-        DEFINE_PROPERTY_UPDATE(allowChap, "allowChap", toBool)
-        DEFINE_PROPERTY_UPDATE(allowMschap, "allowMschap", toBool)
-        DEFINE_PROPERTY_UPDATE(allowMschapv2, "allowMschapv2", toBool)
-        DEFINE_PROPERTY_UPDATE(allowEap, "allowEap", toBool)
-        DEFINE_PROPERTY_UPDATE(requireMppe, "requireMppe", toBool)
-        DEFINE_PROPERTY_UPDATE_ENUM(mppeType, "mppeType", MppeType)
-        DEFINE_PROPERTY_UPDATE(mppeStateful, "mppeStateful", toBool)
-        DEFINE_PROPERTY_UPDATE(bsdCompression, "bsdCompression", toBool)
-        DEFINE_PROPERTY_UPDATE(deflateCompression, "deflateCompression", toBool)
-        DEFINE_PROPERTY_UPDATE(tcpHeaderCompression, "tcpHeaderCompression", toBool)
-        DEFINE_PROPERTY_UPDATE(sendPppEchoPackets, "sendPppEchoPackets", toBool)
+        vpnfields::notify(vpnfields::pptp::FIELDS, p, name, value);
     }
 
 public:
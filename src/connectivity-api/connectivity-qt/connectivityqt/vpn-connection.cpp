@@ -83,6 +83,10 @@ VpnConnection::VpnConnection(const QDBusObjectPath& path, const QDBusConnection&
     connect(d->m_propertyCache.get(),
                 &internal::DBusPropertyCache::propertyChanged, d.get(),
                 &Priv::propertyChanged);
+
+    connect(d->m_vpnInterface.get(),
+                &ComUbuntuConnectivity1VpnVpnConnectionInterface::SettingsWritten,
+                this, &VpnConnection::settingsWritten);
 }
 
 VpnConnection::~VpnConnection()
@@ -83,6 +83,8 @@ Q_SIGNALS:
 
     void activatableChanged(bool active);
 
+    void settingsWritten(bool success);
+
     void remove() const;
 
 protected:
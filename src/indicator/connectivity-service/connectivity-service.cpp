@@ -29,6 +29,8 @@
 #include <dbus-types.h>
 #include <util/dbus-utils.h>
 
+#include <QCoreApplication>
+
 using namespace nmofono;
 using namespace nmofono::vpn;
 using namespace std;
@@ -57,24 +59,53 @@ public:
 
     QStringList m_limitations;
 
+    bool m_registered = false;
+
     QString m_status;
 
     QMap<QString, QDBusMessage> m_addQueue;
 
+    // indices for m_propertyNotifier
+    enum Property
+    {
+        FlightMode,
+        FlightModeSwitchEnabled,
+        WifiEnabled,
+        WifiSwitchEnabled,
+        HotspotSwitchEnabled,
+        HotspotSsid,
+        HotspotEnabled,
+        HotspotMode,
+        HotspotStored,
+        ModemAvailable,
+        Status,
+        Limitations
+    };
+
+    unique_ptr<DBusUtils::PropertyNotifier> m_propertyNotifier;
+
+    // indices for m_privatePropertyNotifier
+    enum PrivateProperty
+    {
+        HotspotPassword,
+        HotspotAuth,
+        MobileDataEnabled,
+        SimForMobileData,
+        Sims,
+        Modems,
+        VpnConnections
+    };
+
+    unique_ptr<DBusUtils::PropertyNotifier> m_privatePropertyNotifier;
+
     Private(ConnectivityService& parent, const QDBusConnection& connection) :
         p(parent), m_connection(connection)
     {
     }
 
-    void notifyProperties(const QStringList& propertyNames)
+    void notifyProperties(std::initializer_list<int> properties)
     {
-        DBusUtils::notifyPropertyChanged(
-            m_connection,
-            p,
-            DBusTypes::SERVICE_PATH,
-            DBusTypes::SERVICE_INTERFACE,
-            propertyNames
-        );
+        m_propertyNotifier->notify(properties);
     }
 
     void flushProperties()
@@ -82,40 +113,51 @@ public:
         DBusUtils::flushPropertyChanges();
     }
 
-    void notifyPrivateProperties(const QStringList& propertyNames)
+    void notifyPrivateProperties(std::initializer_list<int> properties)
     {
-        DBusUtils::notifyPropertyChanged(
-            m_connection,
-            *m_privateService,
-            DBusTypes::PRIVATE_PATH,
-            DBusTypes::PRIVATE_INTERFACE,
-            propertyNames
-        );
+        m_privatePropertyNotifier->notify(properties);
     }
 
 public Q_SLOTS:
+    void registerService()
+    {
+        if (m_registered || !m_manager->ready() || !m_vpnManager->isReady())
+        {
+            return;
+        }
+        m_registered = true;
+
+        if (!m_connection.registerService(DBusTypes::DBUS_NAME))
+        {
+            // we are called from the event loop, which an exception
+            // cannot pass through, so quit instead
+            qCritical() << "Unable to register Connectivity service on DBus";
+            QCoreApplication::exit(1);
+        }
+    }
+
     void flightModeUpdated()
     {
         notifyProperties({
-            "FlightMode",
-            "HotspotSwitchEnabled"
+            FlightMode,
+            HotspotSwitchEnabled
         });
     }
 
     void wifiEnabledUpdated()
     {
         notifyProperties({
-            "WifiEnabled",
-            "HotspotSwitchEnabled"
+            WifiEnabled,
+            HotspotSwitchEnabled
         });
     }
 
     void unstoppableOperationHappeningUpdated()
     {
         notifyProperties({
-            "FlightModeSwitchEnabled",
-            "WifiSwitchEnabled",
-            "HotspotSwitchEnabled"
+            FlightModeSwitchEnabled,
+            WifiSwitchEnabled,
+            HotspotSwitchEnabled
         });
         flushProperties();
     }
@@ -123,21 +165,21 @@ public Q_SLOTS:
     void hotspotSsidUpdated()
     {
         notifyProperties({
-            "HotspotSsid"
+            HotspotSsid
         });
     }
 
     void modemAvailableUpdated()
     {
         notifyProperties({
-            "ModemAvailable"
+            ModemAvailable
         });
     }
 
     void hotspotEnabledUpdated()
     {
         notifyProperties({
-            "HotspotEnabled"
+            HotspotEnabled
         });
     }
 
@@ -145,14 +187,14 @@ public Q_SLOTS:
     {
         // Note that this is on the private object
         notifyPrivateProperties({
-            "HotspotPassword"
+            HotspotPassword
         });
     }
 
     void hotspotModeUpdated()
     {
         notifyProperties({
-            "HotspotMode"
+            HotspotMode
         });
     }
 
@@ -160,14 +202,14 @@ public Q_SLOTS:
     {
         // Note that this is on the private object
         notifyPrivateProperties({
-            "HotspotAuth"
+            HotspotAuth
         });
     }
 
     void hotspotStoredUpdated()
     {
         notifyProperties({
-            "HotspotStored"
+            HotspotStored
         });
     }
 
@@ -175,14 +217,14 @@ public Q_SLOTS:
     {
         Q_UNUSED(value)
         notifyPrivateProperties({
-            "MobileDataEnabled"
+            MobileDataEnabled
         });
     }
 
     void simForMobileDataUpdated()
     {
         notifyPrivateProperties({
-            "SimForMobileData"
+            SimForMobileData
         });
     }
 
@@ -215,7 +257,7 @@ public Q_SLOTS:
         if (!toRemove.isEmpty() || !toAdd.isEmpty())
         {
             notifyPrivateProperties({
-                "Sims"
+                Sims
             });
             flushProperties();
         }
@@ -253,7 +295,7 @@ public Q_SLOTS:
         if (!toRemove.isEmpty() || !toAdd.isEmpty())
         {
             notifyPrivateProperties({
-                "Modems"
+                Modems
             });
             flushProperties();
         }
@@ -288,8 +330,6 @@ public Q_SLOTS:
 
     void updateNetworkingStatus()
     {
-        QStringList changed;
-
         QStringList old_limitations = m_limitations;
         QString old_status = m_status;
 
@@ -306,7 +346,7 @@ public Q_SLOTS:
         }
         if (old_status != m_status)
         {
-            changed << "Status";
+            m_propertyNotifier->notify(Status);
         }
 
         QStringList limitations;
@@ -320,12 +360,7 @@ public Q_SLOTS:
         m_limitations = limitations;
         if (old_limitations != m_limitations)
         {
-            changed << "Limitations";
-        }
-
-        if (!changed.empty())
-        {
-            notifyProperties(changed);
+            m_propertyNotifier->notify(Limitations);
         }
     }
 
@@ -374,7 +409,7 @@ public Q_SLOTS:
 
         if (!toRemove.isEmpty() || !toAdd.isEmpty())
         {
-            notifyPrivateProperties({"VpnConnections"});
+            notifyPrivateProperties({VpnConnections});
             flushProperties();
         }
 
@@ -395,6 +430,36 @@ ConnectivityService::ConnectivityService(Manager::Ptr manager,
     d->m_vpnManager = vpnManager;
     d->m_privateService = make_shared<PrivateService>(*this);
 
+    d->m_propertyNotifier = make_unique<DBusUtils::PropertyNotifier>(
+            d->m_connection, *this,
+            DBusTypes::SERVICE_PATH, DBusTypes::SERVICE_INTERFACE,
+            DBusUtils::PropertyNotifier::Properties{
+                {Private::FlightMode, "FlightMode"},
+                {Private::FlightModeSwitchEnabled, "FlightModeSwitchEnabled"},
+                {Private::WifiEnabled, "WifiEnabled"},
+                {Private::WifiSwitchEnabled, "WifiSwitchEnabled"},
+                {Private::HotspotSwitchEnabled, "HotspotSwitchEnabled"},
+                {Private::HotspotSsid, "HotspotSsid"},
+                {Private::HotspotEnabled, "HotspotEnabled"},
+                {Private::HotspotMode, "HotspotMode"},
+                {Private::HotspotStored, "HotspotStored"},
+                {Private::ModemAvailable, "ModemAvailable"},
+                {Private::Status, "Status"},
+                {Private::Limitations, "Limitations"}
+            });
+    d->m_privatePropertyNotifier = make_unique<DBusUtils::PropertyNotifier>(
+            d->m_connection, *d->m_privateService,
+            DBusTypes::PRIVATE_PATH, DBusTypes::PRIVATE_INTERFACE,
+            DBusUtils::PropertyNotifier::Properties{
+                {Private::HotspotPassword, "HotspotPassword"},
+                {Private::HotspotAuth, "HotspotAuth"},
+                {Private::MobileDataEnabled, "MobileDataEnabled"},
+                {Private::SimForMobileData, "SimForMobileData"},
+                {Private::Sims, "Sims"},
+                {Private::Modems, "Modems"},
+                {Private::VpnConnections, "VpnConnections"}
+            });
+
     // Memory is managed by Qt parent ownership
     new NetworkingStatusAdaptor(this);
 
@@ -437,10 +502,22 @@ ConnectivityService::ConnectivityService(Manager::Ptr manager,
         throw logic_error(
                 "Unable to register NetworkingStatus private object on DBus");
     }
-    if (!d->m_connection.registerService(DBusTypes::DBUS_NAME))
+
+    // The objects are there right away, but the name is only claimed once
+    // the initial state is known, so clients don't see the defaults.
+    if (!d->m_manager->ready() || !d->m_vpnManager->isReady())
+    {
+        connect(d->m_manager.get(), &Manager::readyChanged, d.get(), &Private::registerService);
+        connect(d->m_vpnManager.get(), &vpn::VpnManager::ready, d.get(), &Private::registerService);
+    }
+    else
     {
-        throw logic_error(
-                "Unable to register Connectivity service on DBus");
+        d->m_registered = true;
+        if (!d->m_connection.registerService(DBusTypes::DBUS_NAME))
+        {
+            throw logic_error(
+                    "Unable to register Connectivity service on DBus");
+        }
     }
 }
 
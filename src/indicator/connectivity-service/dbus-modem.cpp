@@ -37,6 +37,11 @@ DBusModem::DBusModem(Modem::Ptr modem,
 
     new ModemAdaptor(this);
 
+    m_propertyNotifier = make_unique<DBusUtils::PropertyNotifier>(
+            m_connection, *this, m_path.path(),
+            DBusUtils::interfaceName(ModemAdaptor::staticMetaObject),
+            DBusUtils::PropertyNotifier::Properties{{Sim, "Sim"}});
+
     registerDBusObject();
 }
 
@@ -52,17 +57,6 @@ void DBusModem::registerDBusObject()
     }
 }
 
-void DBusModem::notifyProperties(const QStringList& propertyNames)
-{
-    DBusUtils::notifyPropertyChanged(
-        m_connection,
-        *this,
-        m_path.path(),
-        ModemAdaptor::staticMetaObject.classInfo(ModemAdaptor::staticMetaObject.indexOfClassInfo("D-Bus Interface")).value(),
-        propertyNames
-    );
-}
-
 QDBusObjectPath DBusModem::sim() const
 {
     return m_simpath;
@@ -75,7 +69,7 @@ void DBusModem::setSim(QDBusObjectPath path)
         return;
     }
     m_simpath = path;
-    notifyProperties({"Sim"});
+    m_propertyNotifier->notify(Property::Sim);
 }
 
 int DBusModem::index() const
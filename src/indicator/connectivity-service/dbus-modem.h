@@ -20,6 +20,7 @@
 #pragma once
 
 #include <nmofono/wwan/modem.h>
+#include <util/dbus-utils.h>
 
 #include <QDBusConnection>
 #include <QDBusContext>
@@ -66,7 +67,13 @@ Q_SIGNALS:
 protected Q_SLOTS:
 
 private:
-    void notifyProperties(const QStringList& propertyNames);
+    // indices for m_propertyNotifier
+    enum Property
+    {
+        Sim
+    };
+
+    std::unique_ptr<DBusUtils::PropertyNotifier> m_propertyNotifier;
 
 protected:
     void registerDBusObject();
@@ -70,6 +70,11 @@ DBusOpenvpnConnection::DBusOpenvpnConnection(VpnConnection::SPtr vpnConnection,
 {
     new OpenVpnAdaptor(this);
 
+    m_propertyNotifier = make_unique<DBusUtils::PropertyNotifier>(
+            m_connection, *this, m_path.path(),
+            DBusUtils::interfaceName(OpenVpnAdaptor::staticMetaObject),
+            staticMetaObject);
+
     // Basic properties
     DEFINE_PROPERTY_CONNECTION_FORWARD(Ca)
     DEFINE_PROPERTY_CONNECTION_FORWARD(Cert)
@@ -270,13 +275,7 @@ DEFINE_PROPERTY_GETTER(proxyPassword, QString)
 
 void DBusOpenvpnConnection::notifyProperty(const QString& propertyName)
 {
-    DBusUtils::notifyPropertyChanged(
-        m_connection,
-        *this,
-        m_path.path(),
-        OpenVpnAdaptor::staticMetaObject.classInfo(OpenVpnAdaptor::staticMetaObject.indexOfClassInfo("D-Bus Interface")).value(),
-        {propertyName}
-    );
+    m_propertyNotifier->notify(propertyName);
 }
 
 // Basic properties
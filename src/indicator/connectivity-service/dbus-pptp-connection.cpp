@@ -70,6 +70,11 @@ DBusPptpConnection::DBusPptpConnection(VpnConnection::SPtr vpnConnection,
 {
     new PptpAdaptor(this);
 
+    m_propertyNotifier = make_unique<DBusUtils::PropertyNotifier>(
+            m_connection, *this, m_path.path(),
+            DBusUtils::interfaceName(PptpAdaptor::staticMetaObject),
+            staticMetaObject);
+
     // Basic properties
 
     DEFINE_PROPERTY_CONNECTION_FORWARD(Gateway)
@@ -163,13 +168,7 @@ DEFINE_PROPERTY_GETTER(sendPppEchoPackets, bool)
 
 void DBusPptpConnection::notifyProperty(const QString& propertyName)
 {
-    DBusUtils::notifyPropertyChanged(
-        m_connection,
-        *this,
-        m_path.path(),
-        PptpAdaptor::staticMetaObject.classInfo(PptpAdaptor::staticMetaObject.indexOfClassInfo("D-Bus Interface")).value(),
-        {propertyName}
-    );
+    m_propertyNotifier->notify(propertyName);
 }
 
 // Basic properties
@@ -95,6 +95,8 @@ public:
 protected:
     void notifyProperty(const QString& propertyName);
 
+    std::unique_ptr<DBusUtils::PropertyNotifier> m_propertyNotifier;
+
 protected Q_SLOTS:
     // Enum properties
     void setMppeType(int value);
@@ -39,6 +39,20 @@ DBusSim::DBusSim(Sim::Ptr sim,
 
     new SimAdaptor(this);
 
+    m_propertyNotifier = make_unique<DBusUtils::PropertyNotifier>(
+            m_connection, *this, m_path.path(),
+            DBusUtils::interfaceName(SimAdaptor::staticMetaObject),
+            DBusUtils::PropertyNotifier::Properties{
+                {Locked, "Locked"},
+                {Present, "Present"},
+                {DataRoamingEnabled, "DataRoamingEnabled"},
+                {Imsi, "Imsi"},
+                {PrimaryPhoneNumber, "PrimaryPhoneNumber"},
+                {Mcc, "Mcc"},
+                {Mnc, "Mnc"},
+                {PreferredLanguages, "PreferredLanguages"}
+            });
+
     registerDBusObject();
 
     connect(sim.get(), &Sim::lockedChanged, this, &DBusSim::lockedChanged);
@@ -68,17 +82,6 @@ void DBusSim::registerDBusObject()
     }
 }
 
-void DBusSim::notifyProperties(const QStringList& propertyNames)
-{
-    DBusUtils::notifyPropertyChanged(
-        m_connection,
-        *this,
-        m_path.path(),
-        SimAdaptor::staticMetaObject.classInfo(SimAdaptor::staticMetaObject.indexOfClassInfo("D-Bus Interface")).value(),
-        propertyNames
-    );
-}
-
 QString DBusSim::iccid() const
 {
     return m_sim->iccid();
@@ -136,42 +139,42 @@ void DBusSim::Unlock()
 
 void DBusSim::lockedChanged()
 {
-    notifyProperties({"Locked"});
+    m_propertyNotifier->notify(Property::Locked);
 }
 
 void DBusSim::presentChanged()
 {
-    notifyProperties({"Present"});
+    m_propertyNotifier->notify(Property::Present);
 }
 
 void DBusSim::dataRoamingEnabledChanged()
 {
-    notifyProperties({"DataRoamingEnabled"});
+    m_propertyNotifier->notify(Property::DataRoamingEnabled);
 }
 
 void DBusSim::imsiChanged()
 {
-    notifyProperties({"Imsi"});
+    m_propertyNotifier->notify(Property::Imsi);
 }
 
 void DBusSim::primaryPhoneNumberChanged()
 {
-    notifyProperties({"PrimaryPhoneNumber"});
+    m_propertyNotifier->notify(Property::PrimaryPhoneNumber);
 }
 
 void DBusSim::mccChanged()
 {
-    notifyProperties({"Mcc"});
+    m_propertyNotifier->notify(Property::Mcc);
 }
 
 void DBusSim::mncChanged()
 {
-    notifyProperties({"Mnc"});
+    m_propertyNotifier->notify(Property::Mnc);
 }
 
 void DBusSim::preferredLanguagesChanged()
 {
-    notifyProperties({"PreferredLanguages"});
+    m_propertyNotifier->notify(Property::PreferredLanguages);
 }
 
 nmofono::wwan::Sim::Ptr DBusSim::sim() const
@@ -20,6 +20,7 @@
 #pragma once
 
 #include <nmofono/wwan/sim.h>
+#include <util/dbus-utils.h>
 
 #include <QDBusConnection>
 #include <QDBusContext>
@@ -96,7 +97,20 @@ protected Q_SLOTS:
     void preferredLanguagesChanged();
 
 private:
-    void notifyProperties(const QStringList& propertyNames);
+    // indices for m_propertyNotifier
+    enum Property
+    {
+        Locked,
+        Present,
+        DataRoamingEnabled,
+        Imsi,
+        PrimaryPhoneNumber,
+        Mcc,
+        Mnc,
+        PreferredLanguages
+    };
+
+    std::unique_ptr<DBusUtils::PropertyNotifier> m_propertyNotifier;
 
 protected:
     void registerDBusObject();
@@ -36,10 +36,21 @@ DBusVpnConnection::DBusVpnConnection(VpnConnection::SPtr vpnConnection,
 
     new VpnConnectionAdaptor(this);
 
+    m_propertyNotifier = make_unique<DBusUtils::PropertyNotifier>(
+            m_connection, *this, m_path.path(),
+            DBusUtils::interfaceName(VpnConnectionAdaptor::staticMetaObject),
+            DBusUtils::PropertyNotifier::Properties{
+                {Id, "id"},
+                {NeverDefault, "neverDefault"},
+                {Active, "active"},
+                {Activatable, "activatable"}
+            });
+
     connect(m_vpnConnection.get(), &VpnConnection::idChanged, this, &DBusVpnConnection::idUpdated);
     connect(m_vpnConnection.get(), &VpnConnection::neverDefaultChanged, this, &DBusVpnConnection::neverDefaultUpdated);
     connect(m_vpnConnection.get(), &VpnConnection::activeChanged, this, &DBusVpnConnection::activeUpdated);
     connect(m_vpnConnection.get(), &VpnConnection::activatableChanged, this, &DBusVpnConnection::activatableUpdated);
+    connect(m_vpnConnection.get(), &VpnConnection::settingsWritten, this, &DBusVpnConnection::SettingsWritten);
 
     connect(this, &DBusVpnConnection::setActive, m_vpnConnection.get(), &VpnConnection::setActive);
     connect(this, &DBusVpnConnection::setId, m_vpnConnection.get(), &VpnConnection::setId);
@@ -61,37 +72,26 @@ void DBusVpnConnection::registerDBusObject()
 
 void DBusVpnConnection::idUpdated(const QString&)
 {
-    notifyProperties({"id"});
+    m_propertyNotifier->notify(Property::Id);
 }
 
 void DBusVpnConnection::neverDefaultUpdated(bool)
 {
-    notifyProperties({"neverDefault"});
+    m_propertyNotifier->notify(Property::NeverDefault);
 }
 
 void DBusVpnConnection::activeUpdated(bool)
 {
-    notifyProperties({"active"});
+    m_propertyNotifier->notify(Property::Active);
     DBusUtils::flushPropertyChanges();
 }
 
 void DBusVpnConnection::activatableUpdated(bool)
 {
-    notifyProperties({"activatable"});
+    m_propertyNotifier->notify(Property::Activatable);
     DBusUtils::flushPropertyChanges();
 }
 
-void DBusVpnConnection::notifyProperties(const QStringList& propertyNames)
-{
-    DBusUtils::notifyPropertyChanged(
-        m_connection,
-        *this,
-        m_path.path(),
-        VpnConnectionAdaptor::staticMetaObject.classInfo(VpnConnectionAdaptor::staticMetaObject.indexOfClassInfo("D-Bus Interface")).value(),
-        propertyNames
-    );
-}
-
 QString DBusVpnConnection::id() const
 {
     return m_vpnConnection->id();
@@ -20,6 +20,7 @@
 #pragma once
 
 #include <nmofono/vpn/vpn-connection.h>
+#include <util/dbus-utils.h>
 
 #include <QDBusConnection>
 #include <QDBusContext>
@@ -74,6 +75,8 @@ Q_SIGNALS:
 
     void UpdateSecrets();
 
+    void SettingsWritten(bool success);
+
 protected Q_SLOTS:
     void activeUpdated(bool active);
 
@@ -84,7 +87,16 @@ protected Q_SLOTS:
     void neverDefaultUpdated(bool neverDefault);
 
 private:
-    void notifyProperties(const QStringList& propertyNames);
+    // indices for m_propertyNotifier
+    enum Property
+    {
+        Id,
+        NeverDefault,
+        Active,
+        Activatable
+    };
+
+    std::unique_ptr<DBusUtils::PropertyNotifier> m_propertyNotifier;
 
 protected:
     void registerDBusObject();
@@ -24,6 +24,8 @@
 #include <nmofono/manager-impl.h>
 #include <notify-cpp/notification-manager.h>
 
+#include <NetworkManager.h>
+
 using namespace std;
 
 struct Factory::Private
@@ -42,6 +44,8 @@ struct Factory::Private
 
     nmofono::HotspotManager::SPtr m_hotspotManager;
 
+    nmofono::ObjectCache::Ptr m_nmObjectCache;
+
     notify::NotificationManager::SPtr singletonNotificationManager()
     {
         if (!m_notificationManager)
@@ -71,6 +75,16 @@ struct Factory::Private
         return m_hotspotManager;
     }
 
+    nmofono::ObjectCache::Ptr singletonNmObjectCache()
+    {
+        if (!m_nmObjectCache)
+        {
+            m_nmObjectCache = make_shared<nmofono::ObjectCache>(
+                    QDBusConnection::systemBus(), NM_DBUS_SERVICE, "/org/freedesktop");
+        }
+        return m_nmObjectCache;
+    }
+
     SessionBus::Ptr singletonSessionBus()
     {
         if (!m_sessionBus)
@@ -88,6 +102,7 @@ struct Factory::Private
                     singletonNotificationManager(),
                     singletonKillSwitch(),
                     singletonHotspotManager(),
+                    singletonNmObjectCache(),
                     QDBusConnection::systemBus());
         }
         return m_nmofono;
@@ -140,9 +155,14 @@ unique_ptr<RootState> Factory::newRootState()
     return make_unique<RootState>(d->singletonNmofono());
 }
 
-unique_ptr<IndicatorMenu> Factory::newIndicatorMenu(RootState::Ptr rootState, const QString &prefix)
+unique_ptr<IndicatorMenu> Factory::newIndicatorMenu(RootState::Ptr rootState, const QString &prefix, Section::Ptr sections)
+{
+    return make_unique<IndicatorMenu>(rootState, prefix, sections);
+}
+
+unique_ptr<SectionTree> Factory::newSectionTree()
 {
-    return make_unique<IndicatorMenu>(rootState, prefix);
+    return make_unique<SectionTree>();
 }
 
 unique_ptr<MenuExporter> Factory::newMenuExporter(const string &path, MenuModel::Ptr menuModel)
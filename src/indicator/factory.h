@@ -21,6 +21,7 @@
 
 #include <menu-builder.h>
 #include <indicator-menu.h>
+#include <section-tree.h>
 #include <root-state.h>
 #include <vpn-status-notifier.h>
 #include <connectivity-service/connectivity-service.h>
@@ -50,7 +51,9 @@ public:
 
     virtual std::unique_ptr<RootState> newRootState();
 
-    virtual std::unique_ptr<IndicatorMenu> newIndicatorMenu(RootState::Ptr rootState, const QString &prefix);
+    virtual std::unique_ptr<IndicatorMenu> newIndicatorMenu(RootState::Ptr rootState, const QString &prefix, Section::Ptr sections);
+
+    virtual std::unique_ptr<SectionTree> newSectionTree();
 
     virtual std::unique_ptr<MenuExporter> newMenuExporter(const std::string &path, MenuModel::Ptr menuModel);
 
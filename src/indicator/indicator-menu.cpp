@@ -19,9 +19,6 @@
 
 #include <indicator-menu.h>
 
-#include <menumodel-cpp/menu-merger.h>
-#include <menumodel-cpp/action-group-merger.h>
-
 using namespace std;
 
 struct IndicatorMenu::Private: public QObject
@@ -38,12 +35,10 @@ public:
     MenuItem::Ptr m_rootItem;
 
     Menu::Ptr m_rootMenu;
-    MenuMerger::Ptr m_subMenuMerger;
 
-    ActionGroupMerger::Ptr m_actionGroupMerger;
     ActionGroup::Ptr m_actionGroup;
 
-    vector<Section::Ptr> m_sections;
+    Section::Ptr m_sections;
 
 public Q_SLOTS:
     void setState(const Variant &state)
@@ -52,16 +47,14 @@ public Q_SLOTS:
     }
 };
 
-IndicatorMenu::IndicatorMenu(RootState::Ptr rootState, const QString &prefix)
+IndicatorMenu::IndicatorMenu(RootState::Ptr rootState, const QString &prefix, Section::Ptr sections)
     : d(new Private)
 {
     d->m_rootState = rootState;
     d->m_prefix = prefix;
-    d->m_actionGroupMerger = make_shared<ActionGroupMerger>();
+    d->m_sections = sections;
     d->m_actionGroup = make_shared<ActionGroup>();
 
-    d->m_actionGroupMerger->add(d->m_actionGroup);
-
     d->m_rootAction = make_shared<Action>(prefix + ".network-status",
                                             nullptr,
                                             rootState->state());
@@ -69,23 +62,14 @@ IndicatorMenu::IndicatorMenu(RootState::Ptr rootState, const QString &prefix)
     d->m_actionGroup->add(d->m_rootAction);
 
     d->m_rootMenu = make_shared<Menu>();
-    d->m_subMenuMerger = make_shared<MenuMerger>();
 
-    d->m_rootItem = MenuItem::newSubmenu(d->m_subMenuMerger);
+    d->m_rootItem = MenuItem::newSubmenu(d->m_sections->menuModel());
 
     d->m_rootItem->setAction("indicator." + prefix + ".network-status");
     d->m_rootItem->setAttribute("x-canonical-type", TypedVariant<string>("com.canonical.indicator.root"));
     d->m_rootMenu->append(d->m_rootItem);
 }
 
-void
-IndicatorMenu::addSection(Section::Ptr section)
-{
-    d->m_sections.push_back(section);
-    d->m_actionGroupMerger->add(section->actionGroup());
-    d->m_subMenuMerger->append(section->menuModel());
-}
-
 Menu::Ptr
 IndicatorMenu::menu() const
 {
@@ -95,7 +79,7 @@ IndicatorMenu::menu() const
 ActionGroup::Ptr
 IndicatorMenu::actionGroup() const
 {
-    return d->m_actionGroupMerger->actionGroup();
+    return d->m_actionGroup;
 }
 
 #include "indicator-menu.moc"
@@ -35,12 +35,15 @@ public:
 
     virtual ~IndicatorMenu() = default;
 
-    IndicatorMenu(RootState::Ptr rootState, const QString &prefix);
-
-    virtual void addSection(Section::Ptr section);
+    /**
+     * @param sections the contents of the menu, shared with the other
+     *        profiles that show the same sections.
+     */
+    IndicatorMenu(RootState::Ptr rootState, const QString &prefix, Section::Ptr sections);
 
     Menu::Ptr menu() const;
 
+    /// only the root action, the actions of the sections are not included
     ActionGroup::Ptr actionGroup() const;
 
 private:
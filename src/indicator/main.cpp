@@ -19,6 +19,7 @@
 
 #include <factory.h>
 #include <util/logging.h>
+#include <util/startup-timer.h>
 #include <util/unix-signal-handler.h>
 #include <dbus-types.h>
 
@@ -39,6 +40,16 @@ using namespace connectivity_service;
 int
 main(int argc, char **argv)
 {
+    bool measureStartup = (argc == 2 && QString("--measure-startup") == argv[1]);
+    if (measureStartup)
+    {
+        // print the timeline and quit once the name is claimed and the
+        // initial discovery is done
+        util::startup::start([]{
+            QMetaObject::invokeMethod(QCoreApplication::instance(), "quit", Qt::QueuedConnection);
+        });
+    }
+
     qInstallMessageHandler(util::loggingFunction);
 
     QCoreApplication app(argc, argv);
@@ -19,6 +19,7 @@
 
 #include <menu-builder.h>
 #include <factory.h>
+#include <util/startup-timer.h>
 
 using namespace std;
 
@@ -29,6 +30,10 @@ struct MenuBuilder::Priv: public QObject
 public:
     nmofono::Manager::Ptr m_manager;
 
+    // built once and shared by the profiles
+    SectionTree::Ptr m_sections;
+    SectionTree::Ptr m_noSections;
+
     IndicatorMenu::Ptr m_desktopMenu;
     IndicatorMenu::Ptr m_desktopGreeterMenu;
 
@@ -120,16 +125,19 @@ MenuBuilder::MenuBuilder(nmofono::Manager::Ptr manager, Factory& factory) :
 
     d->m_rootState = factory.newRootState();
 
-    d->m_desktopMenu = factory.newIndicatorMenu(d->m_rootState, "desktop");
-    d->m_desktopGreeterMenu = factory.newIndicatorMenu(d->m_rootState, "desktop.greeter");
+    d->m_sections = factory.newSectionTree();
+    d->m_noSections = factory.newSectionTree();
+
+    d->m_desktopMenu = factory.newIndicatorMenu(d->m_rootState, "desktop", d->m_sections);
+    d->m_desktopGreeterMenu = factory.newIndicatorMenu(d->m_rootState, "desktop.greeter", d->m_sections);
 
-    d->m_tabletMenu = factory.newIndicatorMenu(d->m_rootState, "tablet");
-    d->m_tabletGreeterMenu = factory.newIndicatorMenu(d->m_rootState, "tablet.greeter");
+    d->m_tabletMenu = factory.newIndicatorMenu(d->m_rootState, "tablet", d->m_noSections);
+    d->m_tabletGreeterMenu = factory.newIndicatorMenu(d->m_rootState, "tablet.greeter", d->m_noSections);
 
-    d->m_phoneMenu = factory.newIndicatorMenu(d->m_rootState, "phone");
-    d->m_phoneGreeterMenu = factory.newIndicatorMenu(d->m_rootState, "phone.greeter");
+    d->m_phoneMenu = factory.newIndicatorMenu(d->m_rootState, "phone", d->m_sections);
+    d->m_phoneGreeterMenu = factory.newIndicatorMenu(d->m_rootState, "phone.greeter", d->m_sections);
 
-    d->m_ubiquityMenu = factory.newIndicatorMenu(d->m_rootState, "ubiquity");
+    d->m_ubiquityMenu = factory.newIndicatorMenu(d->m_rootState, "ubiquity", d->m_noSections);
 
     d->m_flightModeSwitch = factory.newFlightModeSwitch();
     d->m_mobileDataSwitch = factory.newMobileDataSwitch();
@@ -159,25 +167,10 @@ MenuBuilder::MenuBuilder(nmofono::Manager::Ptr manager, Factory& factory) :
     d->m_wifiSection = factory.newWiFiSection(d->m_wifiSwitch);
     d->m_vpnSection = factory.newVpnSection();
 
-    d->m_desktopMenu->addSection(d->m_quickAccessSection);
-    d->m_desktopGreeterMenu->addSection(d->m_quickAccessSection);
-    d->m_phoneMenu->addSection(d->m_quickAccessSection);
-    d->m_phoneGreeterMenu->addSection(d->m_quickAccessSection);
-
-    d->m_desktopMenu->addSection(d->m_wwanSection);
-    d->m_desktopGreeterMenu->addSection(d->m_wwanSection);
-    d->m_phoneMenu->addSection(d->m_wwanSection);
-    d->m_phoneGreeterMenu->addSection(d->m_wwanSection);
-
-    d->m_desktopMenu->addSection(d->m_wifiSection);
-    d->m_desktopGreeterMenu->addSection(d->m_wifiSection);
-    d->m_phoneMenu->addSection(d->m_wifiSection);
-    d->m_phoneGreeterMenu->addSection(d->m_wifiSection);
-
-    d->m_desktopMenu->addSection(d->m_vpnSection);
-    d->m_desktopGreeterMenu->addSection(d->m_vpnSection);
-    d->m_phoneMenu->addSection(d->m_vpnSection);
-    d->m_phoneGreeterMenu->addSection(d->m_vpnSection);
+    d->m_sections->addSection(d->m_quickAccessSection);
+    d->m_sections->addSection(d->m_wwanSection);
+    d->m_sections->addSection(d->m_wifiSection);
+    d->m_sections->addSection(d->m_vpnSection);
 
     d->m_desktopMenuExporter = factory.newMenuExporter("/com/canonical/indicator/network/desktop", d->m_desktopMenu->menu());
     d->m_desktopGreeterMenuExporter = factory.newMenuExporter("/com/canonical/indicator/network/desktop_greeter", d->m_desktopGreeterMenu->menu());
@@ -202,20 +195,39 @@ MenuBuilder::MenuBuilder(nmofono::Manager::Ptr manager, Factory& factory) :
     d->m_actionGroupMerger->add(d->m_desktopGreeterMenu->actionGroup());
     d->m_actionGroupMerger->add(d->m_phoneMenu->actionGroup());
     d->m_actionGroupMerger->add(d->m_phoneGreeterMenu->actionGroup());
+    d->m_actionGroupMerger->add(d->m_sections->actionGroup());
     d->m_actionGroupExporter = factory.newActionGroupExporter(d->m_actionGroupMerger->actionGroup(),
                                                         "/com/canonical/indicator/network");
 
-    d->m_busName = factory.newBusName("com.canonical.indicator.network",
-                                [](std::string) {
+    // Claim the name once the initial state is known, so that the shell
+    // doesn't show the defaults first.
+    auto ownBusName = [this, &factory]()
+    {
+        if (d->m_busName)
+        {
+            return;
+        }
+        d->m_busName = factory.newBusName("com.canonical.indicator.network",
+                                    [](std::string) {
 #ifdef INDICATOR_NETWORK_TRACE_MESSAGES
-        std::cout << "acquired" << std::endl;
+            std::cout << "acquired" << std::endl;
 #endif
-                                },
-                                [](std::string) {
+                                        util::startup::exported();
+                                    },
+                                    [](std::string) {
 #ifdef INDICATOR_NETWORK_TRACE_MESSAGES
-                                    std::cout << "lost" << std::endl;
+                                        std::cout << "lost" << std::endl;
 #endif
-                                });
+                                    });
+    };
+    if (d->m_manager->ready())
+    {
+        ownBusName();
+    }
+    else
+    {
+        connect(d->m_manager.get(), &nmofono::Manager::readyChanged, d.get(), ownBusName);
+    }
 }
 
 #include "menu-builder.moc"
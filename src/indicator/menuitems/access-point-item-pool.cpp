@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <menuitems/access-point-item-pool.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+using namespace nmofono;
+
+class AccessPointItemPool::Private
+{
+public:
+    ActionGroupMerger::Ptr m_actionGroupMerger;
+
+    int m_capacity;
+
+    vector<AccessPointItem::Ptr> m_idle;
+
+    vector<ActionGroup::Ptr> m_added;
+
+    vector<ActionGroup::Ptr> m_removed;
+
+    Private(ActionGroupMerger::Ptr actionGroupMerger, int capacity)
+        : m_actionGroupMerger{actionGroupMerger},
+          m_capacity{capacity}
+    {
+    }
+
+    // moves group from one pending list to the other, or queues it there
+    // if nothing was pending for it yet
+    static void queue(ActionGroup::Ptr group,
+                      vector<ActionGroup::Ptr>& to,
+                      vector<ActionGroup::Ptr>& from)
+    {
+        auto it = find(from.begin(), from.end(), group);
+        if (it != from.end())
+        {
+            // cancels out with the change not committed yet
+            from.erase(it);
+        }
+        else
+        {
+            to.push_back(group);
+        }
+    }
+
+    void publish(ActionGroup::Ptr group)
+    {
+        queue(group, m_added, m_removed);
+    }
+
+    void unpublish(ActionGroup::Ptr group)
+    {
+        queue(group, m_removed, m_added);
+    }
+};
+
+AccessPointItemPool::AccessPointItemPool(ActionGroupMerger::Ptr actionGroupMerger, int capacity)
+    : d{new Private(actionGroupMerger, capacity)}
+{
+}
+
+AccessPointItemPool::~AccessPointItemPool()
+{
+}
+
+AccessPointItem::Ptr
+AccessPointItemPool::acquire(wifi::AccessPoint::Ptr accessPoint, bool isActive)
+{
+    if (!d->m_idle.empty())
+    {
+        auto item = d->m_idle.back();
+        d->m_idle.pop_back();
+        item->setAccessPoint(accessPoint, isActive);
+        d->publish(item->actionGroup());
+        return item;
+    }
+
+    auto item = make_shared<AccessPointItem>(accessPoint, isActive);
+    auto i = item.get();
+    connect(i, &AccessPointItem::activated, this, [this, i]()
+    {
+        auto ap = i->accessPoint();
+        if (ap)
+        {
+            Q_EMIT activated(ap);
+        }
+    });
+    d->publish(item->actionGroup());
+    return item;
+}
+
+void
+AccessPointItemPool::release(AccessPointItem::Ptr item)
+{
+    // idle items must not leave actions behind that clients could activate
+    d->unpublish(item->actionGroup());
+
+    if (int(d->m_idle.size()) < d->m_capacity)
+    {
+        item->setAccessPoint(wifi::AccessPoint::Ptr());
+        d->m_idle.push_back(item);
+    }
+}
+
+void
+AccessPointItemPool::commit()
+{
+    // the exported action group sends all of these in one change
+    for (const auto& group : d->m_removed)
+    {
+        d->m_actionGroupMerger->remove(group);
+    }
+    d->m_removed.clear();
+
+    for (const auto& group : d->m_added)
+    {
+        d->m_actionGroupMerger->add(group);
+    }
+    d->m_added.clear();
+}
+
+int
+AccessPointItemPool::idle() const
+{
+    return d->m_idle.size();
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <menuitems/access-point-item.h>
+
+#include <menumodel-cpp/action-group-merger.h>
+
+#include <memory>
+#include <QObject>
+
+/**
+ * Recycles AccessPointItems, so that access points coming in and out of
+ * range do not keep creating new actions and menu items.
+ *
+ * The action groups of the items in use are kept in the given merger, the
+ * ones of idle items are taken out and put back with the same action names
+ * when the item is reused. Changes to it are collected until commit() is
+ * called.
+ */
+class AccessPointItemPool : public QObject
+{
+    Q_OBJECT
+
+    class Private;
+    std::shared_ptr<Private> d;
+
+public:
+    typedef std::shared_ptr<AccessPointItemPool> Ptr;
+
+    AccessPointItemPool(ActionGroupMerger::Ptr actionGroupMerger, int capacity = 16);
+
+    ~AccessPointItemPool();
+
+    /// an item showing accessPoint, recycled if there is an idle one
+    AccessPointItem::Ptr acquire(nmofono::wifi::AccessPoint::Ptr accessPoint, bool isActive = false);
+
+    /// keeps the item for reuse, or drops it if there are enough idle items
+    void release(AccessPointItem::Ptr item);
+
+    /// adds and removes the action groups of acquired and released items
+    void commit();
+
+    /// number of idle items
+    int idle() const;
+
+Q_SIGNALS:
+    void activated(nmofono::wifi::AccessPoint::Ptr accessPoint);
+};
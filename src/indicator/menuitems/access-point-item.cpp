@@ -42,9 +42,10 @@ public:
     Action::Ptr m_actionStrength;
     MenuItem::Ptr m_item;
 
+    QMetaObject::Connection m_strengthConnection;
+
     Private(AccessPointItem& parent, wifi::AccessPoint::Ptr accessPoint, bool isActive = false)
         : q{parent},
-          m_accessPoint{accessPoint},
           m_isActive{isActive}
     {
         static int id = 0;
@@ -53,28 +54,22 @@ public:
         QString actionId = "accesspoint." + QString::number(id);
         QString strengthActionId = actionId + "::strength";
 
-        m_item = make_shared<MenuItem>(m_accessPoint->ssid(),
-                                            "indicator." + actionId);
-
-
+        m_item = make_shared<MenuItem>(QString(), "indicator." + actionId);
 
         m_item->setAttribute("x-canonical-type", TypedVariant<std::string>("unity.widgets.systemsettings.tablet.accesspoint"));
-        m_item->setAttribute("x-canonical-wifi-ap-is-adhoc", TypedVariant<bool>(m_accessPoint->adhoc()));
-        m_item->setAttribute("x-canonical-wifi-ap-is-secure", TypedVariant<bool>(m_accessPoint->secured()));
-        m_item->setAttribute("x-canonical-wifi-ap-is-enterprise", TypedVariant<bool>(m_accessPoint->enterprise()));
         m_item->setAttribute("x-canonical-wifi-ap-strength-action", TypedVariant<std::string>(("indicator." + strengthActionId).toStdString()));
 
         m_actionStrength = std::make_shared<Action>(strengthActionId,
                                                     nullptr,
-                                                    TypedVariant<std::uint8_t>(m_accessPoint->strength()));
-
-        connect(m_accessPoint.get(), &wifi::AccessPoint::strengthUpdated, this, &Private::setStrength);
+                                                    TypedVariant<std::uint8_t>(0));
 
         m_actionActivate = std::make_shared<Action>(actionId,
                                                     nullptr,
                                                     TypedVariant<bool>(m_isActive));
         connect(m_actionActivate.get(), &Action::activated, &q, &AccessPointItem::activated);
 
+        setAccessPoint(accessPoint);
+
         q.actionGroup()->add(m_actionActivate);
         q.actionGroup()->add(m_actionStrength);
     }
@@ -83,6 +78,26 @@ public:
     {
     }
 
+    void setAccessPoint(wifi::AccessPoint::Ptr accessPoint)
+    {
+        disconnect(m_strengthConnection);
+        m_accessPoint = accessPoint;
+
+        if (!m_accessPoint)
+        {
+            setStrength(0);
+            return;
+        }
+
+        m_item->setLabel(m_accessPoint->ssid());
+        m_item->setAttribute("x-canonical-wifi-ap-is-adhoc", TypedVariant<bool>(m_accessPoint->adhoc()));
+        m_item->setAttribute("x-canonical-wifi-ap-is-secure", TypedVariant<bool>(m_accessPoint->secured()));
+        m_item->setAttribute("x-canonical-wifi-ap-is-enterprise", TypedVariant<bool>(m_accessPoint->enterprise()));
+
+        setStrength(m_accessPoint->strength());
+        m_strengthConnection = connect(m_accessPoint.get(), &wifi::AccessPoint::strengthUpdated, this, &Private::setStrength);
+    }
+
 public Q_SLOTS:
     void setStrength(double value)
     {
@@ -106,6 +121,19 @@ AccessPointItem::setActive(bool value)
     d->m_actionActivate->setState(TypedVariant<bool>(d->m_isActive));
 }
 
+void
+AccessPointItem::setAccessPoint(wifi::AccessPoint::Ptr accessPoint, bool isActive)
+{
+    d->setAccessPoint(accessPoint);
+    setActive(isActive);
+}
+
+wifi::AccessPoint::Ptr
+AccessPointItem::accessPoint() const
+{
+    return d->m_accessPoint;
+}
+
 MenuItem::Ptr
 AccessPointItem::menuItem()
 {
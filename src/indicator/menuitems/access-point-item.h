@@ -35,6 +35,14 @@ public:
     explicit AccessPointItem(nmofono::wifi::AccessPoint::Ptr accessPoint, bool isActive = false);
     virtual ~AccessPointItem();
 
+    /**
+     * Shows a different access point, keeping the menu item and the
+     * action names. A null access point just detaches the item.
+     */
+    void setAccessPoint(nmofono::wifi::AccessPoint::Ptr accessPoint, bool isActive = false);
+
+    nmofono::wifi::AccessPoint::Ptr accessPoint() const;
+
     void setActive(bool value);
 
     virtual MenuItem::Ptr menuItem();
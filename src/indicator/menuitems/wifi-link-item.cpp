@@ -21,6 +21,7 @@
 
 #include "menuitems/text-item.h"
 #include "menuitems/access-point-item.h"
+#include "menuitems/access-point-item-pool.h"
 
 #include "menumodel-cpp/action-group.h"
 #include "menumodel-cpp/action-group-merger.h"
@@ -34,6 +35,16 @@ using namespace nmofono;
 
 #include <algorithm>
 #include <locale>
+#include <vector>
+#include <QTimer>
+
+namespace
+{
+
+/// in percent of signal strength, see WifiLinkItem::Private::updateVisible()
+static const double RANK_HYSTERESIS = 10.0;
+
+}
 
 class WifiLinkItem::Private : public QObject
 {
@@ -48,7 +59,15 @@ public:
     Action::Ptr m_actionBusy;
 
     wifi::AccessPoint::Ptr m_activeAccessPoint;
+
+    /// every access point we could show
+    QSet<wifi::AccessPoint::Ptr> m_candidates;
+    /// the ones that are in the menu
     QMap<wifi::AccessPoint::Ptr, AccessPointItem::Ptr> m_accessPoints;
+    AccessPointItemPool::Ptr m_itemPool;
+
+    int m_maximumVisible;
+    QTimer m_updateVisibleTimer;
 
     Menu::Ptr m_topMenu;
 
@@ -73,11 +92,26 @@ public:
 
     Private() = delete;
     ~Private() {}
-    Private(wifi::WifiLink::Ptr link)
-        : m_link {link}
+    Private(wifi::WifiLink::Ptr link, int maximumVisible)
+        : m_link {link},
+          m_maximumVisible {maximumVisible}
     {
         m_actionGroupMerger = std::make_shared<ActionGroupMerger>();
 
+        // Re-rank at most once per event loop iteration
+        m_updateVisibleTimer.setInterval(0);
+        m_updateVisibleTimer.setSingleShot(true);
+        connect(&m_updateVisibleTimer, &QTimer::timeout, this, [this](){
+            if (updateVisible()) {
+                placeActiveAccessPoint();
+            }
+        });
+
+        m_itemPool = std::make_shared<AccessPointItemPool>(m_actionGroupMerger);
+        connect(m_itemPool.get(), &AccessPointItemPool::activated, this, [this](wifi::AccessPoint::Ptr ap){
+            m_link->connect_to(ap);
+        });
+
         m_topMenu = std::make_shared<Menu>();
 
         m_connectedBeforeApsMenu = std::make_shared<Menu>();
@@ -88,24 +122,17 @@ public:
 
         m_rootMerger = std::make_shared<MenuMerger>();
 
-        m_accessPointCompare = [](MenuItem::Ptr a, MenuItem::Ptr b){
-            // order alphabetically by SSID
-
-            QString a_label = a->label();
-            QString b_label = b->label();
-
-            QString a_upper = a_label.toUpper();
-            QString b_upper = b_label.toUpper();
-
-            return a_upper < b_upper;
-        };
+        // order alphabetically by SSID
+        m_accessPointCompare = &MenuItem::labelLessThan;
 
-        updateAccessPoints(m_link->accessPoints());
-        connect(m_link.get(), &wifi::WifiLink::accessPointsUpdated, this, &Private::updateAccessPoints);
+        updateAccessPoints(m_link->accessPoints(), QSet<wifi::AccessPoint::Ptr>());
+        connect(m_link.get(), &wifi::WifiLink::accessPointsChanged, this, &Private::updateAccessPoints);
 
         updateActiveAccessPoint(m_link->activeAccessPoint());
         connect(m_link.get(), &wifi::WifiLink::activeAccessPointUpdated, this, &Private::updateActiveAccessPoint);
 
+        connect(m_link.get(), &wifi::WifiLink::knownAccessPointsChanged, &m_updateVisibleTimer, static_cast<void(QTimer::*)()>(&QTimer::start));
+
         m_otherNetwork = std::make_shared<TextItem>(_("Other network…"), "wifi", "othernetwork");
         //m_actionGroupMerger->add(*m_otherNetwork);
 
@@ -121,57 +148,88 @@ public:
         m_item = MenuItem::newSection(m_rootMerger);
     }
 
-public Q_SLOTS:
-    void updateAccessPoints(const QSet<wifi::AccessPoint::Ptr>& accessPoints)
+    /**
+     * Works out which access points should be in the menu: the active one,
+     * the known ones, and the m_maximumVisible strongest of the rest.
+     * Only the difference to what is shown is applied.
+     *
+     * The ones already in the menu are ranked RANK_HYSTERESIS stronger than
+     * they are, so that access points of about the same strength around
+     * the cut-off do not keep swapping places.
+     *
+     * @returns true if the active access point was added to the menu.
+     */
+    bool updateVisible()
     {
-        /// @todo previously connected
-        /// @todo apply visibility policy.
-
-        auto old(m_accessPoints.keys().toSet());
+        m_updateVisibleTimer.stop();
+
+        QSet<wifi::AccessPoint::Ptr> visible;
+        std::vector<std::pair<double, wifi::AccessPoint::Ptr>> ranked;
+        ranked.reserve(m_candidates.size());
+        for (const auto& ap : m_candidates) {
+            if (ap == m_activeAccessPoint || m_link->isKnown(ap)) {
+                visible.insert(ap);
+            } else {
+                double rank = ap->strength();
+                if (m_accessPoints.contains(ap)) {
+                    rank += RANK_HYSTERESIS;
+                }
+                ranked.emplace_back(rank, ap);
+            }
+        }
 
-        auto added(accessPoints);
-        added.subtract(old);
+        if (m_maximumVisible >= 0 && ranked.size() > std::size_t(m_maximumVisible)) {
+            std::nth_element(ranked.begin(), ranked.begin() + m_maximumVisible, ranked.end(),
+                             [](const std::pair<double, wifi::AccessPoint::Ptr>& a,
+                                const std::pair<double, wifi::AccessPoint::Ptr>& b) {
+                return a.first > b.first;
+            });
+            ranked.resize(m_maximumVisible);
+        }
 
-        auto removed(old);
-        removed.subtract(accessPoints);
+        for (const auto& pair : ranked) {
+            visible.insert(pair.second);
+        }
 
+        for (auto it = m_accessPoints.begin(); it != m_accessPoints.end();) {
+            if (visible.contains(it.key())) {
+                ++it;
+                continue;
+            }
 
-        for (auto ap: removed) {
-            bool isActive = (ap == m_activeAccessPoint);
-            if (isActive)
-                m_connectedBeforeApsMenu->removeAll(m_accessPoints[ap]->menuItem());
-            else
-                m_neverConnectedApsMenu->removeAll(m_accessPoints[ap]->menuItem());
-            /// @todo disconnect activated...
-            m_actionGroupMerger->remove(m_accessPoints[ap]->actionGroup());
-            m_accessPoints.remove(ap);
+            // might still be shown as the previously active one
+            m_connectedBeforeApsMenu->removeAll((*it)->menuItem());
+            m_neverConnectedApsMenu->removeAll((*it)->menuItem());
+            m_itemPool->release(*it);
+            it = m_accessPoints.erase(it);
         }
 
-        for (auto ap : added) {
-
-            /// @todo handle hidden APs all the way
-            if (ap->ssid().isEmpty())
+        bool activeAdded = false;
+        std::vector<AccessPointItem::Ptr> addedItems;
+        for (const auto& ap : visible) {
+            if (m_accessPoints.contains(ap))
                 continue;
 
             bool isActive = (ap == m_activeAccessPoint);
-            auto item = std::make_shared<AccessPointItem>(ap, isActive);
-            connect(item.get(), &AccessPointItem::activated, [this, ap](){
-                m_link->connect_to(ap);
-            });
+            auto item = m_itemPool->acquire(ap, isActive);
             m_accessPoints[ap] = item;
-            m_actionGroupMerger->add(item->actionGroup());
             if (isActive) {
-                updateActiveAccessPoint(m_activeAccessPoint);
+                activeAdded = true;
             } else {
-                m_neverConnectedApsMenu->insert(item->menuItem(), m_accessPointCompare);
+                addedItems.push_back(item);
             }
         }
+        m_itemPool->commit();
+
+        for (const auto& item : addedItems) {
+            m_neverConnectedApsMenu->insert(item->menuItem(), m_accessPointCompare);
+        }
+
+        return activeAdded;
     }
 
-    void updateActiveAccessPoint(wifi::AccessPoint::Ptr ap)
+    void placeActiveAccessPoint()
     {
-        m_activeAccessPoint = ap;
-
         auto current = m_connectedBeforeApsMenu->begin();
         if (current != m_connectedBeforeApsMenu->end()) {
             // move to other menu
@@ -183,7 +241,7 @@ public Q_SLOTS:
         while (i.hasNext()) {
             i.next();
             auto menuItem = i.value();
-            if (ap && ap == i.key()) {
+            if (m_activeAccessPoint && m_activeAccessPoint == i.key()) {
                 m_connectedBeforeApsMenu->insert(menuItem->menuItem(), m_connectedBeforeApsMenu->begin());
                 menuItem->setActive(true);
                 m_neverConnectedApsMenu->removeAll(menuItem->menuItem());
@@ -193,11 +251,51 @@ public Q_SLOTS:
         }
     }
 
+public Q_SLOTS:
+    void updateAccessPoints(const QSet<wifi::AccessPoint::Ptr>& added,
+                            const QSet<wifi::AccessPoint::Ptr>& removed)
+    {
+        /// @todo previously connected
+
+        for (auto ap: removed) {
+            if (m_candidates.remove(ap)) {
+                ap->disconnect(this);
+            }
+        }
+
+        for (auto ap : added) {
+            if (m_candidates.contains(ap))
+                continue;
+
+            /// @todo handle hidden APs all the way
+            if (ap->ssid().isEmpty())
+                continue;
+
+            m_candidates.insert(ap);
+            // strength changes are already filtered down to visible steps
+            connect(ap.get(), &wifi::AccessPoint::strengthUpdated, this, [this](){
+                m_updateVisibleTimer.start();
+            });
+        }
+
+        if (updateVisible()) {
+            placeActiveAccessPoint();
+        }
+    }
+
+    void updateActiveAccessPoint(wifi::AccessPoint::Ptr ap)
+    {
+        m_activeAccessPoint = ap;
+
+        updateVisible();
+        placeActiveAccessPoint();
+    }
+
 };
 
 
-WifiLinkItem::WifiLinkItem(wifi::WifiLink::Ptr link)
-    : d{new Private(link)}
+WifiLinkItem::WifiLinkItem(wifi::WifiLink::Ptr link, int maximumVisible)
+    : d{new Private(link, maximumVisible)}
 {
 }
 
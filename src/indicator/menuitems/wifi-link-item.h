@@ -31,7 +31,11 @@ class WifiLinkItem : public Item
 public:
     typedef std::shared_ptr<WifiLinkItem> Ptr;
 
-    WifiLinkItem(nmofono::wifi::WifiLink::Ptr link);
+    /**
+     * @param maximumVisible how many access points to put in the menu,
+     *        not counting the active and the known ones. -1 for all of them.
+     */
+    WifiLinkItem(nmofono::wifi::WifiLink::Ptr link, int maximumVisible);
     virtual ~WifiLinkItem();
 
     virtual MenuItem::Ptr menuItem();
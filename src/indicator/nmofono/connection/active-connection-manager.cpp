@@ -17,10 +17,14 @@
  */
 
 #include <nmofono/connection/active-connection-manager.h>
+#include <nmofono/proxy-registry.h>
 #include <NetworkManagerInterface.h>
 #include <util/qhash-sharedptr.h>
+#include <util/startup-timer.h>
 
 #include <NetworkManager.h>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
 
 using namespace std;
 
@@ -39,6 +43,67 @@ public:
     {
     }
 
+    ActiveConnection::SPtr indexed(const QDBusObjectPath& connectionPath) const
+    {
+        auto it = m_index.constFind(connectionPath);
+        if (it == m_index.constEnd() || it->isEmpty())
+        {
+            return ActiveConnection::SPtr();
+        }
+        return it->last();
+    }
+
+    void addToIndex(const ActiveConnection::SPtr& activeConnection, const QDBusObjectPath& connectionPath)
+    {
+        auto before = indexed(connectionPath);
+        m_index[connectionPath].append(activeConnection);
+        m_indexedPaths[activeConnection->path()] = connectionPath;
+        if (indexed(connectionPath) != before)
+        {
+            m_changedPaths << connectionPath;
+        }
+    }
+
+    void removeFromIndex(const QDBusObjectPath& path)
+    {
+        auto pathIt = m_indexedPaths.find(path);
+        if (pathIt == m_indexedPaths.end())
+        {
+            return;
+        }
+        QDBusObjectPath connectionPath = *pathIt;
+        m_indexedPaths.erase(pathIt);
+
+        auto before = indexed(connectionPath);
+        auto& list = m_index[connectionPath];
+        for (auto it = list.begin(); it != list.end(); ++it)
+        {
+            if ((*it)->path() == path)
+            {
+                list.erase(it);
+                break;
+            }
+        }
+        if (list.isEmpty())
+        {
+            m_index.remove(connectionPath);
+        }
+        if (indexed(connectionPath) != before)
+        {
+            m_changedPaths << connectionPath;
+        }
+    }
+
+    void emitIndexChanges()
+    {
+        auto changedPaths = m_changedPaths;
+        m_changedPaths.clear();
+        for (const auto& connectionPath : changedPaths)
+        {
+            Q_EMIT p.activeConnectionChanged(connectionPath);
+        }
+    }
+
     void updateConnections(const QList<QDBusObjectPath>& connectionsList)
     {
         auto current(m_connections.keys().toSet());
@@ -47,27 +112,117 @@ public:
         auto toRemove(current);
         toRemove.subtract(connections);
 
-        auto toAdd(connections);
-        toAdd.subtract(current);
+        for (const auto& path: m_loading.keys())
+        {
+            if (!connections.contains(path))
+            {
+                // the reply is ignored when it comes in
+                m_loading.remove(path);
+            }
+        }
 
         for (const auto& path: toRemove)
         {
+            removeFromIndex(path);
             m_connections.remove(path);
         }
 
-        for (const auto& path: toAdd)
+        for (const auto& path: connections)
         {
-            m_connections[path] = make_shared<ActiveConnection>(path, m_manager->connection());
+            if (!current.contains(path) && !m_loading.contains(path))
+            {
+                load(path);
+            }
         }
 
-        if (!toRemove.isEmpty() || !toAdd.isEmpty())
+        emitIndexChanges();
+
+        if (!toRemove.isEmpty())
         {
             Q_EMIT p.connectionsChanged(m_connections.values().toSet());
             Q_EMIT p.connectionsUpdated();
         }
+
+        checkReady();
+    }
+
+    /**
+     * Fetches all the properties of a new active connection in one call,
+     * it is only added once they are in.
+     */
+    void load(const QDBusObjectPath& path)
+    {
+        auto message = QDBusMessage::createMethodCall(NM_DBUS_SERVICE,
+                                                      path.path(),
+                                                      "org.freedesktop.DBus.Properties",
+                                                      "GetAll");
+        message << QString(NM_DBUS_INTERFACE_ACTIVE_CONNECTION);
+
+        auto watcher(new QDBusPendingCallWatcher(m_manager->connection().asyncCall(message), this));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, path](QDBusPendingCallWatcher *call) {
+            loaded(path, call);
+        });
+        m_loading.insert(path, watcher);
+    }
+
+    void loaded(const QDBusObjectPath& path, QDBusPendingCallWatcher *call)
+    {
+        call->deleteLater();
+
+        // gone while we were waiting for the properties
+        if (m_loading.value(path) != call)
+        {
+            return;
+        }
+        m_loading.remove(path);
+
+        QDBusPendingReply<QVariantMap> reply = *call;
+        if (reply.isError())
+        {
+            qWarning() << "Failed to get properties of active connection" << path.path() << ":" << reply.error().message();
+        }
+        else
+        {
+            auto activeConnection = make_shared<ActiveConnection>(path, reply.value(), m_manager->connection());
+            m_connections[path] = activeConnection;
+            addToIndex(activeConnection, activeConnection->connectionPath());
+            connect(activeConnection.get(), &ActiveConnection::connectionPathChanged, this, &Priv::connectionPathChanged);
+
+            emitIndexChanges();
+
+            Q_EMIT p.connectionsChanged(m_connections.values().toSet());
+            Q_EMIT p.connectionsUpdated();
+        }
+
+        checkReady();
+    }
+
+    void checkReady()
+    {
+        if (m_ready || !m_listed || !m_loading.isEmpty())
+        {
+            return;
+        }
+
+        m_ready = true;
+        util::startup::end("nm-active-connections");
+        Q_EMIT p.ready();
     }
 
 public Q_SLOTS:
+    void connectionPathChanged(const QDBusObjectPath& connectionPath)
+    {
+        auto activeConnection = m_connections.value(qobject_cast<ActiveConnection*>(sender())->path());
+        if (!activeConnection)
+        {
+            return;
+        }
+
+        removeFromIndex(activeConnection->path());
+        addToIndex(activeConnection, connectionPath);
+        emitIndexChanges();
+    }
+
     void propertiesChanged(const QVariantMap &properties)
     {
         QMapIterator<QString, QVariant> it(properties);
@@ -92,16 +247,56 @@ public:
     shared_ptr<OrgFreedesktopNetworkManagerInterface> m_manager;
 
     QMap<QDBusObjectPath, ActiveConnection::SPtr> m_connections;
+
+    // settings connection path -> active connections, oldest first
+    QHash<QDBusObjectPath, QList<ActiveConnection::SPtr>> m_index;
+
+    // active connection path -> the settings connection path it is indexed under
+    QHash<QDBusObjectPath, QDBusObjectPath> m_indexedPaths;
+
+    QSet<QDBusObjectPath> m_changedPaths;
+
+    // active connections whose properties are still being fetched
+    QHash<QDBusObjectPath, QDBusPendingCallWatcher*> m_loading;
+
+    bool m_listed = false;
+
+    bool m_ready = false;
 };
 
 ActiveConnectionManager::ActiveConnectionManager(const QDBusConnection& systemConnection) :
         d(new Priv(*this))
 {
-    d->m_manager = make_shared<OrgFreedesktopNetworkManagerInterface>(NM_DBUS_SERVICE, NM_DBUS_PATH, systemConnection);
-
-    d->updateConnections(d->m_manager->activeConnections());
+    d->m_manager = ProxyRegistry::get<OrgFreedesktopNetworkManagerInterface>(NM_DBUS_SERVICE, NM_DBUS_PATH, systemConnection);
 
     connect(d->m_manager.get(), &OrgFreedesktopNetworkManagerInterface::PropertiesChanged, d.get(), &Priv::propertiesChanged);
+
+    util::startup::begin("nm-active-connections");
+    auto message = QDBusMessage::createMethodCall(NM_DBUS_SERVICE,
+                                                  NM_DBUS_PATH,
+                                                  "org.freedesktop.DBus.Properties",
+                                                  "Get");
+    message << QString(NM_DBUS_INTERFACE) << QString("ActiveConnections");
+    auto watcher(new QDBusPendingCallWatcher(systemConnection.asyncCall(message), d.get()));
+    connect(watcher, &QDBusPendingCallWatcher::finished, d.get(), [this](QDBusPendingCallWatcher *call) {
+        call->deleteLater();
+        QDBusPendingReply<QDBusVariant> reply = *call;
+        d->m_listed = true;
+        if (reply.isError())
+        {
+            qWarning() << "Failed to get the active connections:" << reply.error().message();
+            d->checkReady();
+        }
+        else
+        {
+            d->updateConnections(qdbus_cast<QList<QDBusObjectPath>>(reply.value().variant()));
+        }
+    });
+}
+
+bool ActiveConnectionManager::isReady() const
+{
+    return d->m_ready;
 }
 
 QSet<ActiveConnection::SPtr> ActiveConnectionManager::connections() const
@@ -109,6 +304,11 @@ QSet<ActiveConnection::SPtr> ActiveConnectionManager::connections() const
     return d->m_connections.values().toSet();
 }
 
+ActiveConnection::SPtr ActiveConnectionManager::activeConnection(const QDBusObjectPath& connectionPath) const
+{
+    return d->indexed(connectionPath);
+}
+
 bool ActiveConnectionManager::deactivate(ActiveConnection::SPtr activeConnection)
 {
     auto reply = d->m_manager->DeactivateConnection(activeConnection->path());
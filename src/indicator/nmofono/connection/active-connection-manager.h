@@ -41,13 +41,28 @@ public:
 
     QSet<ActiveConnection::SPtr> connections() const;
 
+    /**
+     * The active connection for the settings connection at connectionPath,
+     * or null if it isn't active. If NetworkManager briefly has two, e.g.
+     * while re-activating, this is the newer one.
+     */
+    ActiveConnection::SPtr activeConnection(const QDBusObjectPath& connectionPath) const;
+
     bool deactivate(ActiveConnection::SPtr activeConnection);
 
+    /// the connections active at startup have been loaded
+    bool isReady() const;
+
 Q_SIGNALS:
+    void ready();
+
     void connectionsChanged(const QSet<ActiveConnection::SPtr>& connections);
 
     void connectionsUpdated();
 
+    // activeConnection(connectionPath) now returns something else
+    void activeConnectionChanged(const QDBusObjectPath& connectionPath);
+
 protected:
     class Priv;
     std::shared_ptr<Priv> d;
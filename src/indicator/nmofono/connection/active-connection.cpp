@@ -17,6 +17,7 @@
  */
 
 #include <nmofono/connection/active-connection.h>
+#include <nmofono/proxy-registry.h>
 #include <NetworkManagerActiveConnectionInterface.h>
 
 using namespace std;
@@ -137,15 +138,12 @@ public:
     QDBusObjectPath m_connectionPath;
 };
 
-ActiveConnection::ActiveConnection(const QDBusObjectPath& path, const QDBusConnection& systemConnection) :
+ActiveConnection::ActiveConnection(const QDBusObjectPath& path, const QVariantMap& properties, const QDBusConnection& systemConnection) :
         d(new Priv(*this))
 {
-    d->m_activeConnection = make_shared<OrgFreedesktopNetworkManagerConnectionActiveInterface>(NM_DBUS_SERVICE, path.path(), systemConnection);
+    d->m_activeConnection = ProxyRegistry::get<OrgFreedesktopNetworkManagerConnectionActiveInterface>(NM_DBUS_SERVICE, path.path(), systemConnection);
 
-    d->setId(d->m_activeConnection->id());
-    d->setType(d->m_activeConnection->type());
-    d->setState(static_cast<State>(d->m_activeConnection->state()));
-    d->setConnectionPath(d->m_activeConnection->connection());
+    d->propertiesChanged(properties);
 
     connect(d->m_activeConnection.get(), &OrgFreedesktopNetworkManagerConnectionActiveInterface::PropertiesChanged, d.get(), &Priv::propertiesChanged);
 }
@@ -21,6 +21,7 @@
 #include <QDBusConnection>
 #include <QDBusObjectPath>
 #include <QObject>
+#include <QVariantMap>
 
 #include <unity/util/DefinesPtrs.h>
 #include <NetworkManager.h>
@@ -48,7 +49,8 @@ public:
         deactivated = NM_ACTIVE_CONNECTION_STATE_DEACTIVATED
     };
 
-    ActiveConnection(const QDBusObjectPath& path, const QDBusConnection& systemConnection);
+    /// properties are the initial org.freedesktop.NetworkManager.Connection.Active ones
+    ActiveConnection(const QDBusObjectPath& path, const QVariantMap& properties, const QDBusConnection& systemConnection);
 
     ~ActiveConnection() = default;
 
@@ -19,7 +19,9 @@
 */
 
 #include <nmofono/hotspot-manager.h>
+#include <nmofono/proxy-registry.h>
 #include <qpowerd/qpowerd.h>
+#include <util/startup-timer.h>
 #include <NetworkManagerActiveConnectionInterface.h>
 #include <NetworkManagerDeviceInterface.h>
 #include <NetworkManagerInterface.h>
@@ -28,11 +30,14 @@
 #include <URfkillInterface.h>
 
 #include <QStringList>
+#include <QDBusPendingCallWatcher>
 #include <QDBusReply>
 #include <QtDebug>
-#include <QDBusInterface>
+#include <QDBusMessage>
 #include <QDBusMetaType>
 #include <QRegularExpression>
+#include <QTimer>
+#include <QVector>
 #include <NetworkManager.h>
 
 using namespace std;
@@ -55,9 +60,117 @@ class HotspotManager::Priv: public QObject
 {
 
 public:
+    /**
+     * Where we are in enabling the hotspot. Every step is driven by the
+     * replies and signals from NetworkManager, the timeout covers the
+     * steps that wait for NetworkManager to change its state.
+     */
+    enum class Step
+    {
+        idle,
+        setting_firmware,
+        waiting_for_device,
+        storing,
+        activating
+    };
+
     Priv(HotspotManager& parent) :
         p(parent)
     {
+        m_timeout.setInterval(2000);
+        m_timeout.setSingleShot(true);
+        connect(&m_timeout, &QTimer::timeout, this, &Priv::timedOut);
+    }
+
+    /**
+     * Calls fn with the reply of call, unless the attempt it belongs
+     * to has been finished or cancelled in the meantime.
+     */
+    template<typename F>
+    void whenFinished(const QDBusPendingCall& call, F fn)
+    {
+        unsigned int attempt = m_attempt;
+        auto watcher(new QDBusPendingCallWatcher(call, this));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, attempt, fn](QDBusPendingCallWatcher *call) {
+            call->deleteLater();
+            if (attempt == m_attempt)
+            {
+                fn(*call);
+            }
+        });
+    }
+
+    void setStep(Step step)
+    {
+        m_step = step;
+        if (step == Step::idle)
+        {
+            ++m_attempt;
+            m_timeout.stop();
+            clearCandidateDevices();
+            if (m_activationStateConnection)
+            {
+                disconnect(m_activationStateConnection);
+                m_activationStateConnection = QMetaObject::Connection();
+            }
+        }
+    }
+
+    /**
+     * Starts enabling the hotspot, or reactivating it on the AP device
+     * if it got booted.
+     */
+    void start(bool reactivating)
+    {
+        // Replies to an attempt still in flight are ignored from now on
+        setStep(Step::idle);
+        m_reactivating = reactivating;
+
+        if (reactivating)
+        {
+            findApDevice();
+            return;
+        }
+
+        // We use Hybris to load the new device firmware
+        setStep(Step::setting_firmware);
+        whenFinished(setInterfaceFirmware("/", m_mode), [this](const QDBusPendingCall&)
+        {
+            findApDevice();
+        });
+    }
+
+    void clearCandidateDevices()
+    {
+        // the device proxies are shared, so the connections outlive them here
+        for (const auto& connection : m_candidateConnections)
+        {
+            disconnect(connection);
+        }
+        m_candidateConnections.clear();
+        m_candidateDevices.clear();
+    }
+
+    void apDeviceFound(const QDBusObjectPath& path, const QString& interface)
+    {
+        qDebug() << "Using AP interface " << interface;
+        m_device = make_unique<ApDevice>(path, interface);
+        m_timeout.stop();
+        clearCandidateDevices();
+
+        if (m_reactivating)
+        {
+            qDebug() << "Reactivating hotspot connection on device" << m_device->m_path.path();
+            activateConnection();
+        }
+        else if (m_stored)
+        {
+            updateConnection();
+        }
+        else
+        {
+            addConnection();
+        }
     }
 
     void addConnection()
@@ -66,27 +179,32 @@ public:
         QVariantDictMap connection = createConnectionSettings(m_ssid, m_password,
                                                               m_mode, m_auth);
 
-        auto add_connection_reply = m_settings->AddConnection(connection);
-        add_connection_reply.waitForFinished();
-
-        if (add_connection_reply.isError())
+        setStep(Step::storing);
+        whenFinished(m_settings->AddConnection(connection), [this](const QDBusPendingCall& call)
         {
-            qCritical() << "Failed to add connection: "
-                    << add_connection_reply.error().message();
-            Q_EMIT p.reportError(0);
-            m_hotspot.reset();
+            QDBusPendingReply<QDBusObjectPath> add_connection_reply = call;
+            if (add_connection_reply.isError())
+            {
+                qCritical() << "Failed to add connection: "
+                        << add_connection_reply.error().message();
+                Q_EMIT p.reportError(0);
+                m_hotspot.reset();
+
+                setStored(false);
+                qWarning() << "Could not find a hotspot setup to enable";
+                setStep(Step::idle);
+                return;
+            }
 
-            setStored(false);
-            return;
-        }
+            QDBusObjectPath connectionPath(add_connection_reply);
 
-        QDBusObjectPath connectionPath(add_connection_reply);
+            m_hotspot = ProxyRegistry::get<OrgFreedesktopNetworkManagerSettingsConnectionInterface>(
+                    NM_DBUS_SERVICE, connectionPath.path(), m_manager->connection());
 
-        m_hotspot = make_shared<
-                OrgFreedesktopNetworkManagerSettingsConnectionInterface>(
-                NM_DBUS_SERVICE, connectionPath.path(), m_manager->connection());
+            setStored(true);
 
-        setStored(true);
+            activateConnection();
+        });
     }
 
     void updateConnection()
@@ -96,60 +214,93 @@ public:
         QVariantDictMap new_settings = createConnectionSettings(m_ssid,
                                                                 m_password,
                                                                 m_mode, m_auth);
-        auto updating = m_hotspot->Update(new_settings);
-        updating.waitForFinished();
-        if (!updating.isValid())
+        setStep(Step::storing);
+        whenFinished(m_hotspot->Update(new_settings), [this](const QDBusPendingCall& call)
         {
-            qCritical()
-                    << "Could not update connection:"
-                    << updating.error().message();
-        }
+            if (call.isError())
+            {
+                qCritical()
+                        << "Could not update connection:"
+                        << call.error().message();
+            }
+
+            activateConnection();
+        });
     }
 
-    bool activateConnection(const QDBusObjectPath& device)
+    void activateConnection()
     {
-        auto reply = m_manager->ActivateConnection(
-                        QDBusObjectPath(m_hotspot->path()), device,
-                        QDBusObjectPath("/"));
-        reply.waitForFinished();
-        if (reply.isError())
+        setStep(Step::activating);
+        whenFinished(m_manager->ActivateConnection(
+                         QDBusObjectPath(m_hotspot->path()), m_device->m_path,
+                         QDBusObjectPath("/")), [this](const QDBusPendingCall& call)
         {
-            qCritical() << "Could not activate hotspot connection"
-                    << reply.error().message();
-            return false;
-        }
-
-        QDBusObjectPath activeConnectionPath(reply);
+            QDBusPendingReply<QDBusObjectPath> reply = call;
+            if (reply.isError())
+            {
+                qCritical() << "Could not activate hotspot connection"
+                        << reply.error().message();
+                activated(false);
+                return;
+            }
 
-        OrgFreedesktopNetworkManagerConnectionActiveInterface activeConnection (
-                    NM_DBUS_SERVICE, activeConnectionPath.path (),
-                    m_manager->connection());
+            // Wait for connection to activate
+            qDebug() << "Waiting for hotspot to connect";
+            m_activeConnectionPath = reply;
+            m_timeout.start();
+            checkActivation();
+        });
+    }
 
-        int count = 0;
-        // Wait for connection to activate
-        while (count < 20 && activeConnection.state() != NM_ACTIVE_CONNECTION_STATE_ACTIVATED)
+    /**
+     * Follows the state of the connection we have activated, once the
+     * active connection manager knows about it.
+     */
+    void checkActivation()
+    {
+        if (m_step != Step::activating || m_timeout.isActive() == false)
         {
-            qDebug() << "Waiting for hotspot to connect";
-            QThread::msleep(100);
-            ++count;
+            return;
         }
 
-        return (activeConnection.state() == NM_ACTIVE_CONNECTION_STATE_ACTIVATED);
+        for (const auto& activeConnection : m_activeConnectionManager->connections())
+        {
+            if (activeConnection->path() != m_activeConnectionPath)
+            {
+                continue;
+            }
+
+            switch (activeConnection->state())
+            {
+                case connection::ActiveConnection::State::activated:
+                    activated(true);
+                    break;
+                case connection::ActiveConnection::State::deactivated:
+                    activated(false);
+                    break;
+                default:
+                    if (!m_activationStateConnection)
+                    {
+                        m_activationStateConnection = connect(activeConnection.get(),
+                                &connection::ActiveConnection::stateChanged,
+                                this, &Priv::checkActivation);
+                    }
+                    break;
+            }
+            return;
+        }
     }
 
-    /**
-     * Enables a hotspot.
-     */
-    void enable(const QDBusObjectPath& device)
+    void activated(bool success)
     {
-        if (!m_hotspot)
+        bool reactivating = m_reactivating;
+        setStep(Step::idle);
+
+        if (reactivating)
         {
-            qWarning() << "Could not find a hotspot setup to enable";
             return;
         }
 
-        qDebug() << "Activating hotspot on device" << device.path();
-        bool success = activateConnection(device);
         setEnable(success);
         if (success)
         {
@@ -157,7 +308,33 @@ public:
             connect(m_activeConnectionManager.get(),
                     &connection::ActiveConnectionManager::connectionsUpdated, this,
                     &Priv::reactivateConnection,
-                    Qt::QueuedConnection);
+                    Qt::ConnectionType(Qt::QueuedConnection | Qt::UniqueConnection));
+        }
+    }
+
+    void timedOut()
+    {
+        switch (m_step)
+        {
+            case Step::waiting_for_device:
+                setStep(Step::idle);
+                if (m_reactivating)
+                {
+                    qWarning() << "Could not get device when reactivating hotspot connection";
+                }
+                else
+                {
+                    qWarning() << "Failed to create AP device";
+                    Q_EMIT p.reportError(1);
+                    setDisconnectWifi(false);
+                }
+                break;
+            case Step::activating:
+                qWarning() << "Timed out waiting for hotspot to connect";
+                activated(false);
+                break;
+            default:
+                break;
         }
     }
 
@@ -166,6 +343,9 @@ public:
      */
     void disable()
     {
+        // Abandon anything still in flight
+        setStep(Step::idle);
+
         disconnect(m_activeConnectionManager.get(),
                    &connection::ActiveConnectionManager::connectionsUpdated,
                    this, &Priv::reactivateConnection);
@@ -173,10 +353,20 @@ public:
         auto activeConnection = getActiveConnection();
         if (activeConnection)
         {
-            m_activeConnectionManager->deactivate(activeConnection);
+            // Enabling the hotspot again before the reply cancels this
+            whenFinished(m_manager->DeactivateConnection(activeConnection->path()), [this](const QDBusPendingCall& call)
+            {
+                if (call.isError())
+                {
+                    qWarning() << call.error().message();
+                }
+                setInterfaceFirmware("/", "sta");
+            });
+        }
+        else
+        {
+            setInterfaceFirmware("/", "sta");
         }
-
-        setInterfaceFirmware("/", "sta");
 
         setEnable(false);
     }
@@ -209,45 +399,6 @@ public:
         }
     }
 
-    void updateSettingsFromDbus()
-    {
-        setEnable(isHotspotActive());
-        setDisconnectWifi(m_enabled);
-
-        QVariantDictMap settings = getConnectionSettings(*m_hotspot);
-        const char wifi_key[] = "802-11-wireless";
-        const char security_key[] = "802-11-wireless-security";
-
-        if (settings.find(wifi_key) != settings.end())
-        {
-            QByteArray ssid = settings[wifi_key]["ssid"].toByteArray();
-            if (!ssid.isEmpty())
-            {
-                p.setSsid(ssid);
-            }
-
-            QString mode = settings[wifi_key]["mode"].toString();
-            if (!mode.isEmpty())
-            {
-                p.setMode(mode);
-            }
-        }
-
-        QVariantDictMap secrets = getConnectionSecrets(*m_hotspot,
-                                                       security_key);
-
-        if (secrets.find(security_key) != secrets.end())
-        {
-            QString pwd = secrets[security_key]["psk"].toString();
-            if (!pwd.isEmpty())
-            {
-                p.setPassword(pwd);
-            }
-        } else {
-            p.setAuth("none");
-        }
-    }
-
     // wpa_supplicant interaction
 
     QString getTetheringInterface()
@@ -271,88 +422,122 @@ public:
     }
 
     /**
-     * True if changed successfully, or there was no need. Otherwise false.
+     * Asks wpa_supplicant to switch the firmware of the interface.
      * Supported modes are 'p2p', 'sta' and 'ap'.
      */
-    bool setInterfaceFirmware(const QString& interface, const QString& mode)
+    QDBusPendingCall setInterfaceFirmware(const QString& interface, const QString& mode)
     {
         // Not supported.
         if (mode == "adhoc")
         {
-            return true;
+            return QDBusPendingCall::fromCompletedCall(QDBusMessage().createReply());
         }
 
-        QDBusInterface wpasIface(DBusTypes::WPASUPPLICANT_DBUS_NAME,
-                                 DBusTypes::WPASUPPLICANT_DBUS_PATH,
-                                 DBusTypes::WPASUPPLICANT_DBUS_INTERFACE,
-                                 m_manager->connection());
+        auto message = QDBusMessage::createMethodCall(DBusTypes::WPASUPPLICANT_DBUS_NAME,
+                                                      DBusTypes::WPASUPPLICANT_DBUS_PATH,
+                                                      DBusTypes::WPASUPPLICANT_DBUS_INTERFACE,
+                                                      "SetInterfaceFirmware");
+        message << QVariant::fromValue(QDBusObjectPath(interface)) << QVariant(mode);
 
-        auto set_interface = wpasIface.call(
-                "SetInterfaceFirmware", QVariant::fromValue(QDBusObjectPath(interface)),
-                QVariant(mode));
+        auto set_interface = m_manager->connection().asyncCall(message);
 
-        if (set_interface.type() == QDBusMessage::ErrorMessage)
-        {
-            qCritical() << "Failed to change interface firmware:"
-                    << set_interface.errorMessage();
-            return false;
-        }
+        auto watcher(new QDBusPendingCallWatcher(set_interface, this));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [](QDBusPendingCallWatcher *call) {
+            call->deleteLater();
+            if (call->isError())
+            {
+                qCritical() << "Failed to change interface firmware:"
+                        << call->error().message();
+            }
+        });
 
-        return true;
+        return set_interface;
     }
 
+    /**
+     * Looks for the AP device among the current devices, and keeps
+     * looking at the ones that appear or change state until the
+     * timeout expires.
+     */
     void findApDevice()
     {
-        m_device.release();
-        QString tetherIface = getTetheringInterface();
+        qDebug() << "Searching for AP device";
+        m_device.reset();
+        m_tetherIface = getTetheringInterface();
 
-        auto devices = QList<QDBusObjectPath>(m_manager->GetDevices()).toStdList();
-        // Iterate in reverse to attempt to minimise dbus calls (new device is likely at the end)
-        for (auto path = devices.rbegin(); path != devices.rend(); ++path)
-        {
-            OrgFreedesktopNetworkManagerDeviceInterface device(NM_DBUS_SERVICE, path->path(), m_manager->connection());
+        setStep(Step::waiting_for_device);
+        m_timeout.start();
 
-            QString interface = device.interface();
-
-            if (!tetherIface.isEmpty())
+        whenFinished(m_manager->GetDevices(), [this](const QDBusPendingCall& call)
+        {
+            QDBusPendingReply<QList<QDBusObjectPath>> reply = call;
+            if (reply.isError())
             {
-                if (tetherIface.compare(interface) != 0)
-                {
-                    continue;
-                }
+                qWarning() << "Failed to list devices:" << reply.error().message();
+                return;
             }
 
-            if (device.deviceType() != NM_DEVICE_TYPE_WIFI)
+            // Check in reverse, the new device is likely at the end
+            auto devices = reply.value();
+            for (auto path = devices.crbegin(); path != devices.crend(); ++path)
             {
-                continue;
+                checkApDevice(*path);
             }
+        });
+    }
 
-            if (device.state() <= NM_DEVICE_STATE_UNAVAILABLE)
+    void checkApDevice(const QDBusObjectPath& path)
+    {
+        if (m_step != Step::waiting_for_device || m_candidateDevices.contains(path))
+        {
+            return;
+        }
+
+        auto device = ProxyRegistry::get<OrgFreedesktopNetworkManagerDeviceInterface>(
+                NM_DBUS_SERVICE, path.path(), m_manager->connection());
+        m_candidateDevices[path] = device;
+
+        auto message = QDBusMessage::createMethodCall(NM_DBUS_SERVICE, path.path(),
+                                                      "org.freedesktop.DBus.Properties",
+                                                      "GetAll");
+        message << QString(NM_DBUS_INTERFACE_DEVICE);
+
+        whenFinished(m_manager->connection().asyncCall(message), [this, path](const QDBusPendingCall& call)
+        {
+            QDBusPendingReply<QVariantMap> reply = call;
+            auto device = m_candidateDevices.value(path);
+            if (reply.isError() || !device || m_step != Step::waiting_for_device)
             {
-                continue;
+                m_candidateDevices.remove(path);
+                return;
             }
 
-            qDebug() << "Using AP interface " << interface;
-            m_device = make_unique<ApDevice>(*path, interface);
-            break;
-        }
-    }
+            QVariantMap properties = reply;
+            QString interface = properties.value("Interface").toString();
 
-    void createApDevice()
-    {
-        setInterfaceFirmware("/", m_mode);
+            if ((!m_tetherIface.isEmpty() && m_tetherIface.compare(interface) != 0)
+                    || properties.value("DeviceType").toUInt() != NM_DEVICE_TYPE_WIFI)
+            {
+                m_candidateDevices.remove(path);
+                return;
+            }
 
-        m_device.release();
+            if (properties.value("State").toUInt() > NM_DEVICE_STATE_UNAVAILABLE)
+            {
+                apDeviceFound(path, interface);
+                return;
+            }
 
-        int count = 0;
-        // Wait for AP device to appear
-        while (count < 20 && !m_device)
-        {
-            QThread::msleep(100);
-            findApDevice();
-            qDebug() << "Searching for AP device";
-            ++count;
-        }
+            // Wait for it to become available
+            m_candidateConnections << connect(device.get(), &OrgFreedesktopNetworkManagerDeviceInterface::StateChanged,
+                    this, [this, path, interface](uint new_state, uint, uint)
+            {
+                if (m_step == Step::waiting_for_device && new_state > NM_DEVICE_STATE_UNAVAILABLE)
+                {
+                    apDeviceFound(path, interface);
+                }
+            });
+        });
     }
 
     // wpa_supplicant interaction
@@ -423,64 +608,152 @@ public:
     }
 
     /**
-     * Helper that returns a QMap<QString, QVariantMap> given a QDBusObjectPath.
-     * See https://developer.gnome.org/NetworkManager/0.9/spec.html
-     *     #org.freedesktop.NetworkManager.Settings.Connection.GetSettings
+     * Looks for a stored hotspot of the current mode. The settings of all
+     * the connections are requested at once, the first one in the list
+     * that matches is the hotspot.
      */
-    QVariantDictMap getConnectionSettings (OrgFreedesktopNetworkManagerSettingsConnectionInterface& conn) {
-        auto connection_settings = conn.GetSettings();
-        connection_settings.waitForFinished();
-        return connection_settings.value();
-    }
+    void load()
+    {
+        util::startup::begin("nm-hotspot");
 
+        auto watcher(new QDBusPendingCallWatcher(m_settings->ListConnections(), this));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *call)
+        {
+            call->deleteLater();
+            QDBusPendingReply<QList<QDBusObjectPath>> reply = *call;
+            if (reply.isError())
+            {
+                qWarning() << "Failed to list connections:" << reply.error().message();
+                hotspotFound(QDBusObjectPath(), QVariantDictMap());
+                return;
+            }
 
-    /**
-     * Helper that returns a QMap<QString, QVariantMap> given a QDBusObjectPath.
-     * See https://developer.gnome.org/NetworkManager/0.9/spec.html
-     *     #org.freedesktop.NetworkManager.Settings.Connection.GetSettings
-     */
-    QVariantDictMap getConnectionSecrets (OrgFreedesktopNetworkManagerSettingsConnectionInterface& conn,
-        const QString key)
+            auto paths = reply.value();
+            if (paths.isEmpty())
+            {
+                hotspotFound(QDBusObjectPath(), QVariantDictMap());
+                return;
+            }
+
+            auto settings = make_shared<QVector<QVariantDictMap>>(paths.size());
+            auto remaining = make_shared<int>(paths.size());
+            for (int i = 0; i < paths.size(); ++i)
+            {
+                auto message = QDBusMessage::createMethodCall(NM_DBUS_SERVICE, paths.at(i).path(),
+                                                              NM_DBUS_INTERFACE_SETTINGS_CONNECTION,
+                                                              "GetSettings");
+                auto settingsWatcher(new QDBusPendingCallWatcher(m_manager->connection().asyncCall(message), this));
+                connect(settingsWatcher, &QDBusPendingCallWatcher::finished, this,
+                        [this, paths, settings, remaining, i](QDBusPendingCallWatcher *call)
+                {
+                    call->deleteLater();
+                    QDBusPendingReply<QVariantDictMap> reply = *call;
+                    if (!reply.isError())
+                    {
+                        (*settings)[i] = reply.value();
+                    }
+                    if (--*remaining == 0)
+                    {
+                        connectionsLoaded(paths, *settings);
+                    }
+                });
+            }
+        });
+    }
+
+    void connectionsLoaded(const QList<QDBusObjectPath>& paths, const QVector<QVariantDictMap>& settings)
     {
-        auto connection_secrets = conn.GetSecrets(key);
-        connection_secrets.waitForFinished();
-        return connection_secrets.value();
+        const char wifi_key[] = "802-11-wireless";
+
+        for (int i = 0; i < paths.size(); ++i)
+        {
+            auto wifi_setup = settings.at(i).find(wifi_key);
+            if (wifi_setup != settings.at(i).cend() && wifi_setup->value("mode").toString() == m_mode)
+            {
+                hotspotFound(paths.at(i), settings.at(i));
+                return;
+            }
+        }
+        hotspotFound(QDBusObjectPath(), QVariantDictMap());
     }
 
-    /**
-     * Returns a QDBusObjectPath of a hotspot given a mode.
-     * Valid modes are 'p2p', 'ap' and 'adhoc'.
-     */
-    void getHotspot()
+    void hotspotFound(const QDBusObjectPath& path, const QVariantDictMap& settings)
     {
+        // An attempt that got in first has stored its own
+        if (path.path().isEmpty() || m_hotspot)
+        {
+            setLoaded();
+            return;
+        }
+
         const char wifi_key[] = "802-11-wireless";
 
-        auto listed_connections = m_settings->ListConnections();
-        listed_connections.waitForFinished();
+        m_hotspot = ProxyRegistry::get<OrgFreedesktopNetworkManagerSettingsConnectionInterface>(
+                NM_DBUS_SERVICE, path.path(), m_manager->connection());
+        m_uuid = settings.value("connection").value("uuid").toString();
+        setStored(true);
+
+        QByteArray ssid = settings.value(wifi_key).value("ssid").toByteArray();
+        if (!ssid.isEmpty())
+        {
+            p.setSsid(ssid);
+        }
 
-        for (const auto &connection : listed_connections.value())
+        QString mode = settings.value(wifi_key).value("mode").toString();
+        if (!mode.isEmpty())
         {
-            auto conn = make_shared<OrgFreedesktopNetworkManagerSettingsConnectionInterface>(
-                    NM_DBUS_SERVICE, connection.path(),
-                    m_manager->connection());
+            p.setMode(mode);
+        }
+
+        auto watcher(new QDBusPendingCallWatcher(m_hotspot->GetSecrets("802-11-wireless-security"), this));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *call)
+        {
+            const char security_key[] = "802-11-wireless-security";
 
-            auto connection_settings = getConnectionSettings(*conn);
+            call->deleteLater();
+            QDBusPendingReply<QVariantDictMap> reply = *call;
+            QVariantDictMap secrets = reply.isError() ? QVariantDictMap() : reply.value();
 
-            if (connection_settings.find(wifi_key) != connection_settings.end())
+            if (secrets.find(security_key) != secrets.end())
             {
-                auto wifi_setup = connection_settings[wifi_key];
-                QString wifi_mode = wifi_setup["mode"].toString();
-
-                if (wifi_mode == m_mode)
+                QString pwd = secrets[security_key]["psk"].toString();
+                if (!pwd.isEmpty())
                 {
-                    m_hotspot = conn;
-                    m_uuid = connection_settings["connection"]["uuid"].toString();
-                    return;
+                    p.setPassword(pwd);
                 }
+            } else {
+                p.setAuth("none");
             }
+
+            setLoaded();
+        });
+    }
+
+    void setLoaded()
+    {
+        m_loaded = true;
+        util::startup::end("nm-hotspot");
+        checkReady();
+    }
+
+    /**
+     * Whether the stored hotspot is up can only be told once the active
+     * connections are in as well.
+     */
+    void checkReady()
+    {
+        if (m_ready || !m_loaded || !m_activeConnectionManager->isReady())
+        {
+            return;
+        }
+
+        m_ready = true;
+        if (m_hotspot && m_step == Step::idle)
+        {
+            setEnable(isHotspotActive());
+            setDisconnectWifi(m_enabled);
         }
-        m_hotspot.reset();
-        m_uuid = QString();
+        Q_EMIT p.ready();
     }
 
     connection::ActiveConnection::SPtr getActiveConnection()
@@ -550,24 +823,19 @@ public Q_SLOTS:
             return;
         }
 
-        auto activeConnection = getActiveConnection();
-        if (activeConnection)
+        // Still busy with the previous attempt
+        if (m_step != Step::idle)
         {
             return;
         }
 
-
-        findApDevice();
-
-        if (m_device)
-        {
-            qDebug() << "Reactivating hotspot connection on device" << m_device->m_path.path();
-            activateConnection(m_device->m_path);
-        }
-        else
+        auto activeConnection = getActiveConnection();
+        if (activeConnection)
         {
-            qWarning() << "Could not get device when reactivating hotspot connection";
+            return;
         }
+
+        start(true);
     }
 
 public:
@@ -582,6 +850,26 @@ public:
 
     unique_ptr<ApDevice> m_device;
 
+    Step m_step = Step::idle;
+
+    // bumped when an attempt is finished, so that late replies are ignored
+    unsigned int m_attempt = 0;
+
+    bool m_reactivating = false;
+
+    QTimer m_timeout;
+
+    QString m_tetherIface;
+
+    QMap<QDBusObjectPath, shared_ptr<OrgFreedesktopNetworkManagerDeviceInterface>> m_candidateDevices;
+
+    // StateChanged of the candidates that were not available yet
+    QList<QMetaObject::Connection> m_candidateConnections;
+
+    QDBusObjectPath m_activeConnectionPath;
+
+    QMetaObject::Connection m_activationStateConnection;
+
     QPowerd::UPtr m_powerd;
     QPowerd::RequestSPtr m_wakelock;
 
@@ -593,7 +881,7 @@ public:
      * https://developer.gnome.org/NetworkManager/0.9/spec.html
      *     #org.freedesktop.NetworkManager
      */
-    unique_ptr<OrgFreedesktopNetworkManagerInterface> m_manager;
+    shared_ptr<OrgFreedesktopNetworkManagerInterface> m_manager;
 
     /**
      * NetworkManager Settings interface proxy we use to get
@@ -601,13 +889,17 @@ public:
      * See https://developer.gnome.org/NetworkManager/0.9/spec.html
      *     #org.freedesktop.NetworkManager.Settings
      */
-    unique_ptr<OrgFreedesktopNetworkManagerSettingsInterface> m_settings;
+    shared_ptr<OrgFreedesktopNetworkManagerSettingsInterface> m_settings;
 
     shared_ptr<OrgFreedesktopNetworkManagerSettingsConnectionInterface> m_hotspot;
 
     QString m_uuid;
 
     connection::ActiveConnectionManager::SPtr m_activeConnectionManager;
+
+    bool m_loaded = false;
+
+    bool m_ready = false;
 };
 
 HotspotManager::HotspotManager(connection::ActiveConnectionManager::SPtr activeConnectionManager,
@@ -617,35 +909,38 @@ HotspotManager::HotspotManager(connection::ActiveConnectionManager::SPtr activeC
 {
     d->m_activeConnectionManager = activeConnectionManager;
 
-    d->m_manager = make_unique<OrgFreedesktopNetworkManagerInterface>(
+    d->m_manager = ProxyRegistry::get<OrgFreedesktopNetworkManagerInterface>(
             NM_DBUS_SERVICE, NM_DBUS_PATH, connection);
-    d->m_settings = make_unique<OrgFreedesktopNetworkManagerSettingsInterface>(
+    d->m_settings = ProxyRegistry::get<OrgFreedesktopNetworkManagerSettingsInterface>(
             NM_DBUS_SERVICE, NM_DBUS_PATH_SETTINGS, connection);
 
     d->m_powerd = make_unique<QPowerd>(connection);
 
+    connect(d->m_manager.get(), &OrgFreedesktopNetworkManagerInterface::DeviceAdded, d.get(), &Priv::checkApDevice);
+    connect(d->m_activeConnectionManager.get(), &connection::ActiveConnectionManager::connectionsUpdated, d.get(), &Priv::checkActivation);
+    connect(d->m_activeConnectionManager.get(), &connection::ActiveConnectionManager::ready, d.get(), &Priv::checkReady);
+
     d->generatePassword();
 
-    // Stored is false if hotspot path is empty.
-    d->getHotspot();
-    d->setStored(bool(d->m_hotspot));
+    // Stored stays false until a stored hotspot turns up
+    d->load();
+}
 
-    if (d->m_stored)
-    {
-        d->updateSettingsFromDbus();
-    }
+bool HotspotManager::isReady() const
+{
+    return d->m_ready;
 }
 
 void HotspotManager::setEnabled(bool value)
 {
-    if (enabled() == value)
-    {
-        return;
-    }
-
-    // We are enabling a hotspot
     if (value)
     {
+        // Already enabled, or on the way there
+        if (enabled() || (d->m_step != Priv::Step::idle && !d->m_reactivating))
+        {
+            return;
+        }
+
         // If the SSID is empty, we report an error.
         if (d->m_ssid.isEmpty())
         {
@@ -657,35 +952,21 @@ void HotspotManager::setEnabled(bool value)
 
         d->setDisconnectWifi(true);
 
-        // We use Hybris to load the new device firmware
-        d->createApDevice();
-
-        if (!d->m_device)
+        // The rest happens as NetworkManager gets back to us
+        d->start(false);
+    }
+    else
+    {
+        if (!enabled() && d->m_step == Priv::Step::idle)
         {
-            qWarning() << "Failed to create AP device";
-            Q_EMIT reportError(1);
-            d->setDisconnectWifi(false);
             return;
         }
 
-        if (d->m_stored)
-        {
-            d->updateConnection();
-        }
-        else
-        {
-            d->addConnection();
-        }
-        d->enable(d->m_device->m_path);
-    }
-    else
-    {
-        // Disabling the hotspot.
+        // Disabling the hotspot, or cancelling the enabling of it.
         d->disable();
 
         d->setDisconnectWifi(false);
     }
-
 }
 
 bool HotspotManager::enabled() const {
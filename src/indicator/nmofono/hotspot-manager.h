@@ -154,7 +154,12 @@ public:
 
     bool disconnectWifi() const;
 
+    /// the stored hotspot, if any, has been loaded
+    bool isReady() const;
+
 Q_SIGNALS:
+    void ready();
+
     void enabledChanged(bool enabled);
 
     void storedChanged(bool stored);
@@ -21,6 +21,9 @@
 #include <nmofono/kill-switch.h>
 #include <backend-utils.h>
 #include <dbus-types.h>
+#include <util/startup-timer.h>
+
+#include <QDBusPendingCallWatcher>
 
 #include <URfkillInterface.h>
 #include <URfkillKillswitchInterface.h>
@@ -55,6 +58,9 @@ public:
     bool m_flightMode = false;
     State m_state = State::not_available;
 
+    bool m_flightModeLoaded = false;
+    bool m_stateLoaded = false;
+
     Private(KillSwitch& parent,
             std::shared_ptr<OrgFreedesktopURfkillInterface> urfkill,
             std::shared_ptr<OrgFreedesktopURfkillKillswitchInterface> killSwitch)
@@ -76,7 +82,31 @@ public Q_SLOTS:
 
     void stateChanged()
     {
-        int stateIndex = killSwitch->state();
+        auto message = QDBusMessage::createMethodCall(killSwitch->service(),
+                                                      killSwitch->path(),
+                                                      "org.freedesktop.DBus.Properties",
+                                                      "Get");
+        message << killSwitch->interface() << QString("state");
+
+        auto watcher(new QDBusPendingCallWatcher(killSwitch->connection().asyncCall(message), this));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, &Private::stateLoaded);
+    }
+
+    void stateLoaded(QDBusPendingCallWatcher *call)
+    {
+        call->deleteLater();
+
+        QDBusPendingReply<QDBusVariant> reply = *call;
+        int stateIndex = static_cast<int>(State::not_available);
+        if (reply.isError())
+        {
+            qWarning() << "Failed to get the killswitch state:" << reply.error().message();
+        }
+        else
+        {
+            stateIndex = reply.value().variant().toInt();
+        }
+
         if (stateIndex >= static_cast<int>(State::first_) &&
             stateIndex <= static_cast<int>(State::last_))
         {
@@ -88,6 +118,34 @@ public Q_SLOTS:
         }
 
         Q_EMIT p.stateChanged(m_state);
+
+        if (!m_stateLoaded)
+        {
+            m_stateLoaded = true;
+            util::startup::end("urfkill-killswitch");
+            checkReady();
+        }
+    }
+
+    void flightModeLoaded(QDBusPendingCallWatcher *call)
+    {
+        call->deleteLater();
+
+        QDBusPendingReply<bool> reply = *call;
+        qDebug() << Q_FUNC_INFO << "reply.isValid()" << reply.isValid() << "reply.value()" << reply.value() << "reply.error()" << reply.error();
+        setFlightMode(reply.isValid() ? reply.value() : false);
+
+        m_flightModeLoaded = true;
+        util::startup::end("urfkill-flight-mode");
+        checkReady();
+    }
+
+    void checkReady()
+    {
+        if (m_flightModeLoaded && m_stateLoaded)
+        {
+            Q_EMIT p.ready();
+        }
     }
 };
 
@@ -103,14 +161,18 @@ KillSwitch::KillSwitch(const QDBusConnection& systemBus)
                                                                                  systemBus);
 
     d = make_unique<Private>(*this, urfkill, killSwitch);
-    auto reply = urfkill->IsFlightMode();
-    reply.waitForFinished();
-    qDebug() << Q_FUNC_INFO << "reply.isValid()" << reply.isValid() << "reply.value()" << reply.value() << "reply.error()" << reply.error();
-    d->setFlightMode(reply.isValid() ? reply.value() : false);
-    d->stateChanged();
 
     connect(urfkill.get(), &OrgFreedesktopURfkillInterface::FlightModeChanged, d.get(), &Private::setFlightMode);
     connect(killSwitch.get(), &OrgFreedesktopURfkillKillswitchInterface::StateChanged, d.get(), &Private::stateChanged);
+
+    // Don't wait for the replies, the rest of the startup carries on
+    // while urfkill answers.
+    util::startup::begin("urfkill-flight-mode");
+    auto watcher(new QDBusPendingCallWatcher(urfkill->IsFlightMode(), d.get()));
+    connect(watcher, &QDBusPendingCallWatcher::finished, d.get(), &Private::flightModeLoaded);
+
+    util::startup::begin("urfkill-killswitch");
+    d->stateChanged();
 }
 
 KillSwitch::~KillSwitch()
@@ -176,6 +238,11 @@ bool KillSwitch::isFlightMode()
     return d->m_flightMode;
 }
 
+bool KillSwitch::isReady() const
+{
+    return d->m_flightModeLoaded && d->m_stateLoaded;
+}
+
 }
 
 #include "kill-switch.moc"
@@ -56,9 +56,13 @@ public:
     bool flightMode(bool enable);
     bool isFlightMode();
 
+    /// the initial flight mode and state have been fetched
+    bool isReady() const;
+
 Q_SIGNALS:
     void stateChanged(State);
     void flightModeChanged(bool);
+    void ready();
 
 };
 
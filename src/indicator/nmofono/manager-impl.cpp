@@ -19,6 +19,7 @@
  */
 
 #include <nmofono/manager-impl.h>
+#include <nmofono/proxy-registry.h>
 #include <nmofono/connectivity-service-settings.h>
 #include <nmofono/wifi/wifi-link-impl.h>
 #include <nmofono/wwan/sim-manager.h>
@@ -38,7 +39,9 @@
 #include <notify-cpp/snapdecision/sim-unlock.h>
 #include <sim-unlock-dialog.h>
 #include <util/qhash-sharedptr.h>
+#include <util/startup-timer.h>
 
+#include <QDBusPendingCallWatcher>
 #include <QMap>
 #include <QList>
 #include <QRegularExpression>
@@ -69,6 +72,7 @@ public:
     bool m_hasWifi = false;
     bool m_wifiEnabled = false;
     KillSwitch::Ptr m_killSwitch;
+    wifi::KnownConnections::Ptr m_knownConnections;
 
     bool m_modemAvailable = false;
 
@@ -95,6 +99,14 @@ public:
 
     QTimer m_checkSimForMobileDataTimer;
 
+    ObjectCache::Ptr m_objectCache;
+
+    // devices whose type is still being fetched
+    QHash<QDBusObjectPath, QDBusPendingCallWatcher*> m_loadingDevices;
+    bool m_devicesLoaded = false;
+    bool m_statusLoaded = false;
+    bool m_ready = false;
+
     Private(Manager& parent) :
         p(parent)
     {
@@ -316,6 +328,24 @@ public Q_SLOTS:
         Q_EMIT p.wifiEnabledUpdated(m_wifiEnabled);
     }
 
+    void updateReady()
+    {
+        if (m_devicesLoaded && m_loadingDevices.isEmpty())
+        {
+            util::startup::end("nm-devices");
+        }
+
+        if (m_ready || !m_devicesLoaded || !m_loadingDevices.isEmpty()
+                || !m_statusLoaded || !m_killSwitch->isReady()
+                || !m_hotspotManager->isReady())
+        {
+            return;
+        }
+
+        m_ready = true;
+        Q_EMIT p.readyChanged(m_ready);
+    }
+
     void updateModemAvailable()
     {
         bool modemAvailable = !m_ofonoLinks.empty();
@@ -508,10 +538,11 @@ ManagerImpl::updateNetworkingStatus(uint status)
 ManagerImpl::ManagerImpl(notify::NotificationManager::SPtr notificationManager,
                          KillSwitch::Ptr killSwitch,
                          HotspotManager::SPtr hotspotManager,
+                         ObjectCache::Ptr objectCache,
                          const QDBusConnection& systemConnection) :
         d(new ManagerImpl::Private(*this))
 {
-    d->nm = make_shared<OrgFreedesktopNetworkManagerInterface>(NM_DBUS_SERVICE, NM_DBUS_PATH, systemConnection);
+    d->nm = ProxyRegistry::get<OrgFreedesktopNetworkManagerInterface>(NM_DBUS_SERVICE, NM_DBUS_PATH, systemConnection);
 
     d->m_unlockDialog = make_shared<SimUnlockDialog>(notificationManager);
     connect(d->m_unlockDialog.get(), &SimUnlockDialog::ready, d.get(), &Private::sim_unlock_ready);
@@ -533,6 +564,7 @@ ManagerImpl::ManagerImpl(notify::NotificationManager::SPtr notificationManager,
 
     d->m_killSwitch = killSwitch;
     connect(d->m_killSwitch.get(), &KillSwitch::stateChanged, d.get(), &Private::updateHasWifi);
+    connect(d->m_killSwitch.get(), &KillSwitch::ready, d.get(), &Private::updateReady);
 
     d->m_hotspotManager = hotspotManager;
     connect(d->m_hotspotManager.get(), &HotspotManager::enabledChanged, this, &Manager::hotspotEnabledChanged);
@@ -543,17 +575,28 @@ ManagerImpl::ManagerImpl(notify::NotificationManager::SPtr notificationManager,
     connect(d->m_hotspotManager.get(), &HotspotManager::storedChanged, this, &Manager::hotspotStoredChanged);
 
     connect(d->m_hotspotManager.get(), &HotspotManager::reportError, this, &Manager::reportError);
+    connect(d->m_hotspotManager.get(), &HotspotManager::ready, d.get(), &Private::updateReady);
 
-    connect(d->nm.get(), &OrgFreedesktopNetworkManagerInterface::DeviceAdded, this, &ManagerImpl::device_added);
-    QList<QDBusObjectPath> devices(d->nm->GetDevices());
-    for(const auto &path : devices) {
-        device_added(path);
-    }
+    d->m_knownConnections = make_shared<wifi::KnownConnections>(d->nm->connection());
 
+    connect(d->nm.get(), &OrgFreedesktopNetworkManagerInterface::DeviceAdded, this, &ManagerImpl::device_added);
     connect(d->nm.get(), &OrgFreedesktopNetworkManagerInterface::DeviceRemoved, this, &ManagerImpl::device_removed);
-    updateNetworkingStatus(d->nm->state());
     connect(d->nm.get(), &OrgFreedesktopNetworkManagerInterface::PropertiesChanged, this, &ManagerImpl::nm_properties_changed);
 
+    // The device list and the state are fetched in parallel with urfkill,
+    // oFono and the stored hotspot. Until they are in, ready() is false.
+    util::startup::begin("nm-devices");
+    util::startup::begin("nm-state");
+    d->m_objectCache = objectCache;
+    if (!d->m_objectCache || d->m_objectCache->isLoaded())
+    {
+        load_initial_state();
+    }
+    else
+    {
+        connect(d->m_objectCache.get(), &ObjectCache::loaded, this, &ManagerImpl::load_initial_state);
+    }
+
     connect(d->m_killSwitch.get(), &KillSwitch::flightModeChanged, d.get(), &Private::setFlightMode);
     d->setFlightMode(d->m_killSwitch->isFlightMode());
 
@@ -686,10 +729,79 @@ ManagerImpl::nm_properties_changed(const QVariantMap &properties)
     }
 }
 
+void
+ManagerImpl::load_initial_state()
+{
+    if (d->m_objectCache && d->m_objectCache->available())
+    {
+        // everything is in the snapshot already
+        auto properties = d->m_objectCache->properties(QDBusObjectPath(NM_DBUS_PATH), NM_DBUS_INTERFACE);
+        for (const auto &path : ObjectCache::objectPaths(properties.value("Devices")))
+        {
+            device_added(path);
+        }
+        d->m_devicesLoaded = true;
+
+        updateNetworkingStatus(properties.value("State").toUInt());
+        util::startup::end("nm-state");
+        d->m_statusLoaded = true;
+
+        d->updateReady();
+        return;
+    }
+
+    auto devicesWatcher(new QDBusPendingCallWatcher(d->nm->GetDevices(), d.get()));
+    connect(devicesWatcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *call) {
+        call->deleteLater();
+        QDBusPendingReply<QList<QDBusObjectPath>> reply = *call;
+        if (reply.isError())
+        {
+            qWarning() << "Failed to get the NetworkManager devices:" << reply.error().message();
+        }
+        else
+        {
+            for (const auto &path : reply.value())
+            {
+                device_added(path);
+            }
+        }
+        d->m_devicesLoaded = true;
+        d->updateReady();
+    });
+
+    auto stateMessage = QDBusMessage::createMethodCall(NM_DBUS_SERVICE,
+                                                       NM_DBUS_PATH,
+                                                       "org.freedesktop.DBus.Properties",
+                                                       "Get");
+    stateMessage << QString(NM_DBUS_INTERFACE) << QString("State");
+    auto stateWatcher(new QDBusPendingCallWatcher(d->nm->connection().asyncCall(stateMessage), d.get()));
+    connect(stateWatcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *call) {
+        call->deleteLater();
+        QDBusPendingReply<QDBusVariant> reply = *call;
+        if (reply.isError())
+        {
+            qWarning() << "Failed to get the NetworkManager state:" << reply.error().message();
+        }
+        else
+        {
+            updateNetworkingStatus(reply.value().variant().toUInt());
+        }
+        util::startup::end("nm-state");
+        d->m_statusLoaded = true;
+        d->updateReady();
+    });
+}
+
 void
 ManagerImpl::device_removed(const QDBusObjectPath &path)
 {
     qDebug() << "Device Removed:" << path.path();
+    if (d->m_loadingDevices.remove(path))
+    {
+        d->updateReady();
+        return;
+    }
+
     Link::Ptr toRemove;
     for (auto dev : d->m_nmLinks)
     {
@@ -712,6 +824,10 @@ void
 ManagerImpl::device_added(const QDBusObjectPath &path)
 {
     qDebug() << "Device Added:" << path.path();
+    if (d->m_loadingDevices.contains(path))
+    {
+        return;
+    }
     for (const auto &dev : d->m_nmLinks)
     {
         auto wifiLink = dynamic_pointer_cast<wifi::WifiLinkImpl>(dev);
@@ -721,14 +837,64 @@ ManagerImpl::device_added(const QDBusObjectPath &path)
         }
     }
 
+    if (d->m_objectCache && d->m_objectCache->contains(path, NM_DBUS_INTERFACE_DEVICE))
+    {
+        add_device(path, d->m_objectCache->properties(path, NM_DBUS_INTERFACE_DEVICE).value("DeviceType").toUInt());
+        return;
+    }
+
+    // Only the type is needed to decide whether we care about the device
+    auto message = QDBusMessage::createMethodCall(NM_DBUS_SERVICE,
+                                                  path.path(),
+                                                  "org.freedesktop.DBus.Properties",
+                                                  "Get");
+    message << QString(NM_DBUS_INTERFACE_DEVICE) << QString("DeviceType");
+
+    auto watcher(new QDBusPendingCallWatcher(d->nm->connection().asyncCall(message), d.get()));
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, path](QDBusPendingCallWatcher *call) {
+        device_loaded(path, call);
+    });
+    d->m_loadingDevices.insert(path, watcher);
+}
+
+void
+ManagerImpl::device_loaded(const QDBusObjectPath &path, QDBusPendingCallWatcher *call)
+{
+    call->deleteLater();
+
+    // removed while we were waiting for the type
+    if (d->m_loadingDevices.value(path) != call)
+    {
+        return;
+    }
+    d->m_loadingDevices.remove(path);
+
+    QDBusPendingReply<QDBusVariant> reply = *call;
+    if (reply.isError())
+    {
+        qDebug() << ": failed to get the type of Device "<< path.path() << ": ";
+        qDebug() << "\t" << reply.error().message();
+        qDebug() << "\tIgnoring.";
+        d->updateReady();
+        return;
+    }
+
+    add_device(path, reply.value().variant().toUInt());
+}
+
+void
+ManagerImpl::add_device(const QDBusObjectPath &path, uint type)
+{
     Link::Ptr link;
     try {
-        auto dev = make_shared<OrgFreedesktopNetworkManagerDeviceInterface>(
-            NM_DBUS_SERVICE, path.path(), d->nm->connection());
-        if (dev->deviceType() == NM_DEVICE_TYPE_WIFI) {
+        if (type == NM_DEVICE_TYPE_WIFI) {
+            auto dev = ProxyRegistry::get<OrgFreedesktopNetworkManagerDeviceInterface>(
+                NM_DBUS_SERVICE, path.path(), d->nm->connection());
             wifi::WifiLink::Ptr tmp = make_shared<wifi::WifiLinkImpl>(dev,
                                                 d->nm,
-                                                d->m_killSwitch);
+                                                d->m_killSwitch,
+                                                d->m_knownConnections,
+                                                d->m_objectCache);
 
             // We're not interested in showing access points
             if (tmp->name() != d->m_hotspotManager->interface())
@@ -744,6 +910,7 @@ ManagerImpl::device_added(const QDBusObjectPath &path)
         qDebug() << ": failed to create Device proxy for "<< path.path() << ": ";
         qDebug() << "\t" << e.what();
         qDebug() << "\tIgnoring.";
+        d->updateReady();
         return;
     }
 
@@ -753,9 +920,16 @@ ManagerImpl::device_added(const QDBusObjectPath &path)
     }
 
     d->updateHasWifi();
+    d->updateReady();
 }
 
 
+bool
+ManagerImpl::ready() const
+{
+    return d->m_ready;
+}
+
 bool
 ManagerImpl::unstoppableOperationHappening() const
 {
@@ -22,9 +22,11 @@
 #include <nmofono/manager.h>
 #include <nmofono/kill-switch.h>
 #include <nmofono/hotspot-manager.h>
+#include <nmofono/object-cache.h>
 
 #include <QDBusConnection>
 #include <QDBusObjectPath>
+#include <QDBusPendingCallWatcher>
 #include <QVariantMap>
 
 namespace notify
@@ -44,6 +46,8 @@ Q_OBJECT
 
     void updateNetworkingStatus(uint state);
 
+    void add_device(const QDBusObjectPath &path, uint type);
+
 public:
     typedef std::shared_ptr<ManagerImpl> Ptr;
 
@@ -51,9 +55,12 @@ public:
             std::shared_ptr<notify::NotificationManager> notificationManager,
             KillSwitch::Ptr killSwitch,
             HotspotManager::SPtr hotspotManager,
+            ObjectCache::Ptr objectCache,
             const QDBusConnection& systemBus);
 
     // Public API
+    bool ready() const override;
+
     void setFlightMode(bool) override;
     bool flightMode() const override;
 
@@ -114,7 +121,9 @@ public:
     void setSimForMobileData(wwan::Sim::Ptr) override;
 
 private Q_SLOTS:
+    void load_initial_state();
     void device_added(const QDBusObjectPath &path);
+    void device_loaded(const QDBusObjectPath &path, QDBusPendingCallWatcher *call);
     void device_removed(const QDBusObjectPath &path);
     void nm_properties_changed(const QVariantMap &properties);
 };
@@ -76,6 +76,10 @@ public:
     };
 
     /// @private
+    /// the initial state has been fetched from NetworkManager and urfkill
+    Q_PROPERTY(bool ready READ ready NOTIFY readyChanged)
+    virtual bool ready() const = 0;
+
     Q_PROPERTY(bool flightMode READ flightMode NOTIFY flightModeUpdated)
     virtual bool flightMode() const = 0;
 
@@ -158,6 +162,8 @@ public:
 
 
 Q_SIGNALS:
+    void readyChanged(bool);
+
     void flightModeUpdated(bool);
 
     void linksUpdated();
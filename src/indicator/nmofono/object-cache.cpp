@@ -0,0 +1,211 @@
+/*
+ * Copyright © 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <nmofono/object-cache.h>
+#include <util/startup-timer.h>
+
+#include <QDBusArgument>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDebug>
+
+using namespace std;
+
+namespace nmofono {
+
+namespace
+{
+const QString OBJECT_MANAGER_INTERFACE = "org.freedesktop.DBus.ObjectManager";
+const QString PROPERTIES_INTERFACE = "org.freedesktop.DBus.Properties";
+}
+
+struct ObjectCache::Private
+{
+    QDBusConnection m_connection;
+    QString m_service;
+
+    QManagedObjectMap m_objects;
+
+    bool m_loaded = false;
+    bool m_available = false;
+
+    Private(const QDBusConnection& connection) :
+        m_connection(connection)
+    {
+    }
+};
+
+ObjectCache::ObjectCache(const QDBusConnection& connection, const QString& service,
+                         const QString& root) :
+        d(new Private(connection))
+{
+    d->m_service = service;
+
+    // Listen before asking, so that no change is missed. Changes that arrive
+    // before the reply are already part of it.
+    d->m_connection.connect(service, root, OBJECT_MANAGER_INTERFACE, "InterfacesAdded",
+                            this, SLOT(interfacesAdded(const QDBusObjectPath&, const QVariantDictMap&)));
+    d->m_connection.connect(service, root, OBJECT_MANAGER_INTERFACE, "InterfacesRemoved",
+                            this, SLOT(interfacesRemoved(const QDBusObjectPath&, const QStringList&)));
+    d->m_connection.connect(service, QString(), PROPERTIES_INTERFACE, "PropertiesChanged",
+                            this, SLOT(propertiesChanged(const QDBusMessage&)));
+
+    util::startup::begin("nm-objects");
+    auto message = QDBusMessage::createMethodCall(service, root, OBJECT_MANAGER_INTERFACE,
+                                                  "GetManagedObjects");
+    auto watcher(new QDBusPendingCallWatcher(d->m_connection.asyncCall(message), this));
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, &ObjectCache::managedObjectsLoaded);
+}
+
+ObjectCache::~ObjectCache()
+{
+}
+
+void
+ObjectCache::managedObjectsLoaded(QDBusPendingCallWatcher *call)
+{
+    call->deleteLater();
+    util::startup::end("nm-objects");
+
+    QDBusPendingReply<QManagedObjectMap> reply = *call;
+    if (reply.isError())
+    {
+        qDebug() << "ObjectManager not available for" << d->m_service << ":" << reply.error().message();
+        d->m_objects.clear();
+    }
+    else
+    {
+        d->m_objects = reply.value();
+        d->m_available = true;
+    }
+
+    d->m_loaded = true;
+    Q_EMIT loaded(d->m_available);
+}
+
+void
+ObjectCache::interfacesAdded(const QDBusObjectPath& path, const QVariantDictMap& interfaces)
+{
+    if (!d->m_available)
+    {
+        return;
+    }
+
+    auto& object = d->m_objects[path];
+    for (auto it = interfaces.cbegin(); it != interfaces.cend(); ++it)
+    {
+        object.insert(it.key(), it.value());
+    }
+}
+
+void
+ObjectCache::interfacesRemoved(const QDBusObjectPath& path, const QStringList& interfaces)
+{
+    if (!d->m_available)
+    {
+        return;
+    }
+
+    auto it = d->m_objects.find(path);
+    if (it == d->m_objects.end())
+    {
+        return;
+    }
+
+    for (const auto& interface : interfaces)
+    {
+        it->remove(interface);
+    }
+    if (it->isEmpty())
+    {
+        d->m_objects.erase(it);
+    }
+}
+
+void
+ObjectCache::propertiesChanged(const QDBusMessage& message)
+{
+    if (!d->m_available || message.arguments().size() < 2)
+    {
+        return;
+    }
+
+    auto object = d->m_objects.find(QDBusObjectPath(message.path()));
+    if (object == d->m_objects.end())
+    {
+        return;
+    }
+
+    QString interface = message.arguments().at(0).toString();
+    auto properties = object->find(interface);
+    if (properties == object->end())
+    {
+        return;
+    }
+
+    QVariantMap changed = qdbus_cast<QVariantMap>(message.arguments().at(1));
+    for (auto it = changed.cbegin(); it != changed.cend(); ++it)
+    {
+        properties->insert(it.key(), it.value());
+    }
+
+    if (message.arguments().size() > 2)
+    {
+        for (const auto& name : qdbus_cast<QStringList>(message.arguments().at(2)))
+        {
+            properties->remove(name);
+        }
+    }
+}
+
+bool
+ObjectCache::isLoaded() const
+{
+    return d->m_loaded;
+}
+
+bool
+ObjectCache::available() const
+{
+    return d->m_available;
+}
+
+bool
+ObjectCache::contains(const QDBusObjectPath& path, const QString& interface) const
+{
+    auto object = d->m_objects.constFind(path);
+    return object != d->m_objects.constEnd() && object->contains(interface);
+}
+
+QVariantMap
+ObjectCache::properties(const QDBusObjectPath& path, const QString& interface) const
+{
+    return d->m_objects.value(path).value(interface);
+}
+
+QList<QDBusObjectPath>
+ObjectCache::objectPaths(const QVariant& value)
+{
+    if (value.canConvert<QDBusArgument>())
+    {
+        return qdbus_cast<QList<QDBusObjectPath>>(value.value<QDBusArgument>());
+    }
+    return value.value<QList<QDBusObjectPath>>();
+}
+
+}
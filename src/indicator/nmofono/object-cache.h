@@ -0,0 +1,88 @@
+/*
+ * Copyright © 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <memory>
+
+#include <dbus-types.h>
+
+#include <QDBusConnection>
+#include <QDBusObjectPath>
+#include <QList>
+#include <QObject>
+#include <QStringList>
+#include <QVariantMap>
+
+class QDBusMessage;
+class QDBusPendingCallWatcher;
+
+namespace nmofono {
+
+// In-memory copy of the objects a service exports through
+// org.freedesktop.DBus.ObjectManager.
+//
+// The whole tree is fetched with a single GetManagedObjects call and kept
+// up-to-date from the InterfacesAdded, InterfacesRemoved and
+// PropertiesChanged signals. Older NetworkManager versions don't implement
+// the ObjectManager interface; then available() stays false and the callers
+// fall back to asking each object on its own.
+
+class ObjectCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef std::shared_ptr<ObjectCache> Ptr;
+
+    ObjectCache(const QDBusConnection& connection, const QString& service,
+                const QString& root);
+
+    ~ObjectCache();
+
+    // the reply to GetManagedObjects has arrived
+    bool isLoaded() const;
+
+    // ... and it was not an error
+    bool available() const;
+
+    bool contains(const QDBusObjectPath& path, const QString& interface) const;
+
+    // empty if the object or interface is not known
+    QVariantMap properties(const QDBusObjectPath& path, const QString& interface) const;
+
+    // an "ao" property as found in the properties maps
+    static QList<QDBusObjectPath> objectPaths(const QVariant& value);
+
+Q_SIGNALS:
+    void loaded(bool available);
+
+private Q_SLOTS:
+    void managedObjectsLoaded(QDBusPendingCallWatcher *call);
+
+    void interfacesAdded(const QDBusObjectPath& path, const QVariantDictMap& interfaces);
+
+    void interfacesRemoved(const QDBusObjectPath& path, const QStringList& interfaces);
+
+    void propertiesChanged(const QDBusMessage& message);
+
+private:
+    struct Private;
+    std::unique_ptr<Private> d;
+};
+
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright © 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <nmofono/proxy-registry.h>
+
+#include <QHash>
+
+using namespace std;
+
+namespace nmofono {
+
+namespace
+{
+
+QHash<QString, weak_ptr<QDBusAbstractInterface>>&
+proxies()
+{
+    static QHash<QString, weak_ptr<QDBusAbstractInterface>> proxies;
+    return proxies;
+}
+
+// number of proxies created since the expired entries were last dropped
+int insertsSincePrune = 0;
+
+void
+prune()
+{
+    auto& table = proxies();
+    for (auto it = table.begin(); it != table.end();)
+    {
+        if (it->expired())
+        {
+            it = table.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    insertsSincePrune = 0;
+}
+
+}
+
+QString
+ProxyRegistry::makeKey(const QDBusConnection& connection,
+                       const QString& service,
+                       const QString& path,
+                       const QString& interface)
+{
+    return connection.name() + '\n' + service + '\n' + path + '\n' + interface;
+}
+
+shared_ptr<QDBusAbstractInterface>
+ProxyRegistry::find(const QString& key)
+{
+    auto& table = proxies();
+    auto it = table.constFind(key);
+    if (it == table.constEnd())
+    {
+        return nullptr;
+    }
+    return it->lock();
+}
+
+void
+ProxyRegistry::insert(const QString& key,
+                      shared_ptr<QDBusAbstractInterface> proxy)
+{
+    auto& table = proxies();
+    table.insert(key, proxy);
+
+    // Access points and active connections come and go all the time, so
+    // drop the dead entries once the table could have doubled.
+    if (++insertsSincePrune > table.size() / 2 + 16)
+    {
+        prune();
+    }
+}
+
+int
+ProxyRegistry::size()
+{
+    prune();
+    return proxies().size();
+}
+
+}
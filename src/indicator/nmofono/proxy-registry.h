@@ -0,0 +1,74 @@
+/*
+ * Copyright © 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <memory>
+
+#include <QDBusAbstractInterface>
+#include <QDBusConnection>
+#include <QString>
+
+namespace nmofono {
+
+// Process-wide cache of D-Bus proxies, one per connection, service, path and
+// interface. Every QDBusAbstractInterface adds its own match rules, so the
+// objects that talk to the same NetworkManager object share one proxy
+// instead of creating their own.
+//
+// The registry only holds weak references: a proxy lives as long as one of
+// its users, and is created again on the next request after that. It is
+// meant to be used from the main thread only.
+
+class ProxyRegistry
+{
+public:
+    template<typename Interface>
+    static std::shared_ptr<Interface> get(const QString& service,
+                                          const QString& path,
+                                          const QDBusConnection& connection)
+    {
+        QString key = makeKey(connection, service, path,
+                              QString::fromLatin1(Interface::staticInterfaceName()));
+
+        auto proxy = std::static_pointer_cast<Interface>(find(key));
+        if (!proxy)
+        {
+            proxy = std::make_shared<Interface>(service, path, connection);
+            insert(key, proxy);
+        }
+        return proxy;
+    }
+
+    // number of live proxies
+    static int size();
+
+private:
+    ProxyRegistry() = delete;
+
+    static QString makeKey(const QDBusConnection& connection,
+                           const QString& service,
+                           const QString& path,
+                           const QString& interface);
+
+    static std::shared_ptr<QDBusAbstractInterface> find(const QString& key);
+
+    static void insert(const QString& key,
+                       std::shared_ptr<QDBusAbstractInterface> proxy);
+};
+
+}
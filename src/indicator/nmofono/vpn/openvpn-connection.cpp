@@ -20,52 +20,10 @@
 #include <nmofono/vpn/openvpn-connection.h>
 
 #include <NetworkManagerSettingsConnectionInterface.h>
+#include <vpn-fields.h>
 
 using namespace std;
 
-#define DEFINE_UPDATE_SETTER(name, uppername, type)\
-void set##uppername(type value)\
-{\
-    if (m_data.m_##name == value)\
-    {\
-        return;\
-    }\
-    m_data.m_##name = value;\
-    Q_EMIT p.name##Changed(m_data.m_##name);\
-}
-
-#define DEFINE_UPDATE_PROPERTY_STRING(name, uppername, strname) \
-void update##uppername(const QStringMap& data)\
-{\
-    set##uppername(data.value(strname));\
-}\
-\
-DEFINE_UPDATE_SETTER(name, uppername, const QString &)
-
-#define DEFINE_UPDATE_PROPERTY_BOOL(name, uppername, strname) \
-void update##uppername(const QStringMap& data)\
-{\
-    set##uppername(data.value(strname) == "yes");\
-}\
-\
-DEFINE_UPDATE_SETTER(name, uppername, bool)
-
-#define DEFINE_UPDATE_PROPERTY_PAIR(name, uppername, strname, type, conversion)\
-void update##uppername(const QStringMap& data)\
-{\
-    auto it = data.constFind(strname);\
-    bool found = (it != data.constEnd());\
-    set##uppername##Set(found);\
-    if (found)\
-    {\
-        set##uppername(it->conversion);\
-    }\
-}\
-\
-DEFINE_UPDATE_SETTER(name, uppername, type)\
-\
-DEFINE_UPDATE_SETTER(name##Set, uppername##Set, bool)\
-
 #define DEFINE_PROPERTY_GETTER(name,type) \
 type OpenvpnConnection::name() const\
 {\
@@ -85,7 +43,7 @@ void OpenvpnConnection::set##uppername(type value)\
     }\
     d->m_dirty = true;\
     d->m_pendingData.m_##varname = value;\
-    Q_EMIT updateVpnData(d->m_pendingData.buildData());\
+    Q_EMIT vpnDataEdited();\
 }
 
 #define DEFINE_SECRET_PROPERTY_SETTER(varname, uppername, type) \
@@ -101,9 +59,15 @@ void OpenvpnConnection::set##uppername(type value)\
     }\
     d->m_dirty = true;\
     d->m_pendingData.m_##varname = value;\
-    Q_EMIT updateVpnSecrets(d->m_pendingData.buildSecrets());\
+    Q_EMIT vpnSecretsEdited();\
 }
 
+#define PROPERTY(name) \
+    {#name,\
+     &Priv::setProperty<decltype(Data::m_##name), &Data::m_##name,\
+                        decltype(&OpenvpnConnection::name##Changed), &OpenvpnConnection::name##Changed>,\
+     &Priv::copyProperty<decltype(Data::m_##name), &Data::m_##name>}
+
 namespace nmofono
 {
 namespace vpn
@@ -123,68 +87,14 @@ public:
 
         Data& operator=(const Data& other)
         {
-            // Basic properties
-
-            m_ca = other.m_ca;
-            m_cert = other.m_cert;
-            m_certPass = other.m_certPass;
-            m_connectionType = other.m_connectionType;
-            m_key = other.m_key;
-            m_localIp = other.m_localIp;
-            m_password = other.m_password;
-            m_remote = other.m_remote;
-            m_remoteIp = other.m_remoteIp;
-            m_staticKey = other.m_staticKey;
-            m_staticKeyDirection = other.m_staticKeyDirection;
-            m_username = other.m_username;
-
-            // Advanced general properties
-
-            m_port = other.m_port;
-            m_portSet = other.m_portSet;
-            m_renegSeconds = other.m_renegSeconds;
-            m_renegSecondsSet = other.m_renegSecondsSet;
-            m_compLzo = other.m_compLzo;
-            m_protoTcp = other.m_protoTcp;
-            m_dev = other.m_dev;
-            m_devType = other.m_devType;
-            m_devTypeSet = other.m_devTypeSet;
-            m_tunnelMtu = other.m_tunnelMtu;
-            m_tunnelMtuSet = other.m_tunnelMtuSet;
-            m_fragmentSize = other.m_fragmentSize;
-            m_fragmentSizeSet = other.m_fragmentSizeSet;
-            m_mssFix = other.m_mssFix;
-            m_remoteRandom = other.m_remoteRandom;
-
-            // Advanced security properties
-
-            m_cipher = other.m_cipher;
-            m_keysize = other.m_keysize;
-            m_keysizeSet = other.m_keysizeSet;
-            m_auth = other.m_auth;
-
-            // Advanced TLS auth properties
-
-            m_tlsRemote = other.m_tlsRemote;
-            m_remoteCertTls = other.m_remoteCertTls;
-            m_remoteCertTlsSet = other.m_remoteCertTlsSet;
-            m_ta = other.m_ta;
-            m_taDir = other.m_taDir;
-            m_taSet = other.m_taSet;
-
-            // Advanced proxy settings
-
-            m_proxyType = other.m_proxyType;
-            m_proxyServer = other.m_proxyServer;
-            m_proxyPort = other.m_proxyPort;
-            m_proxyRetry = other.m_proxyRetry;
-            m_proxyUsername = other.m_proxyUsername;
-            m_proxyPassword = other.m_proxyPassword;
-
+            for (const auto& property : PROPERTIES)
+            {
+                property.copy(*this, other);
+            }
             return *this;
         }
 
-        QStringMap buildSecrets()
+        QStringMap buildSecrets() const
         {
             QStringMap secrets;
 
@@ -222,26 +132,13 @@ public:
             return secrets;
         }
 
-        QStringMap buildData()
+        QStringMap buildData() const
         {
             QStringMap data;
 
-            static const QMap<KeyDir, QString> keyDirMap
-            {
-                {ZERO, "0"},
-                {ONE, "1"}
-            };
-
             // Basic properties
 
-            static const QMap<ConnectionType, QString> connectionTypeMap
-            {
-                {ConnectionType::TLS, "tls"},
-                {ConnectionType::PASSWORD, "password"},
-                {ConnectionType::PASSWORD_TLS, "password-tls"},
-                {ConnectionType::STATIC_KEY, "static-key"}
-            };
-            data["connection-type"] = connectionTypeMap[m_connectionType];
+            data["connection-type"] = vpnfields::openvpn::CONNECTION_TYPES[int(m_connectionType)];
 
             switch (m_connectionType)
             {
@@ -275,7 +172,7 @@ public:
                     data["static-key"] = m_staticKey;
                     if (m_staticKeyDirection != KeyDir::KEY_NONE)
                     {
-                        data["static-key-direction"] = keyDirMap[m_staticKeyDirection];
+                        data["static-key-direction"] = vpnfields::openvpn::KEY_DIRECTIONS[m_staticKeyDirection];
                     }
                     break;
             }
@@ -298,14 +195,9 @@ public:
             {
                 data["proto-tcp"] = "yes";
             }
-            static const QMap<DevType, QString> devTypeMap
-            {
-                {DevType::TUN, "tun"},
-                {DevType::TAP, "tap"}
-            };
             if (m_devTypeSet)
             {
-                data["dev-type"] = devTypeMap[m_devType];
+                data["dev-type"] = vpnfields::openvpn::DEV_TYPES[m_devType];
                 if (!m_dev.isEmpty())
                 {
                     data["dev"] = m_dev;
@@ -330,48 +222,17 @@ public:
 
             // Advanced security properties
 
-            static const QMap<Cipher, QString> cipherMap
-            {
-                {Cipher::DES_CBC, "DES-CBC"},
-                {Cipher::RC2_CBC, "RC2-CBC"},
-                {Cipher::DES_EDE_CBC, "DES-EDE-CBC"},
-                {Cipher::DES_EDE3_CBC, "DES-EDE3-CBC"},
-                {Cipher::DESX_CBC, "DESX-CBC"},
-                {Cipher::RC2_40_CBC, "RC2-40-CBC"},
-                {Cipher::CAST5_CBC, "CAST5-CBC"},
-                {Cipher::AES_128_CBC, "AES-128-CBC"},
-                {Cipher::AES_192_CBC, "AES-192-CBC"},
-                {Cipher::AES_256_CBC, "AES-256-CBC"},
-                {Cipher::CAMELLIA_128_CBC, "CAMELLIA-128-CBC"},
-                {Cipher::CAMELLIA_192_CBC, "CAMELLIA-192-CBC"},
-                {Cipher::CAMELLIA_256_CBC, "CAMELLIA-256-CBC",},
-                {Cipher::SEED_CBC, "SEED-CBC"},
-                {Cipher::AES_128_CBC_HMAC_SHA1, "AES-128-CBC-HMAC-SHA1"},
-                {Cipher::AES_256_CBC_HMAC_SHA1, "AES-256-CBC-HMAC-SHA1"}
-            };
             if (m_cipher != Cipher::DEFAULT_CIPHER)
             {
-                data["cipher"] = cipherMap[m_cipher];
+                data["cipher"] = vpnfields::openvpn::CIPHERS[m_cipher];
             }
             if (m_keysizeSet)
             {
                 data["keysize"] = QString::number(m_keysize);
             }
-            static const QMap<Auth, QString> authMap
-            {
-                {NONE, "none"},
-                {RSA_MD4, "RSA-MD4"},
-                {MD5, "MD5"},
-                {SHA1, "SHA1"},
-                {SHA224, "SHA224"},
-                {SHA256, "SHA256"},
-                {SHA384, "SHA384"},
-                {SHA512, "SHA512"},
-                {RIPEMD160, "RIPEMD160"}
-            };
             if (m_auth != Auth::DEFAULT_AUTH)
             {
-                data["auth"] = authMap[m_auth];
+                data["auth"] = vpnfields::openvpn::AUTHS[m_auth];
             }
 
             // Advanced TLS auth properties
@@ -382,21 +243,16 @@ public:
                 {
                     data["tls-remote"] = m_tlsRemote;
                 }
-                static const QMap<TlsType, QString> remoteCertTlsMap
-                {
-                    {SERVER, "server"},
-                    {CLIENT, "client"}
-                };
                 if (m_remoteCertTlsSet)
                 {
-                    data["remote-cert-tls"] = remoteCertTlsMap[m_remoteCertTls];
+                    data["remote-cert-tls"] = vpnfields::openvpn::TLS_TYPES[m_remoteCertTls];
                 }
 
                 if (m_taSet)
                 {
                     if (m_taDir != KeyDir::KEY_NONE)
                     {
-                        data["ta-dir"] = keyDirMap[m_taDir];
+                        data["ta-dir"] = vpnfields::openvpn::KEY_DIRECTIONS[m_taDir];
                     }
                     data["ta"] = (m_ta.isEmpty() ? "/" : m_ta);
                 }
@@ -404,14 +260,9 @@ public:
 
             // Advanced proxy settings
 
-            static const QMap<ProxyType, QString> proxyTypeMap
-            {
-                {HTTP, "http"},
-                {SOCKS, "socks"}
-            };
             if (m_proxyType != ProxyType::NOT_REQUIRED)
             {
-                data["proxy-type"] = proxyTypeMap[m_proxyType];
+                data["proxy-type"] = vpnfields::openvpn::PROXY_TYPES[m_proxyType];
                 data["proxy-server"] = m_proxyServer;
                 data["proxy-port"] = QString::number(m_proxyPort);
                 if (m_proxyRetry)
@@ -501,261 +352,177 @@ public:
     {
     }
 
-    // Basic properties
+    struct Property
+    {
+        // a vpnfields::openvpn::FIELDS name, or the Set flag of an Optional one
+        const char* name;
 
-    DEFINE_UPDATE_PROPERTY_STRING(ca, Ca, "ca")
-    DEFINE_UPDATE_PROPERTY_STRING(cert, Cert, "cert")
-    DEFINE_UPDATE_PROPERTY_STRING(certPass, CertPass, "cert-pass")
+        void (*set)(Priv& priv, const QVariant& value);
 
-    void updateConnectionType(const QStringMap& data)
+        void (*copy)(Data& data, const Data& other);
+    };
+
+    template<typename T, T Data::* member, typename Signal, Signal changed>
+    static void setProperty(Priv& priv, const QVariant& value)
     {
-        static const QMap<QString, ConnectionType> typeMap
+        T v = vpnfields::fromVariant<T>(value);
+        if (priv.m_data.*member == v)
         {
-            {"tls", ConnectionType::TLS},
-            {"password", ConnectionType::PASSWORD},
-            {"password-tls", ConnectionType::PASSWORD_TLS},
-            {"static-key", ConnectionType::STATIC_KEY}
-        };
-
-        setConnectionType(typeMap.value(data["connection-type"], ConnectionType::TLS));
+            return;
+        }
+        priv.m_data.*member = v;
+        Q_EMIT (priv.p.*changed)(priv.m_data.*member);
     }
-    DEFINE_UPDATE_SETTER(connectionType, ConnectionType, OpenvpnConnection::ConnectionType)
 
-    DEFINE_UPDATE_PROPERTY_STRING(key, Key, "key")
-    DEFINE_UPDATE_PROPERTY_STRING(localIp, LocalIp, "local-ip")
-    DEFINE_UPDATE_PROPERTY_STRING(password, Password, "password")
-    DEFINE_UPDATE_PROPERTY_STRING(remote, Remote, "remote")
-    DEFINE_UPDATE_PROPERTY_STRING(remoteIp, RemoteIp, "remote-ip")
-    DEFINE_UPDATE_PROPERTY_STRING(staticKey, StaticKey, "static-key")
+    template<typename T, T Data::* member>
+    static void copyProperty(Data& data, const Data& other)
+    {
+        data.*member = other.*member;
+    }
 
-    void updateStaticKeyDirection(const QStringMap& data)
+    static constexpr Property PROPERTIES[] =
     {
-        static const QMap<QString, KeyDir> typeMap
-        {
-            {"0", KeyDir::ZERO},
-            {"1", KeyDir::ONE}
-        };
+        // Basic properties
 
-        auto it = data.constFind("static-key-direction");
-        if (it != data.constEnd())
-        {
-            setStaticKeyDirection(typeMap.value(*it, KeyDir::KEY_NONE));
-        }
-        else
-        {
-            setStaticKeyDirection(KeyDir::KEY_NONE);
-        }
-    }
-    DEFINE_UPDATE_SETTER(staticKeyDirection, StaticKeyDirection, OpenvpnConnection::KeyDir)
+        PROPERTY(ca),
+        PROPERTY(cert),
+        PROPERTY(certPass),
+        PROPERTY(connectionType),
+        PROPERTY(key),
+        PROPERTY(localIp),
+        PROPERTY(password),
+        PROPERTY(remote),
+        PROPERTY(remoteIp),
+        PROPERTY(staticKey),
+        PROPERTY(staticKeyDirection),
+        PROPERTY(username),
 
-    DEFINE_UPDATE_PROPERTY_STRING(username, Username, "username")
+        // Advanced general properties
 
-    // Advanced general properties
+        PROPERTY(port),
+        PROPERTY(portSet),
+        PROPERTY(renegSeconds),
+        PROPERTY(renegSecondsSet),
+        PROPERTY(compLzo),
+        PROPERTY(protoTcp),
+        PROPERTY(dev),
+        PROPERTY(devType),
+        PROPERTY(devTypeSet),
+        PROPERTY(tunnelMtu),
+        PROPERTY(tunnelMtuSet),
+        PROPERTY(fragmentSize),
+        PROPERTY(fragmentSizeSet),
+        PROPERTY(mssFix),
+        PROPERTY(remoteRandom),
 
-    DEFINE_UPDATE_PROPERTY_PAIR(port, Port, "port", int, toInt())
-    DEFINE_UPDATE_PROPERTY_PAIR(renegSeconds, RenegSeconds, "reneg-seconds", int, toInt())
-    DEFINE_UPDATE_PROPERTY_BOOL(compLzo, CompLzo, "comp-lzo")
-    DEFINE_UPDATE_PROPERTY_BOOL(protoTcp, ProtoTcp, "proto-tcp")
+        // Advanced security properties
 
-    void updateDevType(const QStringMap& data)
-    {
-        static const QMap<QString, DevType> typeMap
-        {
-            {"tun", DevType::TUN},
-            {"tap", DevType::TAP}
-        };
+        PROPERTY(cipher),
+        PROPERTY(keysize),
+        PROPERTY(keysizeSet),
+        PROPERTY(auth),
 
-        auto it = data.constFind("dev-type");
-        bool found = (it != data.constEnd());
-        setDevTypeSet(found);
-        if (found)
-        {
-            setDevType(typeMap.value(*it, DevType::TUN));
-            setDev(data.value("dev", QString()));
-        }
-    }
-    DEFINE_UPDATE_SETTER(dev, Dev, const QString &)
-    DEFINE_UPDATE_SETTER(devType, DevType, OpenvpnConnection::DevType)
-    DEFINE_UPDATE_SETTER(devTypeSet, DevTypeSet, bool)
+        // Advanced TLS auth properties
 
-    DEFINE_UPDATE_PROPERTY_PAIR(tunnelMtu, TunnelMtu, "tunnel-mtu", int, toInt())
-    DEFINE_UPDATE_PROPERTY_PAIR(fragmentSize, FragmentSize, "fragment-size", int, toInt())
-    DEFINE_UPDATE_PROPERTY_BOOL(mssFix, MssFix, "mssfix")
-    DEFINE_UPDATE_PROPERTY_BOOL(remoteRandom, RemoteRandom, "remote-random")
+        PROPERTY(tlsRemote),
+        PROPERTY(remoteCertTls),
+        PROPERTY(remoteCertTlsSet),
+        PROPERTY(ta),
+        PROPERTY(taSet),
+        PROPERTY(taDir),
 
-    // Advanced security properties
+        // Advanced proxy settings
 
-    void updateCipher(const QStringMap& data)
-    {
-        static const QMap<QString, Cipher> typeMap
-        {
-            {"DES-CBC", Cipher::DES_CBC},
-            {"RC2-CBC", Cipher::RC2_CBC},
-            {"DES-EDE-CBC", Cipher::DES_EDE_CBC},
-            {"DES-EDE3-CBC", Cipher::DES_EDE3_CBC},
-            {"DESX-CBC", Cipher::DESX_CBC},
-            {"RC2-40-CBC", Cipher::RC2_40_CBC},
-            {"CAST5-CBC", Cipher::CAST5_CBC},
-            {"AES-128-CBC", Cipher::AES_128_CBC},
-            {"AES-192-CBC", Cipher::AES_192_CBC},
-            {"AES-256-CBC", Cipher::AES_256_CBC},
-            {"CAMELLIA-128-CBC", Cipher::CAMELLIA_128_CBC},
-            {"CAMELLIA-192-CBC", Cipher::CAMELLIA_192_CBC},
-            {"CAMELLIA-256-CBC", Cipher::CAMELLIA_256_CBC},
-            {"SEED-CBC", Cipher::SEED_CBC},
-            {"AES-128-CBC-HMAC-SHA1", Cipher::AES_128_CBC_HMAC_SHA1},
-            {"AES-256-CBC-HMAC-SHA1", Cipher::AES_256_CBC_HMAC_SHA1}
-        };
-
-        auto it = data.constFind("cipher");
-        bool found = (it != data.constEnd());
-        if (found)
-        {
-            setCipher(typeMap.value(*it, Cipher::DEFAULT_CIPHER));
-        }
-        else
-        {
-            setCipher(Cipher::DEFAULT_CIPHER);
-        }
-    }
-    DEFINE_UPDATE_SETTER(cipher, Cipher, OpenvpnConnection::Cipher)
+        PROPERTY(proxyType),
+        PROPERTY(proxyServer),
+        PROPERTY(proxyPort),
+        PROPERTY(proxyRetry),
+        PROPERTY(proxyUsername),
+        PROPERTY(proxyPassword)
+    };
 
-    DEFINE_UPDATE_PROPERTY_PAIR(keysize, Keysize, "keysize", int, toInt())
+    static_assert(vpnfields::matches(vpnfields::openvpn::FIELDS, PROPERTIES),
+                  "PROPERTIES must follow vpnfields::openvpn::FIELDS");
 
-    void updateAuth(const QStringMap& data)
+    void set(const QVariantMap& values)
     {
-        static const QMap<QString, Auth> typeMap
-        {
-            {"none", NONE},
-            {"RSA-MD4", RSA_MD4},
-            {"MD5", MD5},
-            {"SHA1", SHA1},
-            {"SHA224", SHA224},
-            {"SHA256", SHA256},
-            {"SHA384", SHA384},
-            {"SHA512", SHA512},
-            {"RIPEMD160", RIPEMD160}
-        };
-
-        auto it = data.constFind("auth");
-        bool found = (it != data.constEnd());
-        if (found)
-        {
-            setAuth(typeMap.value(*it, Auth::DEFAULT_AUTH));
-        }
-        else
+        for (const auto& property : PROPERTIES)
         {
-            setAuth(Auth::DEFAULT_AUTH);
+            auto it = values.constFind(QLatin1String(property.name));
+            if (it != values.constEnd())
+            {
+                property.set(*this, *it);
+            }
         }
     }
-    DEFINE_UPDATE_SETTER(auth, Auth, OpenvpnConnection::Auth)
 
-    // Advanced TLS auth properties
+    // The fields below depend on other keys, so decode() leaves them out
 
-    DEFINE_UPDATE_PROPERTY_STRING(tlsRemote, TlsRemote, "tls-remote")
-
-    void updateRemoteCertTls(const QStringMap& data)
+    static void decodeDevType(const QStringMap& data, QVariantMap& values)
     {
-        static const QMap<QString, TlsType> typeMap
-        {
-            {"server", TlsType::SERVER},
-            {"client", TlsType::CLIENT}
-        };
-
-        auto it = data.constFind("remote-cert-tls");
+        auto it = data.constFind("dev-type");
         bool found = (it != data.constEnd());
-        setRemoteCertTlsSet(found);
+        values["devTypeSet"] = found;
         if (found)
         {
-            setRemoteCertTls(typeMap.value(*it, TlsType::SERVER));
+            values["devType"] = vpnfields::indexOf(vpnfields::openvpn::DEV_TYPES, *it);
+            values["dev"] = data.value("dev", QString());
         }
     }
-    DEFINE_UPDATE_SETTER(remoteCertTls, RemoteCertTls, OpenvpnConnection::TlsType)
-    DEFINE_UPDATE_SETTER(remoteCertTlsSet, RemoteCertTlsSet, bool)
 
-    void updateTa(const QStringMap& data)
+    static void decodeTa(const QStringMap& data, QVariantMap& values)
     {
-        static const QMap<QString, KeyDir> typeMap
-        {
-            {"0", KeyDir::ZERO},
-            {"1", KeyDir::ONE}
-        };
-
         auto it = data.constFind("ta");
         bool found = (it != data.constEnd());
-        setTaSet(found);
+        values["taSet"] = found;
         if (found)
         {
-            setTa(*it);
-            setTaDir(typeMap.value(data.value("ta-dir"), KeyDir::KEY_NONE));
+            values["ta"] = *it;
+            values["taDir"] = vpnfields::indexOf(vpnfields::openvpn::KEY_DIRECTIONS, data.value("ta-dir"));
         }
     }
-    DEFINE_UPDATE_SETTER(ta, Ta, const QString &)
-    DEFINE_UPDATE_SETTER(taDir, TaDir, OpenvpnConnection::KeyDir)
-    DEFINE_UPDATE_SETTER(taSet, TaSet, bool)
-
-    // Advanced proxy settings
 
-    void updateProxy(const QStringMap& data)
+    static void decodeProxy(const QStringMap& data, QVariantMap& values)
     {
-        static const QMap<QString, ProxyType> typeMap
-        {
-            {"http", ProxyType::HTTP},
-            {"socks", ProxyType::SOCKS}
-        };
-
         auto it = data.constFind("proxy-type");
         bool found = (it != data.constEnd());
         if (found)
         {
-            setProxyType(typeMap.value(*it, ProxyType::NOT_REQUIRED));
-            updateProxyServer(data);
-            auto portIt = data.constFind("proxy-port");
-            if (portIt != data.constEnd())
-            {
-                setProxyPort(portIt->toInt());
-            }
-            else
-            {
-               setProxyPort(0);
-            }
-            updateProxyRetry(data);
+            int proxyType = vpnfields::indexOf(vpnfields::openvpn::PROXY_TYPES, *it);
+            values["proxyType"] = proxyType;
+            values["proxyServer"] = data.value("proxy-server");
+            values["proxyPort"] = data.value("proxy-port", "0").toInt();
+            values["proxyRetry"] = (data.value("proxy-retry") == "yes");
 
-            switch (m_data.m_proxyType)
+            switch (ProxyType(proxyType))
             {
                 case ProxyType::NOT_REQUIRED:
                     break;
                 case ProxyType::HTTP:
-                    setProxyUsername(data.value("http-proxy-username"));
+                    values["proxyUsername"] = data.value("http-proxy-username");
                     break;
                 case ProxyType::SOCKS:
-                    setProxyUsername(data.value("socks-proxy-username"));
+                    values["proxyUsername"] = data.value("socks-proxy-username");
                     break;
             }
         }
         else
         {
-            setProxyType(ProxyType::NOT_REQUIRED);
+            values["proxyType"] = int(ProxyType::NOT_REQUIRED);
         }
     }
-    DEFINE_UPDATE_SETTER(proxyType, ProxyType, OpenvpnConnection::ProxyType)
-    DEFINE_UPDATE_PROPERTY_STRING(proxyServer, ProxyServer, "proxy-server")
-    DEFINE_UPDATE_SETTER(proxyPort, ProxyPort, int)
-    DEFINE_UPDATE_PROPERTY_BOOL(proxyRetry, ProxyRetry, "proxy-retry")
-    DEFINE_UPDATE_SETTER(proxyUsername, ProxyUsername, const QString &)
-    DEFINE_UPDATE_SETTER(proxyPassword, ProxyPassword, const QString &)
-
-    void updateProxySecrets(const QStringMap& data)
+
+    void decodeProxySecrets(const QStringMap& data, QVariantMap& values) const
     {
         switch (m_data.m_proxyType)
         {
             case ProxyType::NOT_REQUIRED:
                 break;
             case ProxyType::HTTP:
-                setProxyPassword(data.value("http-proxy-password"));
+                values["proxyPassword"] = data.value("http-proxy-password");
                 break;
             case ProxyType::SOCKS:
-                setProxyPassword(data.value("socks-proxy-password"));
+                values["proxyPassword"] = data.value("socks-proxy-password");
                 break;
         }
     }
@@ -766,11 +533,22 @@ public:
 
     Data m_data;
 
+    // what m_data was decoded from, to skip the keys that didn't change
+    QStringMap m_decodedData;
+
+    QStringMap m_decodedSecrets;
+
+    bool m_dataDecoded = false;
+
+    bool m_secretsDecoded = false;
+
     Data m_pendingData;
 
     bool m_dirty = false;
 };
 
+constexpr OpenvpnConnection::Priv::Property OpenvpnConnection::Priv::PROPERTIES[];
+
 OpenvpnConnection::OpenvpnConnection() :
         d(new Priv(*this))
 {
@@ -782,53 +560,26 @@ OpenvpnConnection::~OpenvpnConnection()
 
 void OpenvpnConnection::updateData(const QStringMap& data)
 {
-    // Basic properties
-
-    d->updateCa(data);
-    d->updateCert(data);
-    d->updateConnectionType(data);
-    d->updateKey(data);
-    d->updateLocalIp(data);
-    d->updateRemote(data);
-    d->updateRemoteIp(data);
-    d->updateStaticKey(data);
-    d->updateStaticKeyDirection(data);
-    d->updateUsername(data);
-
-    // Advanced general properties
-
-    d->updatePort(data);
-    d->updateRenegSeconds(data);
-    d->updateCompLzo(data);
-    d->updateProtoTcp(data);
-    d->updateDevType(data);
-    d->updateTunnelMtu(data);
-    d->updateFragmentSize(data);
-    d->updateMssFix(data);
-    d->updateRemoteRandom(data);
-
-    // Advanced security properties
-
-    d->updateCipher(data);
-    d->updateKeysize(data);
-    d->updateAuth(data);
-
-    // Advanced TLS auth properties
-
-    d->updateTlsRemote(data);
-    d->updateRemoteCertTls(data);
-    d->updateTa(data);
-
-    // Advanced proxy settings
-
-    d->updateProxy(data);
+    auto values = vpnfields::decode(vpnfields::openvpn::FIELDS, false, data,
+                                    d->m_dataDecoded ? &d->m_decodedData : nullptr);
+    Priv::decodeDevType(data, values);
+    Priv::decodeTa(data, values);
+    Priv::decodeProxy(data, values);
+    d->set(values);
+
+    d->m_decodedData = data;
+    d->m_dataDecoded = true;
 }
 
 void OpenvpnConnection::updateSecrets(const QStringMap& secrets)
 {
-    d->updateCertPass(secrets);
-    d->updatePassword(secrets);
-    d->updateProxySecrets(secrets);
+    auto values = vpnfields::decode(vpnfields::openvpn::FIELDS, true, secrets,
+                                    d->m_secretsDecoded ? &d->m_decodedSecrets : nullptr);
+    d->decodeProxySecrets(secrets, values);
+    d->set(values);
+
+    d->m_decodedSecrets = secrets;
+    d->m_secretsDecoded = true;
 }
 
 void OpenvpnConnection::markClean()
@@ -836,6 +587,16 @@ void OpenvpnConnection::markClean()
     d->m_dirty = false;
 }
 
+QStringMap OpenvpnConnection::pendingVpnData() const
+{
+    return (d->m_dirty ? d->m_pendingData : d->m_data).buildData();
+}
+
+QStringMap OpenvpnConnection::pendingVpnSecrets() const
+{
+    return (d->m_dirty ? d->m_pendingData : d->m_data).buildSecrets();
+}
+
 // Basic properties
 
 DEFINE_PROPERTY_GETTER(ca, QString)
@@ -20,52 +20,10 @@
 #include <nmofono/vpn/pptp-connection.h>
 
 #include <NetworkManagerSettingsConnectionInterface.h>
+#include <vpn-fields.h>
 
 using namespace std;
 
-#define DEFINE_UPDATE_SETTER(name, uppername, type)\
-void set##uppername(type value)\
-{\
-    if (m_data.m_##name == value)\
-    {\
-        return;\
-    }\
-    m_data.m_##name = value;\
-    Q_EMIT p.name##Changed(m_data.m_##name);\
-}
-
-#define DEFINE_UPDATE_PROPERTY_STRING(name, uppername, strname) \
-void update##uppername(const QStringMap& data)\
-{\
-    set##uppername(data.value(strname));\
-}\
-\
-DEFINE_UPDATE_SETTER(name, uppername, const QString &)
-
-#define DEFINE_UPDATE_PROPERTY_ANTIBOOL(name, uppername, strname) \
-void update##uppername(const QStringMap& data)\
-{\
-    set##uppername(data.value(strname) != "yes");\
-}\
-\
-DEFINE_UPDATE_SETTER(name, uppername, bool)
-
-#define DEFINE_UPDATE_PROPERTY_PAIR(name, uppername, strname, type, conversion)\
-void update##uppername(const QStringMap& data)\
-{\
-    auto it = data.constFind(strname);\
-    bool found = (it != data.constEnd());\
-    set##uppername##Set(found);\
-    if (found)\
-    {\
-        set##uppername(it->conversion);\
-    }\
-}\
-\
-DEFINE_UPDATE_SETTER(name, uppername, type)\
-\
-DEFINE_UPDATE_SETTER(name##Set, uppername##Set, bool)\
-
 #define DEFINE_PROPERTY_GETTER(name,type) \
 type PptpConnection::name() const\
 {\
@@ -85,7 +43,7 @@ void PptpConnection::set##uppername(type value)\
     }\
     d->m_dirty = true;\
     d->m_pendingData.m_##varname = value;\
-    Q_EMIT updateVpnData(d->m_pendingData.buildData());\
+    Q_EMIT vpnDataEdited();\
 }
 
 #define DEFINE_SECRET_PROPERTY_SETTER(varname, uppername, type) \
@@ -101,9 +59,15 @@ void PptpConnection::set##uppername(type value)\
     }\
     d->m_dirty = true;\
     d->m_pendingData.m_##varname = value;\
-    Q_EMIT updateVpnSecrets(d->m_pendingData.buildSecrets());\
+    Q_EMIT vpnSecretsEdited();\
 }
 
+#define PROPERTY(name) \
+    {#name,\
+     &Priv::setProperty<decltype(Data::m_##name), &Data::m_##name,\
+                        decltype(&PptpConnection::name##Changed), &PptpConnection::name##Changed>,\
+     &Priv::copyProperty<decltype(Data::m_##name), &Data::m_##name>}
+
 namespace nmofono
 {
 namespace vpn
@@ -122,32 +86,14 @@ public:
 
         Data& operator=(const Data& other)
         {
-            // Basic properties
-
-            m_gateway = other.m_gateway;
-            m_user = other.m_user;
-            m_password = other.m_password;
-            m_domain = other.m_domain;
-
-            // Advanced properties
-
-            m_allowPap = other.m_allowPap;
-            m_allowChap = other.m_allowChap;
-            m_allowMschap = other.m_allowMschap;
-            m_allowMschapv2 = other.m_allowMschapv2;
-            m_allowEap = other.m_allowEap;
-            m_requireMppe = other.m_requireMppe;
-            m_mppeType = other.m_mppeType;
-            m_mppeStateful = other.m_mppeStateful;
-            m_bsdCompression = other.m_bsdCompression;
-            m_deflateCompression = other.m_deflateCompression;
-            m_tcpHeaderCompression = other.m_tcpHeaderCompression;
-            m_sendPppEchoPackets = other.m_sendPppEchoPackets;
-
+            for (const auto& property : PROPERTIES)
+            {
+                property.copy(*this, other);
+            }
             return *this;
         }
 
-        QStringMap buildSecrets()
+        QStringMap buildSecrets() const
         {
             QStringMap secrets;
 
@@ -159,7 +105,7 @@ public:
             return secrets;
         }
 
-        QStringMap buildData()
+        QStringMap buildData() const
         {
             QStringMap data;
 
@@ -176,13 +122,6 @@ public:
 
             // Advanced properties
 
-            static const QMap<MppeType, QString> mppeTypeMap
-            {
-                {MppeType::MPPE_ALL, "require-mppe"},
-                {MppeType::MPPE_128, "require-mppe-128"},
-                {MppeType::MPPE_40, "require-mppe-40"},
-            };
-
             if (!m_requireMppe)
             {
                 if (!m_allowPap)
@@ -212,7 +151,7 @@ public:
 
             if ((m_allowMschap || m_allowMschapv2) && m_requireMppe)
             {
-                data[mppeTypeMap[m_mppeType]] = "yes";
+                data[vpnfields::pptp::MPPE_TYPES[int(m_mppeType)]] = "yes";
                 if (m_mppeStateful)
                 {
                     data["mppe-stateful"] = "yes";
@@ -269,81 +208,116 @@ public:
     {
     }
 
-    // Basic properties
-
-    DEFINE_UPDATE_PROPERTY_STRING(gateway, Gateway, "gateway")
-    DEFINE_UPDATE_PROPERTY_STRING(user, User, "user")
-    DEFINE_UPDATE_PROPERTY_STRING(password, Password, "password")
-    DEFINE_UPDATE_PROPERTY_STRING(domain, Domain, "domain")
+    struct Property
+    {
+        // a vpnfields::pptp::FIELDS name
+        const char* name;
 
-    // Advanced properties
+        void (*set)(Priv& priv, const QVariant& value);
 
-    DEFINE_UPDATE_PROPERTY_ANTIBOOL(allowPap, AllowPap, "refuse-pap")
-    DEFINE_UPDATE_PROPERTY_ANTIBOOL(allowChap, AllowChap, "refuse-chap")
-    DEFINE_UPDATE_PROPERTY_ANTIBOOL(allowMschap, AllowMschap, "refuse-mschap")
-    DEFINE_UPDATE_PROPERTY_ANTIBOOL(allowMschapv2, AllowMschapv2, "refuse-mschapv2")
-    DEFINE_UPDATE_PROPERTY_ANTIBOOL(allowEap, AllowEap, "refuse-eap")
+        void (*copy)(Data& data, const Data& other);
+    };
 
-    void updateMppe(const QStringMap& data)
+    template<typename T, T Data::* member, typename Signal, Signal changed>
+    static void setProperty(Priv& priv, const QVariant& value)
     {
-        bool requireMppe = false;
-        MppeType mppeType = MppeType::MPPE_ALL;
-
-        QString tmp = data.value("require-mppe");
-        if (tmp == "yes")
+        T v = vpnfields::fromVariant<T>(value);
+        if (priv.m_data.*member == v)
         {
-            requireMppe = true;
-            mppeType = MppeType::MPPE_ALL;
+            return;
         }
-        else
+        priv.m_data.*member = v;
+        Q_EMIT (priv.p.*changed)(priv.m_data.*member);
+    }
+
+    template<typename T, T Data::* member>
+    static void copyProperty(Data& data, const Data& other)
+    {
+        data.*member = other.*member;
+    }
+
+    static constexpr Property PROPERTIES[] =
+    {
+        // Basic properties
+
+        PROPERTY(gateway),
+        PROPERTY(user),
+        PROPERTY(password),
+        PROPERTY(domain),
+
+        // Advanced properties
+
+        PROPERTY(allowPap),
+        PROPERTY(allowChap),
+        PROPERTY(allowMschap),
+        PROPERTY(allowMschapv2),
+        PROPERTY(allowEap),
+        PROPERTY(requireMppe),
+        PROPERTY(mppeType),
+        PROPERTY(mppeStateful),
+        PROPERTY(bsdCompression),
+        PROPERTY(deflateCompression),
+        PROPERTY(tcpHeaderCompression),
+        PROPERTY(sendPppEchoPackets)
+    };
+
+    static_assert(vpnfields::matches(vpnfields::pptp::FIELDS, PROPERTIES),
+                  "PROPERTIES must follow vpnfields::pptp::FIELDS");
+
+    void set(const QVariantMap& values)
+    {
+        for (const auto& property : PROPERTIES)
         {
-            tmp = data.value("require-mppe-128");
-            if (tmp == "yes")
-            {
-                requireMppe = true;
-                mppeType = MppeType::MPPE_128;
-            }
-            else
+            auto it = values.constFind(QLatin1String(property.name));
+            if (it != values.constEnd())
             {
-                tmp = data.value("require-mppe-40");
-                if (tmp == "yes")
-                {
-                    requireMppe = true;
-                    mppeType = MppeType::MPPE_40;
-                }
+                property.set(*this, *it);
             }
         }
+    }
+
+    // The fields below depend on more than one key, so decode() leaves them out
 
-        setRequireMppe(requireMppe);
-        if (requireMppe)
+    static void decodeMppe(const QStringMap& data, QVariantMap& values)
+    {
+        // the first of the require-mppe* keys that is set
+        for (int i = 0; vpnfields::pptp::MPPE_TYPES[i]; ++i)
         {
-            setMppeType(mppeType);
+            if (data.value(vpnfields::pptp::MPPE_TYPES[i]) == "yes")
+            {
+                values["requireMppe"] = true;
+                values["mppeType"] = i;
+                return;
+            }
         }
-        setMppeStateful(data.value("mppe-stateful") == "yes");
+        values["requireMppe"] = false;
     }
-    DEFINE_UPDATE_SETTER(requireMppe, RequireMppe, bool)
-    DEFINE_UPDATE_SETTER(mppeType, MppeType, PptpConnection::MppeType)
-    DEFINE_UPDATE_SETTER(mppeStateful, MppeStateful, bool)
-
-    DEFINE_UPDATE_PROPERTY_ANTIBOOL(bsdCompression, BsdCompression, "nobsdcomp")
-    DEFINE_UPDATE_PROPERTY_ANTIBOOL(deflateCompression, DeflateCompression, "nodeflate")
-    DEFINE_UPDATE_PROPERTY_ANTIBOOL(tcpHeaderCompression, TcpHeaderCompression, "no-vj-comp")
 
-    void updateSendPppEchoPackets(const QStringMap& data)
+    static void decodeSendPppEchoPackets(const QStringMap& data, QVariantMap& values)
     {
-        setSendPppEchoPackets(data.contains("lcp-echo-interval") || data.contains("lcp-echo-failure"));
+        values["sendPppEchoPackets"] = (data.contains("lcp-echo-interval") || data.contains("lcp-echo-failure"));
     }
-    DEFINE_UPDATE_SETTER(sendPppEchoPackets, SendPppEchoPackets, bool)
 
     PptpConnection& p;
 
     Data m_data;
 
+    // what m_data was decoded from, to skip the keys that didn't change
+    QStringMap m_decodedData;
+
+    QStringMap m_decodedSecrets;
+
+    bool m_dataDecoded = false;
+
+    bool m_secretsDecoded = false;
+
     Data m_pendingData;
 
     bool m_dirty = false;
 };
 
+constexpr PptpConnection::Priv::Property PptpConnection::Priv::PROPERTIES[];
+
 PptpConnection::PptpConnection() :
         d(new Priv(*this))
 {
@@ -355,30 +329,23 @@ PptpConnection::~PptpConnection()
 
 void PptpConnection::updateData(const QStringMap& data)
 {
-    // Basic properties
-
-    d->updateGateway(data);
-    d->updateUser(data);
-    d->updateDomain(data);
-
-    // Advanced properties
-
-    d->updateAllowPap(data);
-    d->updateAllowChap(data);
-    d->updateAllowMschap(data);
-    d->updateAllowMschapv2(data);
-    d->updateAllowEap(data);
-    d->updateMppe(data);
-    d->updateBsdCompression(data);
-    d->updateDeflateCompression(data);
-    d->updateTcpHeaderCompression(data);
-    d->updateSendPppEchoPackets(data);
-
+    auto values = vpnfields::decode(vpnfields::pptp::FIELDS, false, data,
+                                    d->m_dataDecoded ? &d->m_decodedData : nullptr);
+    Priv::decodeMppe(data, values);
+    Priv::decodeSendPppEchoPackets(data, values);
+    d->set(values);
+
+    d->m_decodedData = data;
+    d->m_dataDecoded = true;
 }
 
 void PptpConnection::updateSecrets(const QStringMap& secrets)
 {
-    d->updatePassword(secrets);
+    d->set(vpnfields::decode(vpnfields::pptp::FIELDS, true, secrets,
+                             d->m_secretsDecoded ? &d->m_decodedSecrets : nullptr));
+
+    d->m_decodedSecrets = secrets;
+    d->m_secretsDecoded = true;
 }
 
 void PptpConnection::markClean()
@@ -386,6 +353,16 @@ void PptpConnection::markClean()
     d->m_dirty = false;
 }
 
+QStringMap PptpConnection::pendingVpnData() const
+{
+    return (d->m_dirty ? d->m_pendingData : d->m_data).buildData();
+}
+
+QStringMap PptpConnection::pendingVpnSecrets() const
+{
+    return (d->m_dirty ? d->m_pendingData : d->m_data).buildSecrets();
+}
+
 // Basic properties
 
 DEFINE_PROPERTY_GETTER(gateway, QString)
@@ -49,6 +49,12 @@ public:
 
     ~PptpConnection();
 
+    // The vpn.data and vpn.secrets maps including any unsaved edits. These
+    // are only built when the settings are written, not on every edit.
+    QMap<QString, QString> pendingVpnData() const;
+
+    QMap<QString, QString> pendingVpnSecrets() const;
+
     // Basic properties
 
     Q_PROPERTY(QString gateway READ gateway WRITE setGateway NOTIFY gatewayChanged)
@@ -145,9 +151,11 @@ public Q_SLOTS:
     void setSendPppEchoPackets(bool value);
 
 Q_SIGNALS:
-    void updateVpnData(const QMap<QString, QString>& vpnData);
+    // a setter changed vpn.data, see pendingVpnData()
+    void vpnDataEdited();
 
-    void updateVpnSecrets(const QMap<QString, QString>& vpnSecrets);
+    // a setter changed vpn.secrets, see pendingVpnSecrets()
+    void vpnSecretsEdited();
 
     // Basic properties
 
@@ -20,8 +20,12 @@
 #include <NetworkManager.h>
 
 #include <nmofono/vpn/vpn-connection.h>
+#include <nmofono/proxy-registry.h>
 #include <NetworkManagerSettingsConnectionInterface.h>
 
+#include <QDBusPendingCallWatcher>
+#include <QElapsedTimer>
+
 using namespace std;
 
 namespace nmofono
@@ -32,6 +36,15 @@ using namespace connection;
 namespace vpn
 {
 
+namespace
+{
+// Edits arriving closer together than this are written with one Update
+static const int PENDING_SETTINGS_DELAY = 200;
+
+// ... but a steady stream of edits doesn't hold them back for longer than this
+static const int MAX_PENDING_SETTINGS_DELAY = 1000;
+}
+
 class VpnConnection::Priv: public QObject
 {
     Q_OBJECT
@@ -183,15 +196,66 @@ public:
 
     void setDirty()
     {
-        if (m_dirty)
+        if (!m_dirty)
         {
-            return;
+            m_dirty = true;
+            m_pendingSettings = m_settings;
+            m_pendingSince.start();
+        }
+
+        if (m_pendingSince.elapsed() < MAX_PENDING_SETTINGS_DELAY)
+        {
+            m_dispatchPendingSettingsTimer.start();
+        }
+    }
+
+    QStringMap pendingVpnData() const
+    {
+        switch (m_type)
+        {
+            case Type::openvpn:
+                return m_openvpnConnection->pendingVpnData();
+            case Type::pptp:
+                return m_pptpConnection->pendingVpnData();
+        }
+        return QStringMap();
+    }
+
+    QStringMap pendingVpnSecrets() const
+    {
+        switch (m_type)
+        {
+            case Type::openvpn:
+                return m_openvpnConnection->pendingVpnSecrets();
+            case Type::pptp:
+                return m_pptpConnection->pendingVpnSecrets();
+        }
+        return QStringMap();
+    }
+
+    void applySettings(const QVariantDictMap& settings)
+    {
+        m_settings = settings;
+
+        QStringMap vpnData;
+        // Encourage Qt to decode the nested map
+        auto v = m_settings.value("vpn").value("data");
+        if (v.isValid())
+        {
+            auto dbusArgument = qvariant_cast<QDBusArgument>(v);
+            dbusArgument >> vpnData;
+            m_settings["vpn"]["data"] = QVariant::fromValue(vpnData);
         }
 
-        m_dirty = true;
-        m_pendingSettings = m_settings;
+        updateId();
+        updateNeverDefault();
+        updateValid();
+        updateType();
 
-        m_dispatchPendingSettingsTimer.start();
+        if (m_valid)
+        {
+            Q_EMIT updateData(vpnData);
+        }
     }
 
 Q_SIGNALS:
@@ -202,39 +266,86 @@ Q_SIGNALS:
 public Q_SLOTS:
     void dispatchPendingSettings()
     {
-        auto reply = m_connection->Update(m_pendingSettings);
-        reply.waitForFinished();
-        if (reply.isError())
+        // Only one Update at a time, the edits made in the meantime are
+        // picked up when it finishes
+        if (m_updateWatcher)
         {
-            qWarning() << reply.error().message() << m_pendingSettings;
+            return;
+        }
+
+        if (m_vpnDataEdited)
+        {
+            m_pendingSettings["vpn"]["data"] = QVariant::fromValue(pendingVpnData());
+        }
+        if (m_vpnSecretsEdited)
+        {
+            m_pendingSettings["vpn"]["secrets"] = QVariant::fromValue(pendingVpnSecrets());
         }
 
         m_dirty = false;
+        m_vpnDataEdited = false;
+        m_vpnSecretsEdited = false;
 
-        Q_EMIT settingsDispatched();
+        m_updateWatcher = new QDBusPendingCallWatcher(m_connection->Update(m_pendingSettings), this);
+        connect(m_updateWatcher, &QDBusPendingCallWatcher::finished, this, &Priv::settingsDispatchFinished);
     }
 
-    void updateVpnData(const QStringMap &vpnData)
+    void settingsDispatchFinished(QDBusPendingCallWatcher *call)
+    {
+        QDBusPendingReply<> reply = *call;
+        bool success = !reply.isError();
+        if (!success)
+        {
+            qWarning() << reply.error().message();
+        }
+
+        call->deleteLater();
+        m_updateWatcher = nullptr;
+
+        Q_EMIT p.settingsWritten(success);
+
+        if (m_dirty)
+        {
+            m_dispatchPendingSettingsTimer.start();
+        }
+        else
+        {
+            // The editors keep their pending values until the written
+            // settings have been read back
+            m_markCleanAfterLoad = true;
+            settingsUpdated();
+        }
+    }
+
+    void vpnDataEdited()
     {
         setDirty();
-        m_pendingSettings["vpn"]["data"] = QVariant::fromValue(vpnData);
+        m_vpnDataEdited = true;
     }
 
-    void updateVpnSecrets(const QStringMap &secrets)
+    void vpnSecretsEdited()
     {
         setDirty();
-        m_pendingSettings["vpn"]["secrets"] = QVariant::fromValue(secrets);
+        m_vpnSecretsEdited = true;
     }
 
     void secretsUpdated()
     {
-        if (!m_valid)
+        if (!m_valid || m_secretsWatcher)
         {
             return;
         }
 
-        auto reply = m_connection->GetSecrets("vpn");
-        reply.waitForFinished();
+        m_secretsWatcher = new QDBusPendingCallWatcher(m_connection->GetSecrets("vpn"), this);
+        connect(m_secretsWatcher, &QDBusPendingCallWatcher::finished, this, &Priv::secretsLoaded);
+    }
+
+    void secretsLoaded(QDBusPendingCallWatcher *call)
+    {
+        QDBusPendingReply<QVariantDictMap> reply = *call;
+        call->deleteLater();
+        m_secretsWatcher = nullptr;
+
         if (reply.isError())
         {
             qWarning() << reply.error().message();
@@ -256,62 +367,67 @@ public Q_SLOTS:
 
     void settingsUpdated()
     {
-        auto reply = m_connection->GetSettings();
-
-        reply.waitForFinished();
-        if (reply.isError())
+        // A reply already on its way may predate the change, so ask again
+        // once it arrives
+        if (m_settingsWatcher)
         {
-            qWarning() << reply.error().message();
+            m_reloadSettings = true;
             return;
         }
 
-        m_settings = reply;
+        m_settingsWatcher = new QDBusPendingCallWatcher(m_connection->GetSettings(), this);
+        connect(m_settingsWatcher, &QDBusPendingCallWatcher::finished, this, &Priv::settingsLoaded);
+    }
 
-        QStringMap vpnData;
-        // Encourage Qt to decode the nested map
-        auto v = m_settings.value("vpn").value("data");
-        if (v.isValid())
+    void settingsLoaded(QDBusPendingCallWatcher *call)
+    {
+        QDBusPendingReply<QVariantDictMap> reply = *call;
+        call->deleteLater();
+        m_settingsWatcher = nullptr;
+
+        if (reply.isError())
         {
-            auto dbusArgument = qvariant_cast<QDBusArgument>(v);
-            dbusArgument >> vpnData;
-            m_settings["vpn"]["data"] = QVariant::fromValue(vpnData);
+            qWarning() << reply.error().message();
+        }
+        else
+        {
+            applySettings(reply);
         }
 
-        updateId();
-        updateNeverDefault();
-        updateValid();
-        updateType();
+        if (m_reloadSettings)
+        {
+            m_reloadSettings = false;
+            settingsUpdated();
+            return;
+        }
 
-        if (m_valid)
+        if (m_markCleanAfterLoad && !m_dirty && !m_updateWatcher)
         {
-            Q_EMIT updateData(vpnData);
+            m_markCleanAfterLoad = false;
+            Q_EMIT settingsDispatched();
         }
     }
 
-    void activeConnectionsUpdated(const QSet<connection::ActiveConnection::SPtr>& activeConnections)
+    void activeConnectionUpdated()
     {
-        connection::ActiveConnection::SPtr activeConnection;
-
-        QDBusObjectPath path(m_connection->path());
-
-        // Search for the active connection
-        for (const auto& con : activeConnections)
+        auto activeConnection = m_activeConnectionManager->activeConnection(QDBusObjectPath(m_connection->path()));
+        if (activeConnection != m_activeConnection)
         {
-            // Connection to all signals on all active connections
-            connect(con.get(), &connection::ActiveConnection::connectionPathChanged, this, &Priv::connectionUpdated);
-            connect(con.get(), &connection::ActiveConnection::stateChanged, this, &Priv::connectionUpdated);
-            connect(con.get(), &connection::ActiveConnection::typeChanged, this, &Priv::connectionUpdated);
-
-            if (con->connectionPath() == path)
+            if (m_activeConnection)
             {
-                activeConnection = con;
-                break;
+                m_activeConnection->disconnect(this);
+            }
+            m_activeConnection = activeConnection;
+            if (m_activeConnection)
+            {
+                connect(m_activeConnection.get(), &connection::ActiveConnection::stateChanged, this, &Priv::connectionUpdated);
+                connect(m_activeConnection.get(), &connection::ActiveConnection::typeChanged, this, &Priv::connectionUpdated);
             }
         }
 
-        if (activeConnection)
+        if (m_activeConnection)
         {
-            _connectionUpdated(*activeConnection);
+            _connectionUpdated(*m_activeConnection);
         }
         else
         {
@@ -323,8 +439,7 @@ public Q_SLOTS:
 
     void connectionUpdated()
     {
-        auto activeConnection = qobject_cast<connection::ActiveConnection*>(sender());
-        _connectionUpdated(*activeConnection);
+        _connectionUpdated(*m_activeConnection);
     }
 
 public:
@@ -334,14 +449,32 @@ public:
 
     connection::ActiveConnectionManager::SPtr m_activeConnectionManager;
 
+    connection::ActiveConnection::SPtr m_activeConnection;
+
     QVariantDictMap m_settings;
 
     bool m_dirty = false;
 
+    bool m_vpnDataEdited = false;
+
+    bool m_vpnSecretsEdited = false;
+
+    bool m_markCleanAfterLoad = false;
+
+    bool m_reloadSettings = false;
+
     QVariantDictMap m_pendingSettings;
 
     QTimer m_dispatchPendingSettingsTimer;
 
+    QElapsedTimer m_pendingSince;
+
+    QDBusPendingCallWatcher* m_updateWatcher = nullptr;
+
+    QDBusPendingCallWatcher* m_settingsWatcher = nullptr;
+
+    QDBusPendingCallWatcher* m_secretsWatcher = nullptr;
+
     QString m_uuid;
 
     QString m_id;
@@ -371,20 +504,22 @@ public:
 
 VpnConnection::VpnConnection(
         const QDBusObjectPath& path,
+        const QVariantDictMap& settings,
         connection::ActiveConnectionManager::SPtr activeConnectionManager,
         const QDBusConnection& systemConnection) :
         d(new Priv(*this))
 {
     d->m_dispatchPendingSettingsTimer.setSingleShot(true);
-    d->m_dispatchPendingSettingsTimer.setInterval(200);
+    d->m_dispatchPendingSettingsTimer.setInterval(PENDING_SETTINGS_DELAY);
     d->m_dispatchPendingSettingsTimer.setTimerType(Qt::CoarseTimer);
     connect(&d->m_dispatchPendingSettingsTimer, &QTimer::timeout, d.get(), &Priv::dispatchPendingSettings);
 
-    d->m_connection = make_shared<OrgFreedesktopNetworkManagerSettingsConnectionInterface>(NM_DBUS_SERVICE, path.path(), systemConnection);
+    d->m_connection = ProxyRegistry::get<OrgFreedesktopNetworkManagerSettingsConnectionInterface>(NM_DBUS_SERVICE, path.path(), systemConnection);
 
     d->m_activeConnectionManager = activeConnectionManager;
 
-    d->settingsUpdated();
+    // VpnManager has fetched them to tell whether this is a VPN connection
+    d->applySettings(settings);
     d->updateUuid();
     connect(d->m_connection.get(), &OrgFreedesktopNetworkManagerSettingsConnectionInterface::Updated, d.get(), &Priv::settingsUpdated);
 
@@ -393,8 +528,7 @@ VpnConnection::VpnConnection(
         return;
     }
 
-    d->activeConnectionsUpdated(d->m_activeConnectionManager->connections());
-    connect(d->m_activeConnectionManager.get(), &connection::ActiveConnectionManager::connectionsChanged, d.get(), &Priv::activeConnectionsUpdated);
+    d->activeConnectionUpdated();
 
     switch (d->m_type)
     {
@@ -404,8 +538,8 @@ VpnConnection::VpnConnection(
             connect(d.get(), &Priv::updateData, d->m_openvpnConnection.get(), &OpenvpnConnection::updateData);
             connect(d.get(), &Priv::updateSecrets, d->m_openvpnConnection.get(), &OpenvpnConnection::updateSecrets);
             connect(d.get(), &Priv::settingsDispatched, d->m_openvpnConnection.get(), &OpenvpnConnection::markClean);
-            connect(d->m_openvpnConnection.get(), &OpenvpnConnection::updateVpnData, d.get(), &Priv::updateVpnData);
-            connect(d->m_openvpnConnection.get(), &OpenvpnConnection::updateVpnSecrets, d.get(), &Priv::updateVpnSecrets);
+            connect(d->m_openvpnConnection.get(), &OpenvpnConnection::vpnDataEdited, d.get(), &Priv::vpnDataEdited);
+            connect(d->m_openvpnConnection.get(), &OpenvpnConnection::vpnSecretsEdited, d.get(), &Priv::vpnSecretsEdited);
             break;
         case Type::pptp:
             d->m_pptpConnection = make_shared<PptpConnection>();
@@ -413,8 +547,8 @@ VpnConnection::VpnConnection(
             connect(d.get(), &Priv::updateData, d->m_pptpConnection.get(), &PptpConnection::updateData);
             connect(d.get(), &Priv::updateSecrets, d->m_pptpConnection.get(), &PptpConnection::updateSecrets);
             connect(d.get(), &Priv::settingsDispatched, d->m_pptpConnection.get(), &PptpConnection::markClean);
-            connect(d->m_pptpConnection.get(), &PptpConnection::updateVpnData, d.get(), &Priv::updateVpnData);
-            connect(d->m_pptpConnection.get(), &PptpConnection::updateVpnSecrets, d.get(), &Priv::updateVpnSecrets);
+            connect(d->m_pptpConnection.get(), &PptpConnection::vpnDataEdited, d.get(), &Priv::vpnDataEdited);
+            connect(d->m_pptpConnection.get(), &PptpConnection::vpnSecretsEdited, d.get(), &Priv::vpnSecretsEdited);
             break;
         default:
             break;
@@ -496,6 +630,11 @@ void VpnConnection::setActiveConnectionPath(const QDBusObjectPath& path)
     d->updateActivatable();
 }
 
+void VpnConnection::updateActiveConnection()
+{
+    d->activeConnectionUpdated();
+}
+
 void VpnConnection::updateSecrets()
 {
     d->secretsUpdated();
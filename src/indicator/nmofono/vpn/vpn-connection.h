@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <dbus-types.h>
 #include <QDBusConnection>
 #include <QDBusObjectPath>
 #include <QObject>
@@ -49,7 +50,8 @@ public:
         pptp
     };
 
-    VpnConnection(const QDBusObjectPath& path, connection::ActiveConnectionManager::SPtr activeConnectionManager, const QDBusConnection& systemConnection);
+    /// settings are the ones GetSettings returned for the connection at path
+    VpnConnection(const QDBusObjectPath& path, const QVariantDictMap& settings, connection::ActiveConnectionManager::SPtr activeConnectionManager, const QDBusConnection& systemConnection);
 
     ~VpnConnection() = default;
 
@@ -86,6 +88,9 @@ public Q_SLOTS:
 
     void setActiveConnectionPath(const QDBusObjectPath& path);
 
+    // re-read this connection's entry in ActiveConnectionManager's index
+    void updateActiveConnection();
+
     void updateSecrets();
 
     void remove();
@@ -107,6 +112,9 @@ Q_SIGNALS:
 
     void deactivateConnection(const QDBusObjectPath& activeConnection);
 
+    // a batch of edited settings has been sent to NetworkManager
+    void settingsWritten(bool success);
+
 protected:
     class Priv;
     std::shared_ptr<Priv> d;
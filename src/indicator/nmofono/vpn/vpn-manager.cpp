@@ -18,8 +18,12 @@
  */
 
 #include <nmofono/vpn/vpn-manager.h>
+#include <nmofono/proxy-registry.h>
 #include <util/localisation.h>
+#include <util/startup-timer.h>
 #include <NetworkManager.h>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
 #include <QMap>
 
 #include <NetworkManagerInterface.h>
@@ -42,9 +46,64 @@ public:
     {
     }
 
-    void _newConnection(const QDBusObjectPath &path, bool shouldUpdateActiveAndBusy)
+    /**
+     * Fetches the settings of a connection without waiting for them, it is
+     * only added once they show it to be a VPN connection.
+     */
+    void load(const QDBusObjectPath &path)
     {
-        auto connection = make_shared<VpnConnection>(path, m_activeConnectionManager, m_settingsInterface->connection());
+        auto message = QDBusMessage::createMethodCall(NM_DBUS_SERVICE,
+                                                      path.path(),
+                                                      NM_DBUS_INTERFACE_SETTINGS_CONNECTION,
+                                                      "GetSettings");
+        auto watcher(new QDBusPendingCallWatcher(m_settingsInterface->connection().asyncCall(message), this));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, path](QDBusPendingCallWatcher *call) {
+            loaded(path, call);
+        });
+        // a newer request supersedes the one in flight
+        m_loading.insert(path, watcher);
+    }
+
+    void loaded(const QDBusObjectPath &path, QDBusPendingCallWatcher *call)
+    {
+        call->deleteLater();
+
+        // removed while we were waiting for the settings
+        if (m_loading.value(path) != call)
+        {
+            return;
+        }
+        m_loading.remove(path);
+
+        QDBusPendingReply<QVariantDictMap> reply = *call;
+        if (reply.isError())
+        {
+            qWarning() << "Failed to get settings of connection" << path.path() << ":" << reply.error().message();
+        }
+        else if (!m_connections.contains(path))
+        {
+            _newConnection(path, reply.value());
+        }
+
+        checkReady();
+    }
+
+    void checkReady()
+    {
+        if (m_ready || !m_listed || !m_loading.isEmpty()
+                || !m_activeConnectionManager->isReady())
+        {
+            return;
+        }
+
+        m_ready = true;
+        util::startup::end("nm-vpn-connections");
+        Q_EMIT p.ready();
+    }
+
+    void _newConnection(const QDBusObjectPath &path, const QVariantDictMap &settings)
+    {
+        auto connection = make_shared<VpnConnection>(path, settings, m_activeConnectionManager, m_settingsInterface->connection());
         if (connection->isValid())
         {
             m_connections[path] = connection;
@@ -52,15 +111,36 @@ public:
             connection->setActiveConnectionPath(m_activeConnectionPath);
             connect(connection.get(), &VpnConnection::activateConnection, this, &Priv::activateConnection);
             connect(connection.get(), &VpnConnection::deactivateConnection, m_nmInterface.get(), &OrgFreedesktopNetworkManagerInterface::DeactivateConnection);
-            connect(connection.get(), &VpnConnection::activeChanged, this, &Priv::updateActiveAndBusy);
-            connect(connection.get(), &VpnConnection::busyChanged, this, &Priv::updateActiveAndBusy);
+            connect(connection.get(), &VpnConnection::activeChanged, this, &Priv::connectionStateChanged);
+            connect(connection.get(), &VpnConnection::busyChanged, this, &Priv::connectionStateChanged);
             connect(this, &Priv::busyChanged, connection.get(), &VpnConnection::setOtherConnectionIsBusy);
             connect(this, &Priv::activeConnectionPathChanged, connection.get(), &VpnConnection::setActiveConnectionPath);
+            updateConnectionState(*connection);
             Q_EMIT p.connectionsChanged();
-            if (shouldUpdateActiveAndBusy)
-            {
-                updateActiveAndBusy();
-            }
+            updateActiveAndBusy();
+        }
+    }
+
+    void updateConnectionState(const VpnConnection& connection)
+    {
+        auto path = connection.path();
+
+        if (connection.isBusy())
+        {
+            m_busyConnections.insert(path);
+        }
+        else
+        {
+            m_busyConnections.remove(path);
+        }
+
+        if (connection.isActive())
+        {
+            m_activeConnections.insert(path);
+        }
+        else
+        {
+            m_activeConnections.remove(path);
         }
     }
 
@@ -97,17 +177,63 @@ Q_SIGNALS:
 public Q_SLOTS:
     void connectionRemoved(const QDBusObjectPath &path)
     {
+        if (m_loading.remove(path))
+        {
+            checkReady();
+        }
+
         auto connection = m_connections.take(path);
         if (connection)
         {
+            m_busyConnections.remove(path);
+            m_activeConnections.remove(path);
             Q_EMIT p.connectionsChanged();
             updateActiveAndBusy();
         }
     }
 
+    void connectionStateChanged()
+    {
+        updateConnectionState(*qobject_cast<VpnConnection*>(sender()));
+        updateActiveAndBusy();
+    }
+
+    void activeConnectionChanged(const QDBusObjectPath& connectionPath)
+    {
+        auto connection = m_connections.value(connectionPath);
+        if (connection)
+        {
+            connection->updateActiveConnection();
+        }
+    }
+
     void newConnection(const QDBusObjectPath &path)
     {
-        _newConnection(path, true);
+        load(path);
+    }
+
+    void connectionsListed(QDBusPendingCallWatcher *call)
+    {
+        call->deleteLater();
+
+        QDBusPendingReply<QList<QDBusObjectPath>> reply = *call;
+        if (reply.isError())
+        {
+            qWarning() << "Failed to list connections:" << reply.error().message();
+        }
+        else
+        {
+            for (const auto& path : reply.value())
+            {
+                if (!m_connections.contains(path) && !m_loading.contains(path))
+                {
+                    load(path);
+                }
+            }
+        }
+
+        m_listed = true;
+        checkReady();
     }
 
     void activateConnection(const QDBusObjectPath& connection)
@@ -129,25 +255,17 @@ public Q_SLOTS:
 
     void updateActiveAndBusy()
     {
-        bool busy = false;
-        for (const auto& connection: m_connections)
-        {
-            if (connection->isBusy())
-            {
-                busy = true;
-                break;
-            }
-        }
-        setBusy(busy);
+        setBusy(!m_busyConnections.isEmpty());
 
+        // Stick with the current one while it is still active
         QDBusObjectPath activeConnectionPath;
-        for (const auto& connection: m_connections)
+        if (m_activeConnections.contains(m_activeConnectionPath))
         {
-            if (connection->isActive())
-            {
-                activeConnectionPath = connection->path();
-                break;
-            }
+            activeConnectionPath = m_activeConnectionPath;
+        }
+        else if (!m_activeConnections.isEmpty())
+        {
+            activeConnectionPath = *m_activeConnections.constBegin();
         }
         setActiveConnectionPath(activeConnectionPath);
     }
@@ -185,27 +303,45 @@ public:
 
     QMap<QDBusObjectPath, VpnConnection::SPtr> m_connections;
 
+    // kept up-to-date from the connections' signals, rather than scanning them all
+    QSet<QDBusObjectPath> m_busyConnections;
+
+    QSet<QDBusObjectPath> m_activeConnections;
+
     bool m_busy = false;
 
     QDBusObjectPath m_activeConnectionPath;
+
+    // connections whose settings are still being fetched
+    QHash<QDBusObjectPath, QDBusPendingCallWatcher*> m_loading;
+
+    bool m_listed = false;
+
+    bool m_ready = false;
 };
 
 VpnManager::VpnManager(connection::ActiveConnectionManager::SPtr activeConnectionManager, const QDBusConnection& systemConnection) :
         d(new Priv(*this))
 {
     d->m_activeConnectionManager = activeConnectionManager;
-    d->m_nmInterface = make_shared<OrgFreedesktopNetworkManagerInterface>(
+    d->m_nmInterface = ProxyRegistry::get<OrgFreedesktopNetworkManagerInterface>(
                 NM_DBUS_SERVICE, NM_DBUS_PATH, systemConnection);
-    d->m_settingsInterface = make_shared<OrgFreedesktopNetworkManagerSettingsInterface>(
+    d->m_settingsInterface = ProxyRegistry::get<OrgFreedesktopNetworkManagerSettingsInterface>(
                 NM_DBUS_SERVICE, NM_DBUS_PATH_SETTINGS, systemConnection);
 
-    for (const auto& path : d->m_settingsInterface->connections())
-    {
-        d->_newConnection(path, false);
-    }
-    d->updateActiveAndBusy();
+    connect(d->m_activeConnectionManager.get(), &connection::ActiveConnectionManager::activeConnectionChanged, d.get(), &Priv::activeConnectionChanged);
+    connect(d->m_activeConnectionManager.get(), &connection::ActiveConnectionManager::ready, d.get(), &Priv::checkReady);
     connect(d->m_settingsInterface.get(), &OrgFreedesktopNetworkManagerSettingsInterface::NewConnection, d.get(), &Priv::newConnection);
     connect(d->m_settingsInterface.get(), &OrgFreedesktopNetworkManagerSettingsInterface::ConnectionRemoved, d.get(), &Priv::connectionRemoved);
+
+    util::startup::begin("nm-vpn-connections");
+    auto watcher(new QDBusPendingCallWatcher(d->m_settingsInterface->ListConnections(), d.get()));
+    connect(watcher, &QDBusPendingCallWatcher::finished, d.get(), &Priv::connectionsListed);
+}
+
+bool VpnManager::isReady() const
+{
+    return d->m_ready;
 }
 
 QList<VpnConnection::SPtr> VpnManager::connections() const
@@ -47,9 +47,14 @@ public:
 
     QString addConnection(VpnConnection::Type type);
 
+    /// the connections known at startup have been loaded
+    bool isReady() const;
+
 Q_SIGNALS:
     void connectionsChanged();
 
+    void ready();
+
 protected:
     class Priv;
     std::shared_ptr<Priv> d;
@@ -25,10 +25,11 @@
 namespace nmofono {
 namespace wifi {
 
-AccessPointImpl::AccessPointImpl(std::shared_ptr<OrgFreedesktopNetworkManagerAccessPointInterface> ap)
+AccessPointImpl::AccessPointImpl(std::shared_ptr<OrgFreedesktopNetworkManagerAccessPointInterface> ap,
+                                 const QVariantMap &properties)
         : m_ap(ap)
 {
-    uint mode = m_ap->mode();
+    uint mode = properties.value("Mode").toUInt();
 
 
     /// @todo check for the other modes also..
@@ -36,7 +37,7 @@ AccessPointImpl::AccessPointImpl(std::shared_ptr<OrgFreedesktopNetworkManagerAcc
 
     QString ssid;
     // Note: raw_ssid is _not_ guaranteed to be null terminated.
-    m_raw_ssid = m_ap->ssid();
+    m_raw_ssid = properties.value("Ssid").toByteArray();
 
     QTextCodec::ConverterState state;
     QTextCodec *codec = QTextCodec::codecForName("UTF-8");
@@ -60,9 +61,9 @@ AccessPointImpl::AccessPointImpl(std::shared_ptr<OrgFreedesktopNetworkManagerAcc
 
     m_ssid = ssid;
 
-    m_bssid = m_ap->hwAddress();
+    m_bssid = properties.value("HwAddress").toString();
 
-    m_strength = m_ap->strength();
+    m_strength = properties.value("Strength").toUInt();
 
     connect(m_ap.get(), &OrgFreedesktopNetworkManagerAccessPointInterface::PropertiesChanged, this, &AccessPointImpl::ap_properties_changed);
 
@@ -71,7 +72,7 @@ AccessPointImpl::AccessPointImpl(std::shared_ptr<OrgFreedesktopNetworkManagerAcc
      * Sometimes only wpa_flags or rns_flags is set and sometimes
      * they both are set but always to the same value
      */
-    m_secflags = m_ap->wpaFlags() | m_ap->rsnFlags();
+    m_secflags = properties.value("WpaFlags").toUInt() | properties.value("RsnFlags").toUInt();
     m_mode = mode;
 
     m_secured = (m_secflags != NM_802_11_AP_SEC_NONE);
@@ -72,7 +72,10 @@ public:
     friend struct Key;
 
 
-    AccessPointImpl(std::shared_ptr<OrgFreedesktopNetworkManagerAccessPointInterface> ap);
+    // properties is the result of GetAll on the access point interface, so
+    // that no blocking property reads are needed to set up the object.
+    AccessPointImpl(std::shared_ptr<OrgFreedesktopNetworkManagerAccessPointInterface> ap,
+                    const QVariantMap &properties);
     double strength() const override;
     virtual ~AccessPointImpl() = default;
 
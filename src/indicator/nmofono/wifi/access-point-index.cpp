@@ -0,0 +1,93 @@
+/*
+ * Copyright © 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmofono/wifi/access-point-index.h>
+
+namespace nmofono {
+namespace wifi {
+
+bool AccessPointIndex::contains(const QDBusObjectPath &path) const
+{
+    return m_accessPoints.contains(path);
+}
+
+AccessPointIndex::GroupPtr AccessPointIndex::add(AccessPointImpl::Ptr ap, bool &created)
+{
+    created = false;
+
+    auto path = ap->object_path();
+    if (m_accessPoints.contains(path))
+    {
+        return GroupPtr();
+    }
+
+    GroupPtr group;
+    AccessPointImpl::Key k(ap);
+    auto it = m_groups.find(k);
+    if (it != m_groups.end())
+    {
+        group = it->second;
+        group->add_ap(ap);
+    }
+    else
+    {
+        group = std::make_shared<GroupedAccessPoint>(ap);
+        m_groups.insert(std::make_pair(k, group));
+        created = true;
+    }
+
+    m_accessPoints.insert(path, ap);
+    m_groupsByPath.insert(path, group);
+    return group;
+}
+
+AccessPointIndex::GroupPtr AccessPointIndex::remove(const QDBusObjectPath &path, bool &emptied)
+{
+    emptied = false;
+
+    auto ap = m_accessPoints.take(path);
+    if (!ap)
+    {
+        return GroupPtr();
+    }
+
+    auto group = m_groupsByPath.take(path);
+    group->remove_ap(ap);
+    if (group->num_aps() == 0)
+    {
+        m_groups.erase(AccessPointImpl::Key(ap));
+        emptied = true;
+    }
+    return group;
+}
+
+AccessPointIndex::GroupPtr AccessPointIndex::group(const QDBusObjectPath &path) const
+{
+    return m_groupsByPath.value(path);
+}
+
+int AccessPointIndex::size() const
+{
+    return m_accessPoints.size();
+}
+
+int AccessPointIndex::groupCount() const
+{
+    return m_groups.size();
+}
+
+}
+}
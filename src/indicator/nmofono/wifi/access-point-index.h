@@ -0,0 +1,65 @@
+/*
+ * Copyright © 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <nmofono/wifi/access-point-impl.h>
+#include <nmofono/wifi/grouped-access-point.h>
+
+#include <map>
+#include <memory>
+
+#include <QDBusObjectPath>
+#include <QHash>
+
+namespace nmofono {
+namespace wifi {
+
+// Keeps track of the raw access points of a Wi-Fi device and the groups
+// they are merged into. All lookups by object path are constant time.
+
+class AccessPointIndex
+{
+public:
+    typedef std::shared_ptr<GroupedAccessPoint> GroupPtr;
+
+    bool contains(const QDBusObjectPath &path) const;
+
+    // Adds the access point to the group matching its key. Returns nullptr
+    // if an access point with the same path has been added already.
+    // created is set if a new group had to be created for it.
+    GroupPtr add(AccessPointImpl::Ptr ap, bool &created);
+
+    // Removes the access point with the given path and returns the group it
+    // was part of, or nullptr if the path is not known. emptied is set if
+    // it was the last access point of that group, which is then dropped.
+    GroupPtr remove(const QDBusObjectPath &path, bool &emptied);
+
+    // the group containing the access point with the given path
+    GroupPtr group(const QDBusObjectPath &path) const;
+
+    int size() const;
+
+    int groupCount() const;
+
+private:
+    QHash<QDBusObjectPath, AccessPointImpl::Ptr> m_accessPoints;
+    QHash<QDBusObjectPath, GroupPtr> m_groupsByPath;
+    std::map<AccessPointImpl::Key, GroupPtr> m_groups;
+};
+
+}
+}
@@ -19,6 +19,7 @@
 
 #include <nmofono/wifi/grouped-access-point.h>
 #include <nmofono/wifi/access-point-impl.h>
+#include <util/strength-filter.h>
 #include <vector>
 #include <stdexcept>
 #include <algorithm>
@@ -35,8 +36,11 @@ class GroupedAccessPoint::Private : public QObject
 
 public:
     Private(GroupedAccessPoint& parent) :
-            m_parent(parent), m_strength(.0)
+            m_parent(parent), m_strength(.0),
+            // same levels as the Wi-Fi signal icons in WifiLinkImpl
+            m_strengthFilter({20.0, 40.0, 60.0, 80.0}, 5.0, 1000)
     {
+        connect(&m_strengthFilter, &util::StrengthFilter::valueChanged, this, &Private::setStrength);
     }
 
     ~Private() = default;
@@ -44,6 +48,7 @@ public:
     vector<AccessPointImpl::Ptr> aplist;
 
     double m_strength;
+    util::StrengthFilter m_strengthFilter;
     chrono::system_clock::time_point m_lastTime;
 
     void add_ap(AccessPointImpl::Ptr ap)
@@ -58,33 +63,41 @@ public:
             }
         }
         aplist.push_back(ap);
-        if (ap->strength() > m_strength)
+        if (aplist.size() == 1)
         {
+            m_strengthFilter.reset(ap->strength());
             setStrength(ap->strength());
         }
+        else
+        {
+            update_strength(.0);
+        }
         update_lasttime(ap->lastConnected());
         connect(ap.get(), &AccessPoint::strengthUpdated, this, &Private::update_strength);
         connect(ap.get(), &AccessPointImpl::lastConnectedUpdated, this, &Private::update_lasttime);
     }
 
     void remove_ap(AccessPointImpl::Ptr ap) {
-        vector<AccessPointImpl::Ptr> new_aps;
-        for(const auto &i: aplist) {
-            if(i->object_path() != ap->object_path()) {
-                new_aps.push_back(i);
-            }
-        }
-        if(new_aps.size() >= aplist.size()) {
+        auto path = ap->object_path();
+        auto it = find_if(aplist.begin(), aplist.end(), [&path](const AccessPointImpl::Ptr &i) {
+            return i->object_path() == path;
+        });
+        if(it == aplist.end()) {
             qWarning() << "Tried to remove an AP that has not been added.";
             return;
         }
-        aplist.clear();
-        setStrength(.0);
+        disconnect(it->get(), nullptr, this, nullptr);
+        aplist.erase(it);
+
         // Do not reset lasttime because it does not change.
-        for(auto &i : new_aps) {
-            add_ap(i);
+        if(aplist.empty()) {
+            m_strengthFilter.reset(.0);
+            if(m_strength != .0) {
+                setStrength(.0);
+            }
+        } else {
+            update_strength(.0);
         }
-
     }
 
     bool has_object(const QDBusObjectPath &p) const {
@@ -96,12 +109,6 @@ public:
         return false;
     }
 
-    void setStrength(double s)
-    {
-        m_strength = s;
-        Q_EMIT m_parent.strengthUpdated(m_strength);
-    }
-
     void setLastTime(chrono::system_clock::time_point newTime)
     {
         m_lastTime = newTime;
@@ -123,10 +130,17 @@ public Q_SLOTS:
                       const AccessPointImpl::Ptr &a,
                       const AccessPointImpl::Ptr &b) {
             return a->strength() < b->strength(); });
-        double newstrength = (*nselem)->strength();
-        if(abs(newstrength - m_strength) > 0.01) {
-            setStrength(newstrength);
+        // only changes that show up in the signal icons get through
+        m_strengthFilter.update((*nselem)->strength());
+    }
+
+    void setStrength(double s)
+    {
+        if(abs(s - m_strength) <= 0.01) {
+            return;
         }
+        m_strength = s;
+        Q_EMIT m_parent.strengthUpdated(m_strength);
     }
 };
 
@@ -0,0 +1,221 @@
+/*
+ * Copyright © 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmofono/wifi/known-connections.h>
+#include <nmofono/proxy-registry.h>
+#include <NetworkManagerSettingsInterface.h>
+#include <NetworkManagerSettingsConnectionInterface.h>
+
+#include <NetworkManager.h>
+#include <QDebug>
+#include <QDBusPendingCallWatcher>
+#include <QHash>
+#include <QMultiHash>
+
+using namespace std;
+
+namespace nmofono {
+namespace wifi {
+
+struct KnownConnections::Private : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Entry
+    {
+        shared_ptr<OrgFreedesktopNetworkManagerSettingsConnectionInterface> connection;
+        // the GetSettings call in flight, if any
+        QDBusPendingCallWatcher *pending = nullptr;
+        QByteArray ssid;
+        // connection.interface-name, empty if it applies to any device
+        QString interface;
+    };
+
+    Private(KnownConnections& parent) :
+        p(parent)
+    {
+    }
+
+    KnownConnections& p;
+
+    shared_ptr<OrgFreedesktopNetworkManagerSettingsInterface> m_settings;
+
+    QHash<QDBusObjectPath, Entry> m_connections;
+
+    QMultiHash<QByteArray, QDBusObjectPath> m_bySsid;
+
+    void load(const QDBusObjectPath &path)
+    {
+        auto it = m_connections.find(path);
+        if (it == m_connections.end())
+        {
+            return;
+        }
+
+        auto watcher(new QDBusPendingCallWatcher(it->connection->GetSettings(), this));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, path](QDBusPendingCallWatcher *call) {
+            loaded(path, call);
+        });
+        // a newer request supersedes the one in flight
+        it->pending = watcher;
+    }
+
+    void loaded(const QDBusObjectPath &path, QDBusPendingCallWatcher *call)
+    {
+        call->deleteLater();
+
+        auto it = m_connections.find(path);
+        if (it == m_connections.end() || it->pending != call)
+        {
+            return;
+        }
+        it->pending = nullptr;
+
+        QDBusPendingReply<QVariantDictMap> reply = *call;
+        if (reply.isError())
+        {
+            qWarning() << "Failed to get settings of connection" << path.path() << ":" << reply.error().message();
+            return;
+        }
+
+        QByteArray ssid;
+        QString interface;
+        QVariantDictMap settings = reply;
+        auto wirelessIt = settings.find("802-11-wireless");
+        // hotspot and ad-hoc profiles can share the SSID of a network we
+        // would join, but activating one of them does not join it
+        if (wirelessIt != settings.cend()
+                && wirelessIt->value("mode", "infrastructure").toString() == "infrastructure")
+        {
+            ssid = wirelessIt->value("ssid").toByteArray();
+            interface = settings.value("connection").value("interface-name").toString();
+        }
+
+        if (ssid == it->ssid && interface == it->interface)
+        {
+            return;
+        }
+        it->interface = interface;
+
+        if (!it->ssid.isEmpty())
+        {
+            m_bySsid.remove(it->ssid, path);
+        }
+        it->ssid = ssid;
+        if (!ssid.isEmpty())
+        {
+            m_bySsid.insert(ssid, path);
+        }
+
+        Q_EMIT p.changed();
+    }
+
+public Q_SLOTS:
+    void connectionsListed(QDBusPendingCallWatcher *call)
+    {
+        call->deleteLater();
+
+        QDBusPendingReply<QList<QDBusObjectPath>> reply = *call;
+        if (reply.isError())
+        {
+            qWarning() << "Failed to list connections:" << reply.error().message();
+            return;
+        }
+
+        for (const auto& path : reply.value())
+        {
+            connectionAdded(path);
+        }
+    }
+
+    void connectionAdded(const QDBusObjectPath &path)
+    {
+        if (m_connections.contains(path))
+        {
+            return;
+        }
+
+        Entry entry;
+        entry.connection = ProxyRegistry::get<OrgFreedesktopNetworkManagerSettingsConnectionInterface>(
+                NM_DBUS_SERVICE, path.path(), m_settings->connection());
+        connect(entry.connection.get(), &OrgFreedesktopNetworkManagerSettingsConnectionInterface::Updated, this, [this, path]() {
+            load(path);
+        });
+        m_connections.insert(path, entry);
+
+        load(path);
+    }
+
+    void connectionRemoved(const QDBusObjectPath &path)
+    {
+        auto it = m_connections.find(path);
+        if (it == m_connections.end())
+        {
+            return;
+        }
+
+        QByteArray ssid = it->ssid;
+        m_connections.erase(it);
+
+        if (!ssid.isEmpty())
+        {
+            m_bySsid.remove(ssid, path);
+            Q_EMIT p.changed();
+        }
+    }
+};
+
+KnownConnections::KnownConnections(const QDBusConnection& systemConnection) :
+        d(new Private(*this))
+{
+    d->m_settings = ProxyRegistry::get<OrgFreedesktopNetworkManagerSettingsInterface>(
+            NM_DBUS_SERVICE, NM_DBUS_PATH_SETTINGS, systemConnection);
+
+    connect(d->m_settings.get(), &OrgFreedesktopNetworkManagerSettingsInterface::NewConnection, d.get(), &Private::connectionAdded);
+    connect(d->m_settings.get(), &OrgFreedesktopNetworkManagerSettingsInterface::ConnectionRemoved, d.get(), &Private::connectionRemoved);
+
+    auto watcher(new QDBusPendingCallWatcher(d->m_settings->ListConnections(), d.get()));
+    connect(watcher, &QDBusPendingCallWatcher::finished, d.get(), &Private::connectionsListed);
+}
+
+KnownConnections::~KnownConnections()
+{
+}
+
+QList<QDBusObjectPath> KnownConnections::find(const QByteArray& ssid, const QString& interface) const
+{
+    QList<QDBusObjectPath> result;
+    for (const auto& path : d->m_bySsid.values(ssid))
+    {
+        const auto& bound = d->m_connections.value(path).interface;
+        if (bound.isEmpty() || bound == interface)
+        {
+            result << path;
+        }
+    }
+    return result;
+}
+
+int KnownConnections::size() const
+{
+    return d->m_bySsid.size();
+}
+
+}
+}
+
+#include "known-connections.moc"
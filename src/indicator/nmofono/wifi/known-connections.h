@@ -0,0 +1,62 @@
+/*
+ * Copyright © 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include <QByteArray>
+#include <QDBusConnection>
+#include <QDBusObjectPath>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+namespace nmofono {
+namespace wifi {
+
+// Index of the Wi-Fi settings connections known to NetworkManager by SSID.
+// The settings are fetched asynchronously and kept up-to-date from the
+// NewConnection, ConnectionRemoved and Updated signals, so looking up a
+// connection never has to go to the bus.
+
+class KnownConnections : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef std::shared_ptr<KnownConnections> Ptr;
+
+    KnownConnections(const QDBusConnection& systemConnection);
+
+    ~KnownConnections();
+
+    // client settings connections for the given raw SSID that may be
+    // activated on the named interface
+    QList<QDBusObjectPath> find(const QByteArray& ssid, const QString& interface) const;
+
+    int size() const;
+
+Q_SIGNALS:
+    void changed();
+
+private:
+    struct Private;
+    std::unique_ptr<Private> d;
+};
+
+}
+}
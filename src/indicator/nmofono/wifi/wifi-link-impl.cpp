@@ -18,17 +18,21 @@
  */
 
 #include <nmofono/wifi/wifi-link-impl.h>
+#include <nmofono/proxy-registry.h>
 #include <nmofono/wifi/access-point-impl.h>
+#include <nmofono/wifi/access-point-index.h>
 #include <nmofono/wifi/grouped-access-point.h>
 #include <url-dispatcher-cpp/url-dispatcher.h>
 #include <cassert>
 
 #include <NetworkManagerActiveConnectionInterface.h>
 #include <NetworkManagerDeviceWirelessInterface.h>
-#include <NetworkManagerSettingsConnectionInterface.h>
 
 #include <NetworkManager.h>
 #include <iostream>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QTimer>
 #include <QUrlQuery>
 
 using namespace std;
@@ -55,14 +59,23 @@ public:
          m_lastState(NM_STATE_UNKNOWN),
          m_connecting(false)
     {
+        // Collect the access point changes of a whole scan
+        m_accessPointsTimer.setInterval(0);
+        m_accessPointsTimer.setSingleShot(true);
+        connect(&m_accessPointsTimer, &QTimer::timeout, this, &Private::flush_access_points);
     }
 
     WifiLinkImpl& p;
 
     uint32_t m_characteristics = Link::Characteristics::empty;
     Link::Status m_status = Status::disabled;
-    QSet<AccessPointImpl::Ptr> m_rawAccessPoints;
+    AccessPointIndex m_accessPointIndex;
+    // access points whose properties are still being fetched
+    QHash<QDBusObjectPath, QDBusPendingCallWatcher*> m_loadingAccessPoints;
     QSet<AccessPoint::Ptr> m_groupedAccessPoints;
+    QSet<AccessPoint::Ptr> m_pendingAddedAccessPoints;
+    QSet<AccessPoint::Ptr> m_pendingRemovedAccessPoints;
+    QTimer m_accessPointsTimer;
     AccessPoint::Ptr m_activeAccessPoint;
     Signal m_signal = Signal::disconnected;
 
@@ -72,12 +85,15 @@ public:
 
     KillSwitch::Ptr m_killSwitch;
 
-    map<AccessPointImpl::Key, shared_ptr<GroupedAccessPoint>> m_grouper;
     uint32_t m_lastState = 0;
     QString m_name;
     shared_ptr<OrgFreedesktopNetworkManagerConnectionActiveInterface> m_activeConnection;
+    QDBusObjectPath m_activeAccessPointPath;
     unique_ptr<QMetaObject::Connection> m_signalStrengthConnection;
     bool m_connecting = false;
+    QDBusPendingCallWatcher *m_connectCall = nullptr;
+    KnownConnections::Ptr m_knownConnections;
+    ObjectCache::Ptr m_objectCache;
     bool m_disconnectWifi = false;
 
     void setStatus(Status status)
@@ -166,6 +182,146 @@ public:
         }
     }
 
+    void setActiveAccessPoint(AccessPoint::Ptr ap)
+    {
+        m_activeAccessPoint = ap;
+        disconnectSignalStengthConnection();
+        m_signalStrengthConnection = make_unique<
+                QMetaObject::Connection>(
+                connect(m_activeAccessPoint.get(),
+                        &AccessPoint::strengthUpdated, this,
+                        &Private::strengthUpdated));
+        Q_EMIT p.activeAccessPointUpdated(m_activeAccessPoint);
+        strengthUpdated();
+    }
+
+    void connect_finished(QDBusPendingCallWatcher *call, bool added)
+    {
+        call->deleteLater();
+
+        QDBusObjectPath ac("/");
+        QDBusError error;
+        if (added) {
+            QDBusPendingReply<QDBusObjectPath, QDBusObjectPath> reply = *call;
+            error = reply.error();
+            if (!reply.isError()) {
+                ac = reply.argumentAt<1>();
+            }
+        } else {
+            QDBusPendingReply<QDBusObjectPath> reply = *call;
+            error = reply.error();
+            if (!reply.isError()) {
+                ac = reply;
+            }
+        }
+
+        if (error.isValid()) {
+            qWarning() << " Failed to activate connection: " << error.message();
+        }
+
+        if (call == m_connectCall) {
+            m_connectCall = nullptr;
+            m_connecting = false;
+            if (error.isValid()) {
+                // pick up the states ignored while connecting
+                updateDeviceState(m_lastState);
+            } else {
+                updateActiveConnection(ac);
+            }
+        }
+    }
+
+    void available_connections_loaded(QDBusPendingCallWatcher *call,
+                                      AccessPoint::Ptr accessPoint,
+                                      const QList<QDBusObjectPath> &known)
+    {
+        call->deleteLater();
+
+        if (call != m_connectCall) {
+            return;
+        }
+        m_connectCall = nullptr;
+        m_connecting = false;
+
+        QList<QDBusObjectPath> candidates;
+        QDBusPendingReply<QDBusVariant> reply = *call;
+        if (reply.isError()) {
+            qWarning() << "Failed to get the available connections of" << m_dev->path() << ":" << reply.error().message();
+            candidates = known;
+        } else {
+            auto available = qdbus_cast<QList<QDBusObjectPath>>(reply.value().variant());
+            for (const auto& path : known) {
+                if (available.contains(path)) {
+                    candidates << path;
+                }
+            }
+        }
+
+        activate(accessPoint, candidates);
+
+        if (!m_connecting) {
+            // pick up the states ignored while looking
+            updateDeviceState(m_lastState);
+        }
+    }
+
+    void activate(AccessPoint::Ptr accessPoint, const QList<QDBusObjectPath> &known)
+    {
+        if (known.isEmpty() && accessPoint->enterprise()) {
+            qDebug() << "New connection to enterprise access point";
+            // activate system settings URI
+            QUrlQuery q;
+            q.addQueryItem("ssid", accessPoint->raw_ssid());
+            q.addQueryItem("bssid", accessPoint->bssid());
+            QString url = "settings:///system/wifi?" + q.query(QUrl::FullyEncoded);
+
+            UrlDispatcher::send(url.toStdString(), [](string url, bool success) {
+                if (!success) {
+                    cerr << "URL Dispatcher failed on " << url << endl;
+                }
+            });
+
+            // the system settings app will perform the connection
+            return;
+        }
+
+        QDBusPendingCall call;
+        if (!known.isEmpty()) {
+            qDebug() << "Connecting to known access point";
+            call = m_nm->ActivateConnection(known.first(),
+                                            QDBusObjectPath(m_dev->path()),
+                                            accessPoint->object_path());
+        } else {
+            qDebug() << "New connection to regular access point";
+            QVariantDictMap conf;
+
+            QVariantMap wireless_conf;
+            wireless_conf["ssid"] = accessPoint->raw_ssid();
+
+            conf["802-11-wireless"] = wireless_conf;
+            call = m_nm->AddAndActivateConnection(
+                    conf, QDBusObjectPath(m_dev->path()), accessPoint->object_path());
+        }
+
+        m_connecting = true;
+        auto watcher(new QDBusPendingCallWatcher(call, this));
+        bool added = known.isEmpty();
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, added](QDBusPendingCallWatcher *call) {
+            connect_finished(call, added);
+        });
+        // a newer request supersedes the one in flight
+        m_connectCall = watcher;
+    }
+
+    void schedule_access_points_flush()
+    {
+        // wait for the rest of the scan to be loaded
+        if (m_loadingAccessPoints.isEmpty())
+        {
+            m_accessPointsTimer.start();
+        }
+    }
+
     /// '/' path means invalid.
     void updateActiveConnection(const QDBusObjectPath &path)
     {
@@ -174,6 +330,7 @@ public:
             m_activeAccessPoint.reset();
             Q_EMIT p.activeAccessPointUpdated(m_activeAccessPoint);
             m_activeConnection.reset();
+            m_activeAccessPointPath = QDBusObjectPath();
             disconnectSignalStengthConnection();
             strengthUpdated();
             return;
@@ -186,8 +343,7 @@ public:
         }
 
         try {
-            m_activeConnection = make_shared<
-                    OrgFreedesktopNetworkManagerConnectionActiveInterface>(
+            m_activeConnection = ProxyRegistry::get<OrgFreedesktopNetworkManagerConnectionActiveInterface>(
                     NM_DBUS_SERVICE, path.path(), m_dev->connection());
             uint state = m_activeConnection->state();
             switch (state) {
@@ -199,21 +355,12 @@ public:
                 ;
 
                 // for Wi-Fi devices specific_object is the AccessPoint object.
-                QDBusObjectPath ap_path = m_activeConnection->specificObject();
-                for (auto &ap : m_groupedAccessPoints) {
-                    auto shap =  dynamic_pointer_cast<GroupedAccessPoint>(ap);
-                    if (shap->has_object(ap_path)) {
-                        m_activeAccessPoint = ap;
-                        disconnectSignalStengthConnection();
-                        m_signalStrengthConnection = make_unique<
-                                QMetaObject::Connection>(
-                                connect(m_activeAccessPoint.get(),
-                                        &AccessPoint::strengthUpdated, this,
-                                        &Private::strengthUpdated));
-                        Q_EMIT p.activeAccessPointUpdated(m_activeAccessPoint);
-                        strengthUpdated();
-                        break;
-                    }
+                // It might still be loading, in which case it is picked up
+                // in ap_loaded().
+                m_activeAccessPointPath = m_activeConnection->specificObject();
+                auto shap = m_accessPointIndex.group(m_activeAccessPointPath);
+                if (shap) {
+                    setActiveAccessPoint(shap);
                 }
             }
         } catch (exception &e) {
@@ -227,90 +374,128 @@ public:
 public Q_SLOTS:
     void ap_added(const QDBusObjectPath &path)
     {
-        try {
-            for (auto ap : m_rawAccessPoints) {
-                if (dynamic_pointer_cast<AccessPoint>(ap)->object_path() == path) {
-                    // already in the list
-                    return;
-                }
-            }
+        if (m_accessPointIndex.contains(path) || m_loadingAccessPoints.contains(path)) {
+            // already in the list
+            return;
+        }
 
-            AccessPointImpl::Ptr shap;
-            try {
-                auto ap = make_shared<
-                        OrgFreedesktopNetworkManagerAccessPointInterface>(
-                        NM_DBUS_SERVICE, path.path(), m_dev->connection());
-                shap = make_shared<AccessPointImpl>(ap);
-            } catch(const exception &e) {
-                qWarning() << "Failed to create AccessPoint proxy for "<< path.path() << ": ";
-                qWarning() << "\t" << QString::fromStdString(e.what());
-                qWarning() << "\tIgnoring.";
-                return;
-            }
+        if (m_objectCache && m_objectCache->contains(path, NM_DBUS_INTERFACE_ACCESS_POINT)) {
+            ap_ready(path, m_objectCache->properties(path, NM_DBUS_INTERFACE_ACCESS_POINT));
+            return;
+        }
 
-            m_rawAccessPoints.insert(shap);
+        // Fetch all the properties in one go without waiting for the reply,
+        // so that the requests for a whole scan are pipelined on the bus.
+        auto message = QDBusMessage::createMethodCall(NM_DBUS_SERVICE,
+                                                      path.path(),
+                                                      "org.freedesktop.DBus.Properties",
+                                                      "GetAll");
+        message << QString(NM_DBUS_INTERFACE_ACCESS_POINT);
+
+        auto watcher(new QDBusPendingCallWatcher(m_dev->connection().asyncCall(message), this));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, path](QDBusPendingCallWatcher *call) {
+            ap_loaded(path, call);
+        });
+        m_loadingAccessPoints.insert(path, watcher);
+    }
 
-            auto k = AccessPointImpl::Key(shap);
-            if(m_grouper.find(k) != m_grouper.end()) {
-                m_grouper[k]->add_ap(shap);
-            } else {
-                m_grouper[k] = make_shared<GroupedAccessPoint>(shap);
-            }
-            update_grouped_access_points();
-        } catch(const exception &e) {
-            /// @bug dbus-cpp internal logic exploded
-            // If this happens, indicator-network is in an unknown state with no clear way of
-            // recovering. The only reasonable way out is a graceful exit.
-            cerr << " Failed to run dbus service: " << e.what() << endl;
+    void ap_loaded(const QDBusObjectPath &path, QDBusPendingCallWatcher *call)
+    {
+        call->deleteLater();
+
+        // removed while we were waiting for the properties
+        if (m_loadingAccessPoints.value(path) != call) {
+            return;
+        }
+        m_loadingAccessPoints.remove(path);
+
+        QDBusPendingReply<QVariantMap> reply = *call;
+        if (reply.isError()) {
+            qWarning() << "Failed to get properties of AccessPoint " << path.path() << ": ";
+            qWarning() << "\t" << reply.error().message();
+            qWarning() << "\tIgnoring.";
+            schedule_access_points_flush();
+            return;
         }
+
+        ap_ready(path, reply.value());
     }
 
-    void ap_removed(const QDBusObjectPath &path)
+    void ap_ready(const QDBusObjectPath &path, const QVariantMap &properties)
     {
         AccessPointImpl::Ptr shap;
+        try {
+            auto ap = ProxyRegistry::get<OrgFreedesktopNetworkManagerAccessPointInterface>(
+                    NM_DBUS_SERVICE, path.path(), m_dev->connection());
+            shap = make_shared<AccessPointImpl>(ap, properties);
+        } catch(const exception &e) {
+            qWarning() << "Failed to create AccessPoint proxy for "<< path.path() << ": ";
+            qWarning() << "\t" << QString::fromStdString(e.what());
+            qWarning() << "\tIgnoring.";
+            schedule_access_points_flush();
+            return;
+        }
 
-        auto list = m_rawAccessPoints;
-        for (const auto &ap : list) {
-            if (ap->object_path() == path) {
-                shap = ap;
-                list.remove(ap);
-                break;
-            }
+        bool created;
+        auto group = m_accessPointIndex.add(shap, created);
+        if (created) {
+            m_pendingAddedAccessPoints.insert(group);
+        }
+        schedule_access_points_flush();
+
+        if (group && !m_activeAccessPoint && m_activeConnection
+                && path == m_activeAccessPointPath) {
+            setActiveAccessPoint(group);
         }
-        if (!shap) {
+    }
+
+    void ap_removed(const QDBusObjectPath &path)
+    {
+        // still loading, just forget about it
+        if (m_loadingAccessPoints.remove(path) > 0) {
+            schedule_access_points_flush();
+            return;
+        }
+
+        bool emptied;
+        AccessPoint::Ptr group = m_accessPointIndex.remove(path, emptied);
+        if (!group) {
             qWarning() << "Tried to remove access point " << path.path() << " that has not been added.";
             return;
         }
-        m_rawAccessPoints = list;
 
-        AccessPointImpl::Key k(shap);
-        auto it = m_grouper.find(k);
-        if (it != m_grouper.end())
+        if (emptied)
         {
-            it->second->remove_ap(shap);
-            if (it->second->num_aps() == 0)
+            // a group that appeared and vanished within the same scan
+            // was never published
+            if (!m_pendingAddedAccessPoints.remove(group))
             {
-                m_grouper.erase(it);
+                m_pendingRemovedAccessPoints.insert(group);
+                schedule_access_points_flush();
             }
         }
-        update_grouped_access_points();
     }
 
-    void update_grouped_access_points()
+    void flush_access_points()
     {
-        m_groupedAccessPoints.clear();
-        for (auto &i : m_grouper)
-        {
-            m_groupedAccessPoints.insert(i.second);
-        }
+        m_accessPointsTimer.stop();
 
-        if (m_disconnectWifi)
+        if (m_pendingAddedAccessPoints.isEmpty() && m_pendingRemovedAccessPoints.isEmpty())
         {
-            Q_EMIT p.accessPointsUpdated(QSet<AccessPoint::Ptr>());
+            return;
         }
-        else
+
+        QSet<AccessPoint::Ptr> added;
+        QSet<AccessPoint::Ptr> removed;
+        added.swap(m_pendingAddedAccessPoints);
+        removed.swap(m_pendingRemovedAccessPoints);
+
+        m_groupedAccessPoints.subtract(removed);
+        m_groupedAccessPoints.unite(added);
+
+        if (!m_disconnectWifi)
         {
-            Q_EMIT p.accessPointsUpdated(m_groupedAccessPoints);
+            Q_EMIT p.accessPointsChanged(added, removed);
         }
     }
 
@@ -367,19 +552,40 @@ public Q_SLOTS:
 
 WifiLinkImpl::WifiLinkImpl(shared_ptr<OrgFreedesktopNetworkManagerDeviceInterface> dev,
            shared_ptr<OrgFreedesktopNetworkManagerInterface> nm,
-           KillSwitch::Ptr killSwitch)
+           KillSwitch::Ptr killSwitch,
+           KnownConnections::Ptr knownConnections,
+           ObjectCache::Ptr objectCache)
     : d(new Private(*this, dev, nm, killSwitch)) {
-    d->m_name = d->m_dev->interface();
+    d->m_objectCache = objectCache;
+
+    // Take what we can from the ObjectManager snapshot instead of asking
+    QDBusObjectPath devicePath(d->m_dev->path());
+    bool cached = d->m_objectCache
+            && d->m_objectCache->contains(devicePath, NM_DBUS_INTERFACE_DEVICE)
+            && d->m_objectCache->contains(devicePath, NM_DBUS_INTERFACE_DEVICE_WIRELESS);
+    QVariantMap deviceProperties;
+    if (cached) {
+        deviceProperties = d->m_objectCache->properties(devicePath, NM_DBUS_INTERFACE_DEVICE);
+    }
+
+    d->m_name = cached ? deviceProperties.value("Interface").toString() : d->m_dev->interface();
+    d->m_knownConnections = knownConnections;
+    connect(d->m_knownConnections.get(), &KnownConnections::changed, this, &WifiLink::knownAccessPointsChanged);
 
     connect(&d->m_wireless, &OrgFreedesktopNetworkManagerDeviceWirelessInterface::AccessPointAdded, d.get(), &Private::ap_added);
     connect(&d->m_wireless, &OrgFreedesktopNetworkManagerDeviceWirelessInterface::AccessPointRemoved, d.get(), &Private::ap_removed);
-    QList<QDBusObjectPath> aps = d->m_wireless.GetAccessPoints();
+    QList<QDBusObjectPath> aps;
+    if (cached) {
+        aps = ObjectCache::objectPaths(d->m_objectCache->properties(devicePath, NM_DBUS_INTERFACE_DEVICE_WIRELESS).value("AccessPoints"));
+    } else {
+        aps = d->m_wireless.GetAccessPoints();
+    }
     for (const auto& path : aps) {
         d->ap_added(path);
     }
 
     connect(d->m_dev.get(), &OrgFreedesktopNetworkManagerDeviceInterface::StateChanged, d.get(), &Private::state_changed);
-    d->updateDeviceState(d->m_dev->state());
+    d->updateDeviceState(cached ? deviceProperties.value("State").toUInt() : d->m_dev->state());
 
     connect(d->m_killSwitch.get(), &KillSwitch::stateChanged, d.get(), &Private::kill_switch_updated);
 
@@ -446,86 +652,39 @@ WifiLinkImpl::accessPoints() const {
     return d->m_groupedAccessPoints;
 }
 
+bool
+WifiLinkImpl::isKnown(AccessPoint::Ptr accessPoint) const
+{
+    return !d->m_knownConnections->find(accessPoint->raw_ssid(), d->m_name).isEmpty();
+}
+
 void
 WifiLinkImpl::connect_to(AccessPoint::Ptr accessPoint)
 {
     qDebug() << "Connecting to:" << accessPoint->ssid();
 
-    try {
-        d->m_connecting = true;
-        QByteArray ssid = accessPoint->raw_ssid();
-
-        shared_ptr<OrgFreedesktopNetworkManagerSettingsConnectionInterface> found;
-        QList<QDBusObjectPath> connections = d->m_dev->availableConnections();
-        for (auto &path : connections) {
-            auto con = make_shared<OrgFreedesktopNetworkManagerSettingsConnectionInterface>(
-                    NM_DBUS_SERVICE, path.path(), d->m_dev->connection());
-            QVariantDictMap settings = con->GetSettings();
-            auto wirelessIt = settings.find("802-11-wireless");
-            if (wirelessIt != settings.cend())
-            {
-                auto ssidIt = wirelessIt->find("ssid");
-                if (ssidIt != wirelessIt->cend())
-                {
-                    if (ssidIt->toByteArray() == ssid)
-                    {
-                        found = con;
-                        break;
-                    }
-                }
-            }
-        }
-
-        /// @todo check the timestamps as there might be multiple ones that are suitable.
-        /// @todo oh, and check more parameters than just the ssid
-
-        QDBusObjectPath ac("/");
-        if (found) {
-            qDebug() << "Connecting to known access point";
-            ac = d->m_nm->ActivateConnection(QDBusObjectPath(found->path()),
-                                           QDBusObjectPath(d->m_dev->path()),
-                                           accessPoint->object_path());
-        } else {
-            if (accessPoint->enterprise()) {
-                qDebug() << "New connection to enterprise access point";
-                // activate system settings URI
-                QUrlQuery q;
-                q.addQueryItem("ssid", accessPoint->raw_ssid());
-                q.addQueryItem("bssid", accessPoint->bssid());
-                QString url = "settings:///system/wifi?" + q.query(QUrl::FullyEncoded);
-
-                UrlDispatcher::send(url.toStdString(), [](string url, bool success) {
-                    if (!success) {
-                        cerr << "URL Dispatcher failed on " << url << endl;
-                    }
-                });
-            } else {
-                qDebug() << "New connection to regular access point";
-                QVariantDictMap conf;
-
-                /// @todo getting the ssid multiple times over dbus is stupid.
-
-                QVariantMap wireless_conf;
-                wireless_conf["ssid"] = ssid;
-
-                conf["802-11-wireless"] = wireless_conf;
-                auto ret = d->m_nm->AddAndActivateConnection(
-                        conf, QDBusObjectPath(d->m_dev->path()), accessPoint->object_path());
-                ret.waitForFinished();
-                ac = ret.argumentAt<1>();
-            }
-        }
-        // For enterprise access points, the system settings app will perform the connection
-        if (!accessPoint->enterprise()) {
-            d->updateActiveConnection(ac);
-        }
-        d->m_connecting = false;
-    } catch(const exception &e) {
-        // @bug default timeout expired: LP(#1361642)
-        // If this happens, indicator-network is in an unknown state with no clear way of
-        // recovering. The only reasonable way out is a graceful exit.
-        qWarning() << " Failed to activate connection: " << e.what();
+    /// @todo check the timestamps as there might be multiple ones that are suitable.
+    QList<QDBusObjectPath> known = d->m_knownConnections->find(accessPoint->raw_ssid(), d->m_name);
+    if (known.isEmpty()) {
+        d->activate(accessPoint, known);
+        return;
     }
+
+    // Only NetworkManager knows whether a profile's MAC address and other
+    // restrictions allow it on this device, so ask which ones it would take.
+    auto message = QDBusMessage::createMethodCall(NM_DBUS_SERVICE,
+                                                  d->m_dev->path(),
+                                                  "org.freedesktop.DBus.Properties",
+                                                  "Get");
+    message << QString(NM_DBUS_INTERFACE_DEVICE) << QString("AvailableConnections");
+
+    d->m_connecting = true;
+    auto watcher(new QDBusPendingCallWatcher(d->m_dev->connection().asyncCall(message), d.get()));
+    connect(watcher, &QDBusPendingCallWatcher::finished, d.get(), [this, accessPoint, known](QDBusPendingCallWatcher *call) {
+        d->available_connections_loaded(call, accessPoint, known);
+    });
+    // a newer request supersedes the one in flight
+    d->m_connectCall = watcher;
 }
 
 AccessPoint::Ptr
@@ -546,6 +705,8 @@ WifiLinkImpl::setDisconnectWifi(bool disconnect)
         return;
     }
 
+    // publish the pending changes with the old visibility first
+    d->flush_access_points();
     d->m_disconnectWifi = disconnect;
 
     d->m_dev->setAutoconnect(!disconnect);
@@ -556,7 +717,14 @@ WifiLinkImpl::setDisconnectWifi(bool disconnect)
                 QDBusObjectPath(d->m_activeConnection->path()));
     }
 
-    d->update_grouped_access_points();
+    if (disconnect)
+    {
+        Q_EMIT accessPointsChanged(QSet<AccessPoint::Ptr>(), d->m_groupedAccessPoints);
+    }
+    else
+    {
+        Q_EMIT accessPointsChanged(d->m_groupedAccessPoints, QSet<AccessPoint::Ptr>());
+    }
     d->strengthUpdated();
 }
 
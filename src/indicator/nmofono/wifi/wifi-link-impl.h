@@ -20,6 +20,8 @@
 #pragma once
 
 #include <nmofono/kill-switch.h>
+#include <nmofono/object-cache.h>
+#include <nmofono/wifi/known-connections.h>
 #include <nmofono/wifi/wifi-link.h>
 #include <util/qhash-sharedptr.h>
 
@@ -39,7 +41,9 @@ public:
 
     WifiLinkImpl(std::shared_ptr<OrgFreedesktopNetworkManagerDeviceInterface> dev,
          std::shared_ptr<OrgFreedesktopNetworkManagerInterface> nm,
-         KillSwitch::Ptr killSwitch);
+         KillSwitch::Ptr killSwitch,
+         KnownConnections::Ptr knownConnections,
+         ObjectCache::Ptr objectCache = ObjectCache::Ptr());
     ~WifiLinkImpl();
 
     // public API
@@ -54,6 +58,8 @@ public:
     void connect_to(AccessPoint::Ptr accessPoint) override;
     AccessPoint::Ptr activeAccessPoint() override;
 
+    bool isKnown(AccessPoint::Ptr accessPoint) const override;
+
     QDBusObjectPath device_path() const;
 
     void setDisconnectWifi(bool) override;
@@ -68,14 +68,19 @@ public:
     WifiLink(const WifiLink&) = delete;
     virtual ~WifiLink() = default;
 
-    Q_PROPERTY(QSet<nmofono::wifi::AccessPoint::Ptr> accessPoints READ accessPoints NOTIFY accessPointsUpdated)
+    Q_PROPERTY(QSet<nmofono::wifi::AccessPoint::Ptr> accessPoints READ accessPoints NOTIFY accessPointsChanged)
     virtual QSet<AccessPoint::Ptr> accessPoints() const = 0;
 
+    /// returns straight away, without waiting for NetworkManager to
+    /// answer the activation request.
     virtual void connect_to(AccessPoint::Ptr accessPoint) = 0;
 
     Q_PROPERTY(nmofono::wifi::AccessPoint::Ptr activeAccessPoint READ activeAccessPoint NOTIFY activeAccessPointUpdated)
     virtual AccessPoint::Ptr activeAccessPoint() = 0;
 
+    /// whether a connection has been stored for the access point's network
+    virtual bool isKnown(AccessPoint::Ptr accessPoint) const = 0;
+
     virtual Mode mode() const = 0;
 
     virtual Signal signal() const = 0;
@@ -84,10 +89,16 @@ public Q_SLOTS:
     virtual void setDisconnectWifi(bool) = 0;
 
 Q_SIGNALS:
-    void accessPointsUpdated(const QSet<AccessPoint::Ptr>&);
+    /// emitted at most once per event loop iteration with the difference
+    /// to the previously published set of access points.
+    void accessPointsChanged(const QSet<AccessPoint::Ptr>& added,
+                             const QSet<AccessPoint::Ptr>& removed);
 
     void activeAccessPointUpdated(AccessPoint::Ptr);
 
+    /// the result of isKnown() may have changed for any access point
+    void knownAccessPointsChanged();
+
     void signalUpdated(Signal);
 
 };
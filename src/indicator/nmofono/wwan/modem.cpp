@@ -20,6 +20,7 @@
 #include <nmofono/wwan/modem.h>
 
 #include <ofono/dbus.h>
+#include <util/strength-filter.h>
 #include <QDebug>
 
 #define slots
@@ -105,7 +106,9 @@ public:
 
     QString m_operatorName;
     Modem::ModemStatus m_status;
-    int8_t m_strength;
+    int8_t m_strength = -1;
+    // same levels as Icons::strengthIcon
+    util::StrengthFilter m_strengthFilter{{1, 6, 16, 26, 39}, 2, 500};
     Modem::Bearer m_bearer;
 
     bool m_dataEnabled;
@@ -154,6 +157,8 @@ public:
         m_updatedTimer.setInterval(0);
         m_updatedTimer.setSingleShot(true);
         connect(&m_updatedTimer, &QTimer::timeout, this, &Private::fireUpdate);
+
+        connect(&m_strengthFilter, &util::StrengthFilter::valueChanged, this, &Private::strengthFiltered);
     }
 
 public Q_SLOTS:
@@ -247,7 +252,7 @@ public Q_SLOTS:
 
             connect(m_networkRegistration.get(),
                     &QOfonoNetworkRegistration::strengthChanged, this,
-                    &Private::update);
+                    &Private::strengthChanged);
         }
 
         update();
@@ -391,13 +396,13 @@ public Q_SLOTS:
         {
             setOperatorName(m_networkRegistration->name());
             setStatus(str2status(m_networkRegistration->status()));
-            setStrength((int8_t)m_networkRegistration->strength());
+            filterStrength((int8_t)m_networkRegistration->strength());
         }
         else
         {
             setOperatorName("");
             setStatus(Modem::ModemStatus::unknown);
-            setStrength(-1);
+            filterStrength(-1);
         }
 
         if (m_connectionManager)
@@ -414,6 +419,36 @@ public Q_SLOTS:
         m_updatedTimer.start();
     }
 
+    void strengthChanged(uint strength)
+    {
+        // Only strength changes that make it through the filter
+        // result in an update
+        filterStrength((int8_t)strength);
+    }
+
+    void strengthFiltered(double strength)
+    {
+        setStrength((int8_t)strength);
+        m_updatedTimer.start();
+    }
+
+    void filterStrength(int8_t strength)
+    {
+        // Losing or regaining the signal is shown straight away
+        if (strength <= 0 || m_strength <= 0)
+        {
+            m_strengthFilter.reset(strength);
+            if (strength != m_strength)
+            {
+                setStrength(strength);
+                m_updatedTimer.start();
+            }
+            return;
+        }
+
+        m_strengthFilter.update(strength);
+    }
+
     void enterPinComplete(QOfonoSimManager::Error error, const QString &errorString)
     {
         if (error == QOfonoSimManager::Error::NoError)
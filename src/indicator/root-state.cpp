@@ -36,6 +36,33 @@ class RootState::Private : public QObject
     Q_OBJECT
 
 public:
+    /// What a single modem contributes to the root state
+    struct ModemIcons
+    {
+        wwan::Modem::Ptr modem;
+        int index = -1;
+        QString cellularIcon;
+        QString techIcon;
+        bool dataEnabled = false;
+        bool roaming = false;
+
+        bool operator==(const ModemIcons& other) const
+        {
+            return index == other.index
+                    && cellularIcon == other.cellularIcon
+                    && techIcon == other.techIcon
+                    && dataEnabled == other.dataEnabled
+                    && roaming == other.roaming;
+        }
+    };
+
+    /// What a single Wi-Fi link contributes to the root state
+    struct WifiIcon
+    {
+        wifi::WifiLink::Ptr link;
+        QString icon;
+    };
+
     RootState& p;
 
     Manager::Ptr m_manager;
@@ -43,22 +70,34 @@ public:
 
     string m_label;
 
+    QMap<const wwan::Modem*, ModemIcons> m_modems;
+
+    QMap<const wifi::WifiLink*, WifiIcon> m_wifiLinks;
+
     QStringList m_networkingIcons;
 
-    QMap<int, QString> m_cellularIcons;
-    QMap<int, QString> m_modemTechIcons;
+    // inputs of the last published state
+    vector<string> m_icons;
+    QString m_icon;
+    bool m_stateValid = false;
 
-    int m_activeModem = -1;
+    QHash<QString, Variant> m_iconCache;
 
     Private(RootState& parent, nmofono::Manager::Ptr manager);
 
-    Variant createIcon(const string& name);
+    Variant createIcon(const QString& name);
 
-    void updateModems();
+    ModemIcons modemIcons(const wwan::Modem& modem) const;
 
-    void updateModem(const wwan::Modem& modem);
+    QString wifiIcon(const wifi::WifiLink& link) const;
 
 public Q_SLOTS:
+    void linksUpdated();
+
+    void modemUpdated(const wwan::Modem& modem);
+
+    void wifiLinkUpdated(const wifi::WifiLink& link);
+
     void updateNetworkingIcon();
 
     void updateRootState();
@@ -72,54 +111,84 @@ RootState::Private::Private(RootState& parent, nmofono::Manager::Ptr manager)
 
     connect(m_manager.get(), &nmofono::Manager::hotspotEnabledChanged, this, &Private::updateNetworkingIcon);
     connect(m_manager.get(), &Manager::statusUpdated, this, &Private::updateNetworkingIcon);
-    connect(m_manager.get(), &Manager::linksUpdated, this, &Private::updateNetworkingIcon);
+    connect(m_manager.get(), &Manager::linksUpdated, this, &Private::linksUpdated);
 
-    // will also call updateRootState()
-    updateNetworkingIcon();
+    // will also call updateNetworkingIcon() and updateRootState()
+    linksUpdated();
 }
 
 void
-RootState::Private::updateModems()
+RootState::Private::linksUpdated()
 {
-    QMap<int, wwan::Modem::Ptr> modems;
-    for (auto modem : m_manager->modemLinks())
+    auto modems = m_manager->modemLinks();
+    QSet<const wwan::Modem*> currentModems;
+    for (const auto& modem : modems)
     {
-        modems[modem->index()] = modem;
+        currentModems << modem.get();
     }
 
-    QSet<int> current = m_cellularIcons.keys().toSet();
-    QSet<int> updated = modems.keys().toSet();
-
-    QSet<int> removed(current);
-    removed.subtract(updated);
+    for (auto it = m_modems.begin(); it != m_modems.end();)
+    {
+        if (currentModems.contains(it.key()))
+        {
+            ++it;
+            continue;
+        }
+        it->modem->disconnect(this);
+        it = m_modems.erase(it);
+    }
 
-    QSet<int> added(updated);
-    added.subtract(current);
+    for (const auto& modem : modems)
+    {
+        if (m_modems.contains(modem.get()))
+        {
+            continue;
+        }
+        // modem properties and signals already synced with GMainLoop
+        connect(modem.get(), &wwan::Modem::updated, this, &Private::modemUpdated);
+        auto icons = modemIcons(*modem);
+        icons.modem = modem;
+        m_modems.insert(modem.get(), icons);
+    }
 
-    for (auto index : removed)
+    auto wifiLinks = m_manager->wifiLinks();
+    QSet<const wifi::WifiLink*> currentWifiLinks;
+    for (const auto& link : wifiLinks)
     {
-        m_cellularIcons.remove(index);
+        currentWifiLinks << link.get();
     }
 
-    for (auto index : added) {
-        // modem properties and signals already synced with GMainLoop
-        connect(modems[index].get(), &wwan::Modem::updated, this, &Private::updateNetworkingIcon);
+    for (auto it = m_wifiLinks.begin(); it != m_wifiLinks.end();)
+    {
+        if (currentWifiLinks.contains(it.key()))
+        {
+            ++it;
+            continue;
+        }
+        it->link->disconnect(this);
+        it = m_wifiLinks.erase(it);
     }
 
-    m_activeModem = -1;
-    for (auto modem : modems)
+    for (const auto& link : wifiLinks)
     {
-        updateModem(*modem);
+        if (m_wifiLinks.contains(link.get()))
+        {
+            continue;
+        }
+        auto l = link.get();
+        connect(l, &wifi::WifiLink::statusUpdated, this, [this, l]() { wifiLinkUpdated(*l); });
+        connect(l, &wifi::WifiLink::signalUpdated, this, [this, l]() { wifiLinkUpdated(*l); });
+        m_wifiLinks.insert(link.get(), {link, wifiIcon(*link)});
     }
+
+    updateNetworkingIcon();
 }
 
-void
-RootState::Private::updateModem(const wwan::Modem& modem)
+RootState::Private::ModemIcons
+RootState::Private::modemIcons(const wwan::Modem& modem) const
 {
-    int index = modem.index();
-
-    QString newModemTechIcon;
-    QString newCellularIcon;
+    ModemIcons icons;
+    icons.index = modem.index();
 
     if (modem.online())
     {
@@ -129,11 +198,11 @@ RootState::Private::updateModem(const wwan::Modem& modem)
             // no need to show anything in the panel
             break;
         case wwan::Modem::SimStatus::error:
-            newCellularIcon = "simcard-error";
+            icons.cellularIcon = "simcard-error";
             break;
         case wwan::Modem::SimStatus::locked:
         case wwan::Modem::SimStatus::permanentlyLocked:
-            newCellularIcon = "simcard-locked";
+            icons.cellularIcon = "simcard-locked";
             break;
         case wwan::Modem::SimStatus::ready:
         {
@@ -142,19 +211,19 @@ RootState::Private::updateModem(const wwan::Modem& modem)
             case wwan::Modem::ModemStatus::unregistered:
             case wwan::Modem::ModemStatus::unknown:
             case wwan::Modem::ModemStatus::searching:
-                newCellularIcon = "gsm-3g-disabled";
+                icons.cellularIcon = "gsm-3g-disabled";
                 break;
             case wwan::Modem::ModemStatus::denied:
                 /// @todo we might need network-error for this
-                newCellularIcon = "gsm-3g-disabled";
+                icons.cellularIcon = "gsm-3g-disabled";
                 break;
             case wwan::Modem::ModemStatus::registered:
             case wwan::Modem::ModemStatus::roaming:
                 if (modem.strength() != 0) {
-                    newCellularIcon = Icons::strengthIcon(modem.strength());
-                    newModemTechIcon = Icons::bearerIcon(modem.bearer());
+                    icons.cellularIcon = Icons::strengthIcon(modem.strength());
+                    icons.techIcon = Icons::bearerIcon(modem.bearer());
                 } else {
-                    newCellularIcon = "gsm-3g-no-service";
+                    icons.cellularIcon = "gsm-3g-no-service";
                 }
                 break;
             }
@@ -166,81 +235,139 @@ RootState::Private::updateModem(const wwan::Modem& modem)
         }
     }
 
-    m_cellularIcons[index] = newCellularIcon;
-    m_modemTechIcons[index] = newModemTechIcon;
+    icons.dataEnabled = modem.dataEnabled();
+    // feeds into Manager::roaming()
+    icons.roaming = modem.modemStatus() == wwan::Modem::ModemStatus::roaming;
+
+    return icons;
+}
 
-    if (modem.dataEnabled())
+void
+RootState::Private::modemUpdated(const wwan::Modem& modem)
+{
+    auto it = m_modems.find(&modem);
+    if (it == m_modems.end())
     {
-        m_activeModem = index;
+        return;
+    }
+
+    auto icons = modemIcons(modem);
+    if (icons == *it)
+    {
+        return;
     }
+
+    icons.modem = it->modem;
+    *it = icons;
+
+    updateNetworkingIcon();
+}
+
+QString
+RootState::Private::wifiIcon(const wifi::WifiLink& link) const
+{
+    if (link.status() != Link::Status::online
+            && link.status() != Link::Status::connected)
+    {
+        return QString();
+    }
+
+    auto signal = link.signal();
+    if (signal == wifi::WifiLink::Signal::disconnected)
+    {
+        return QString();
+    }
+
+    return Icons::wifiIcon(signal);
 }
 
 void
-RootState::Private::updateNetworkingIcon()
+RootState::Private::wifiLinkUpdated(const wifi::WifiLink& link)
 {
-    m_networkingIcons.clear();
+    auto it = m_wifiLinks.find(&link);
+    if (it == m_wifiLinks.end())
+    {
+        return;
+    }
 
-    updateModems();
+    auto icon = wifiIcon(link);
+    if (icon == it->icon)
+    {
+        return;
+    }
+
+    it->icon = icon;
+    updateNetworkingIcon();
+}
+
+void
+RootState::Private::updateNetworkingIcon()
+{
+    QStringList networkingIcons;
 
     switch (m_manager->status()) {
     case Manager::NetworkingStatus::offline:
-        m_networkingIcons << "nm-no-connection";
+        networkingIcons << "nm-no-connection";
         //a11ydesc = _("Network (none)");
         break;
     case Manager::NetworkingStatus::connecting:
-        m_networkingIcons << "nm-no-connection";
+        networkingIcons << "nm-no-connection";
         // some sort of connection animation
         break;
     case Manager::NetworkingStatus::online:
-        for (auto wifiLink : m_manager->wifiLinks())
+        for (const auto& wifiLink : m_wifiLinks)
         {
-            connect(wifiLink.get(), &wifi::WifiLink::statusUpdated, this,
-                    &Private::updateNetworkingIcon, Qt::UniqueConnection);
-            connect(wifiLink.get(), &wifi::WifiLink::signalUpdated, this,
-                    &Private::updateNetworkingIcon, Qt::UniqueConnection);
-
-            if (wifiLink->status() != Link::Status::online
-                    && wifiLink->status() != Link::Status::connected)
-            {
-                continue;
-            }
-
-            auto signal = wifiLink->signal();
-            if (signal != wifi::WifiLink::Signal::disconnected)
+            if (!wifiLink.icon.isEmpty())
             {
-                m_networkingIcons << Icons::wifiIcon(signal);
+                networkingIcons << wifiLink.icon;
             }
         }
 
         // Splat WiFi icons if we are using the hotspot
-        if (m_networkingIcons.isEmpty() || m_manager->hotspotEnabled())
+        if (networkingIcons.isEmpty() || m_manager->hotspotEnabled())
         {
-            m_networkingIcons.clear();
+            networkingIcons.clear();
 
-            if (m_activeModem != -1) {
-                auto it = m_modemTechIcons.find(m_activeModem);
-                if (it != m_modemTechIcons.end())
+            // the data enabled modem with the highest index wins
+            const ModemIcons* activeModem = nullptr;
+            for (const auto& modem : m_modems)
+            {
+                if (modem.dataEnabled
+                        && (!activeModem || modem.index >= activeModem->index))
                 {
-                    m_networkingIcons << it.value();
+                    activeModem = &modem;
                 }
             }
+
+            if (activeModem)
+            {
+                networkingIcons << activeModem->techIcon;
+            }
         }
 
         if (m_manager->hotspotEnabled())
         {
-            m_networkingIcons << "hotspot-active";
+            networkingIcons << "hotspot-active";
         }
         break;
     }
 
+    m_networkingIcons = networkingIcons;
+
     updateRootState();
 }
 
 Variant
-RootState::Private::createIcon(const string& name)
+RootState::Private::createIcon(const QString& name)
 {
+    auto it = m_iconCache.constFind(name);
+    if (it != m_iconCache.constEnd())
+    {
+        return *it;
+    }
+
     GError *error = nullptr;
-    auto gicon = shared_ptr<GIcon>(g_icon_new_for_string(name.c_str(), &error), GObjectDeleter());
+    auto gicon = shared_ptr<GIcon>(g_icon_new_for_string(name.toUtf8().constData(), &error), GObjectDeleter());
     if (error) {
         string message(error->message);
         g_error_free(error);
@@ -248,6 +375,7 @@ RootState::Private::createIcon(const string& name)
     }
 
     Variant ret = Variant::fromGVariant(g_icon_serialize(gicon.get()));
+    m_iconCache.insert(name, ret);
     return ret;
 }
 
@@ -255,7 +383,6 @@ void
 RootState::Private::updateRootState()
 {
     vector<string> icons;
-    map<string, Variant> state;
 
     if(m_manager->flightMode())
     {
@@ -263,10 +390,9 @@ RootState::Private::updateRootState()
     }
 
     multimap<int, QString, wwan::WwanLink::Compare> sorted;
-    QMapIterator<int, QString> iconIt(m_cellularIcons);
-    while (iconIt.hasNext()) {
-        iconIt.next();
-        sorted.insert(make_pair(iconIt.key(), iconIt.value()));
+    for (const auto& modem : m_modems)
+    {
+        sorted.insert(make_pair(modem.index, modem.cellularIcon));
     }
 
     for (auto pair : sorted)
@@ -282,19 +408,32 @@ RootState::Private::updateRootState()
         icons.push_back("network-cellular-roaming");
     }
 
-    if (!m_networkingIcons.isEmpty()) {
+    for (const auto& icon: m_networkingIcons)
+    {
+        icons.push_back(icon.toStdString());
+    }
+
+    // Everything else in the state is constant, apart from "icon", which
+    // can change on its own when an icon moves between the groups above
+    QString icon = m_networkingIcons.isEmpty() ? QString() : m_networkingIcons.first();
+    if (m_stateValid && icons == m_icons && icon == m_icon)
+    {
+        return;
+    }
+    m_icons = icons;
+    m_icon = icon;
+    m_stateValid = true;
+
+    map<string, Variant> state;
+
+    if (!icon.isEmpty()) {
         /* We're doing icon always right now so we have a fallback before everyone
            supports multi-icon.  We shouldn't set both in the future. */
         try {
-            state["icon"] = createIcon(m_networkingIcons.first().toStdString());
+            state["icon"] = createIcon(icon);
         } catch (exception &e) {
             qWarning() << e.what();
         }
-
-        for (const auto& icon: m_networkingIcons)
-        {
-            icons.push_back(icon.toStdString());
-        }
     }
 
     if (!m_label.empty())
@@ -311,9 +450,9 @@ RootState::Private::updateRootState()
 
     if (!icons.empty()) {
         vector<Variant> iconVariants;
-        for (auto name : icons) {
+        for (const auto& name : icons) {
             try {
-                iconVariants.push_back(createIcon(name));
+                iconVariants.push_back(createIcon(QString::fromStdString(name)));
             } catch (exception &e) {
                 cerr << e.what();
             }
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <section-tree.h>
+
+#include <menumodel-cpp/menu-merger.h>
+#include <menumodel-cpp/action-group-merger.h>
+
+#include <vector>
+
+using namespace std;
+
+struct SectionTree::Private
+{
+    MenuMerger::Ptr m_menuMerger = make_shared<MenuMerger>();
+
+    ActionGroupMerger::Ptr m_actionGroupMerger = make_shared<ActionGroupMerger>();
+
+    vector<Section::Ptr> m_sections;
+};
+
+SectionTree::SectionTree()
+    : d(new Private)
+{
+}
+
+SectionTree::~SectionTree()
+{
+}
+
+void
+SectionTree::addSection(Section::Ptr section)
+{
+    d->m_sections.push_back(section);
+    d->m_actionGroupMerger->add(section->actionGroup());
+    d->m_menuMerger->append(section->menuModel());
+}
+
+ActionGroup::Ptr
+SectionTree::actionGroup()
+{
+    return d->m_actionGroupMerger->actionGroup();
+}
+
+MenuModel::Ptr
+SectionTree::menuModel()
+{
+    return d->m_menuMerger;
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <menuitems/section.h>
+
+#include <memory>
+
+/**
+ * Merges several sections into one, so that menu profiles showing the
+ * same sections can share a single menu and action group tree.
+ */
+class SectionTree : public Section
+{
+public:
+    typedef std::shared_ptr<SectionTree> Ptr;
+
+    SectionTree();
+
+    virtual ~SectionTree();
+
+    void addSection(Section::Ptr section);
+
+    ActionGroup::Ptr actionGroup() override;
+
+    MenuModel::Ptr menuModel() override;
+
+private:
+    struct Private;
+    std::shared_ptr<Private> d;
+};
@@ -33,6 +33,35 @@
 
 using namespace nmofono;
 
+namespace
+{
+
+static const char* SETTINGS_SCHEMA = "com.canonical.indicator.network";
+static const char* MAX_VISIBLE_ACCESS_POINTS = "max-visible-access-points";
+
+/// the schema default, for when it is not installed
+static const int DEFAULT_MAX_VISIBLE_ACCESS_POINTS = 20;
+
+int maximumVisibleAccessPoints()
+{
+    auto source = g_settings_schema_source_get_default();
+    if (!source) {
+        return DEFAULT_MAX_VISIBLE_ACCESS_POINTS;
+    }
+
+    std::shared_ptr<GSettingsSchema> schema(
+            g_settings_schema_source_lookup(source, SETTINGS_SCHEMA, TRUE),
+            [](GSettingsSchema* schema) { if (schema) g_settings_schema_unref(schema); });
+    if (!schema || !g_settings_schema_has_key(schema.get(), MAX_VISIBLE_ACCESS_POINTS)) {
+        return DEFAULT_MAX_VISIBLE_ACCESS_POINTS;
+    }
+
+    std::shared_ptr<GSettings> settings(g_settings_new(SETTINGS_SCHEMA), GObjectDeleter());
+    return g_settings_get_int(settings.get(), MAX_VISIBLE_ACCESS_POINTS);
+}
+
+}
+
 class WifiSection::Private : public QObject
 {
     Q_OBJECT
@@ -94,7 +123,7 @@ public Q_SLOTS:
         }
 
         for (auto wifi_link : m_manager->wifiLinks()) {
-            m_wifiLink = std::make_shared<WifiLinkItem>(wifi_link);
+            m_wifiLink = std::make_shared<WifiLinkItem>(wifi_link, maximumVisibleAccessPoints());
 
             m_actionGroupMerger->add(m_wifiLink->actionGroup());
             auto comp = [this](MenuItem::Ptr, MenuItem::Ptr other)
@@ -22,42 +22,40 @@
 
 void ActionGroupMerger::addAction(Action::Ptr action)
 {
-    auto name_iter = m_names.find(action->name());
-    if (name_iter != m_names.end()) {
-        // we have two actions with the same name.
-        // If they are from the same shared pointer, everything is OK and
-        // count is incremented below, but if they have different pointer
-        // then they will override each other in GActionGroup so let's catch that
-        // early on.
-        if (name_iter->second != action) {
-            qWarning() << "Conflicting action names. \"" << action->name() << "\"";
-            /// @todo thow something.
-            return;
-        }
-    } else {
-        m_names[action->name()] = action;
+    auto iter = m_actions.find(action->name());
+    if (iter == m_actions.end()) {
+        m_actions.insert(action->name(), {action, 1});
+        m_actionGroup->add(action);
+        return;
     }
 
-    auto count_iter = m_count.find(action);
-    if (count_iter != m_count.end()) {
-        count_iter->second += 1;
-    } else {
-        m_count[action] = 1;
-        m_actionGroup->add(action);
+    // we have two actions with the same name.
+    // If they are from the same shared pointer, everything is OK and
+    // count is incremented, but if they have different pointer
+    // then they will override each other in GActionGroup so let's catch that
+    // early on.
+    if (iter->action != action) {
+        qWarning() << "Conflicting action names. \"" << action->name() << "\"";
+        /// @todo thow something.
+        return;
     }
+    iter->count += 1;
 }
 
 void ActionGroupMerger::removeAction(Action::Ptr action)
 {
-    auto count_iter = m_count.find(action);
+    auto iter = m_actions.find(action->name());
     // it should not be possible for this function to be called for an action that
     // was not added before
-    assert(count_iter != m_count.end());
-    count_iter->second -= 1;
-    if (count_iter->second == 0) {
+    assert(iter != m_actions.end());
+    if (iter->action != action) {
+        // lost a name conflict in addAction()
+        return;
+    }
+    iter->count -= 1;
+    if (iter->count == 0) {
+        m_actions.erase(iter);
         m_actionGroup->remove(action);
-        m_names.erase(action->name());
-        m_count.erase(count_iter);
     }
 }
 
@@ -70,35 +68,33 @@ ActionGroupMerger::ActionGroupMerger(const std::string &prefix)
 
 void ActionGroupMerger::add(ActionGroup::Ptr group)
 {
-    auto iter = m_groups.find(group);
-    if (iter != m_groups.end()) {
+    if (m_groups.contains(group.get())) {
         /// @todo throw something.
         qWarning() << "Trying to add action group which was already added before.";
         return;
     }
 
-    for (auto action : group->actions()) {
+    for (const auto& action : group->actions()) {
         addAction(action);
     }
 
     auto added = connect(group.get(), &ActionGroup::actionAdded, this, &ActionGroupMerger::addAction);
     auto removed = connect(group.get(), &ActionGroup::actionRemoved, this, &ActionGroupMerger::removeAction);
-    m_groups[group] = std::make_pair(added, removed);
+    m_groups.insert(group.get(), std::make_pair(added, removed));
 }
 
 void ActionGroupMerger::remove(ActionGroup::Ptr group)
 {
-    auto iter = m_groups.find(group);
+    auto iter = m_groups.find(group.get());
     if (iter == m_groups.end()) {
         /// @todo throw something.
         qWarning() << "Trying to remove action group which was not added before.";
         return;
     }
-    auto connections = m_groups[group];
-    disconnect(connections.first);
-    disconnect(connections.second);
-    m_groups.erase(group);
-    for (auto action : group->actions()) {
+    disconnect(iter->first);
+    disconnect(iter->second);
+    m_groups.erase(iter);
+    for (const auto& action : group->actions()) {
         removeAction(action);
     }
 }
@@ -24,21 +24,26 @@
 
 #include "gio-helpers/util.h"
 #include "action-group.h"
-#include <set>
-#include <map>
+#include <QHash>
 #include <QObject>
 
 class ActionGroupMerger: public QObject
 {
     Q_OBJECT
 
+    struct Entry
+    {
+        Action::Ptr action;
+        // number of merged groups containing the action
+        int count;
+    };
+
     std::string m_prefix;
     ActionGroup::Ptr m_actionGroup;
 
-    std::map<ActionGroup::Ptr, std::pair<QMetaObject::Connection, QMetaObject::Connection>> m_groups;
+    QHash<const ActionGroup*, std::pair<QMetaObject::Connection, QMetaObject::Connection>> m_groups;
 
-    std::map<Action::Ptr, int> m_count;
-    std::map<QString, Action::Ptr> m_names;
+    QHash<QString, Entry> m_actions;
 
 private Q_SLOTS:
     void addAction(Action::Ptr action);
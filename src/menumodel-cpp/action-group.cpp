@@ -24,36 +24,46 @@ ActionGroup::ActionGroup()
 {
 }
 
-std::set<Action::Ptr> ActionGroup::actions()
+const ActionGroup::Actions& ActionGroup::actions() const
 {
     return m_actions;
 }
 
+Action::Ptr ActionGroup::action(const QString& name) const
+{
+    return m_actions.value(name);
+}
+
 void ActionGroup::add(Action::Ptr action)
 {
-    auto iter = m_actions.find(action);
-    if (iter != m_actions.end()) {
+    auto iter = m_actions.constFind(action->name());
+    if (iter != m_actions.constEnd()) {
         /// @todo throw something.
-        std::cerr << "Trying to add action which was already added before." << std::endl;
+        if (*iter == action) {
+            std::cerr << "Trying to add action which was already added before." << std::endl;
+        } else {
+            std::cerr << "Trying to add action with a conflicting name." << std::endl;
+        }
         return;
     }
-    m_actions.insert(action);
+    m_actions.insert(action->name(), action);
     Q_EMIT actionAdded(action);
 }
 
 void ActionGroup::remove(Action::Ptr action)
 {
-    auto iter = m_actions.find(action);
-    if (iter == m_actions.end()) {
+    auto iter = m_actions.find(action->name());
+    if (iter == m_actions.end() || *iter != action) {
         /// @todo throw something.
         std::cerr << "Trying to remove action which was not added before." << std::endl;
         return;
     }
     Q_EMIT actionRemoved(action);
-    m_actions.erase(action);
+    m_actions.remove(action->name());
 }
 
-bool ActionGroup::contains(Action::Ptr action)
+bool ActionGroup::contains(Action::Ptr action) const
 {
-    return m_actions.find(action) != m_actions.end();
+    auto iter = m_actions.constFind(action->name());
+    return iter != m_actions.constEnd() && *iter == action;
 }
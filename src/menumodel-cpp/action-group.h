@@ -23,30 +23,38 @@
 #include "gio-helpers/util.h"
 
 #include <memory>
-#include <set>
+#include <QHash>
 #include <QObject>
 
 class ActionGroup: public QObject
 {
     Q_OBJECT
 
-    std::set<Action::Ptr> m_actions;
-
 public:
     typedef std::shared_ptr<ActionGroup> Ptr;
 
+    /// iterates over the actions
+    typedef QHash<QString, Action::Ptr> Actions;
+
     ActionGroup();
 
-    std::set<Action::Ptr> actions();
+    /// a view of the actions, only valid until the group changes
+    const Actions& actions() const;
+
+    /// the action with the given name, or null if there is none
+    Action::Ptr action(const QString& name) const;
 
     void add(Action::Ptr action);
 
     void remove(Action::Ptr action);
 
-    bool contains(Action::Ptr action);
+    bool contains(Action::Ptr action) const;
 
 Q_SIGNALS:
     void actionAdded(Action::Ptr);
 
     void actionRemoved(Action::Ptr);
+
+private:
+    Actions m_actions;
 };
@@ -46,7 +46,8 @@ Action::change_state_cb(GSimpleAction *,
 Action::Action(const QString &name, const
        GVariantType *parameterType,
        const Variant &state)
-    : m_name {name}
+    : m_name {name},
+      m_state {state}
 {
     /// @todo validate that name is valid.
 
@@ -99,21 +100,21 @@ Action::setEnabled(bool enabled)
 void
 Action::setState(const Variant &value)
 {
-    if (value == state())
+    if (value == m_state)
     {
         return;
     }
 
     g_simple_action_set_state(G_SIMPLE_ACTION(m_gaction.get()), value);
+    m_state = value;
 
-    Q_EMIT stateUpdated(state());
+    Q_EMIT stateUpdated(m_state);
 }
 
 Variant
 Action::state()
 {
-    return Variant::fromGVariant(
-            g_action_get_state(G_ACTION(m_gaction.get())));
+    return m_state;
 }
 
 Action::GActionPtr
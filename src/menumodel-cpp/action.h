@@ -37,6 +37,8 @@ class Action: public QObject
 
     GActionPtr m_gaction;
     QString m_name;
+    // mirrors the state of m_gaction
+    Variant m_state;
     gulong m_activateHandlerId;
     gulong m_changeStateHandlerId;
 
@@ -47,6 +49,7 @@ class Action: public QObject
     static void change_state_cb(GSimpleAction *,
                                 GVariant      *value,
                                 gpointer       user_data);
+
 public:
     typedef std::shared_ptr<Action> Ptr;
 
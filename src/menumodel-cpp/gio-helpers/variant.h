@@ -103,13 +103,13 @@ public:
             return false;
         }
 
-        if (g_variant_is_container(m_variant.get()) || g_variant_is_container(rhs.m_variant.get()))
+        if (m_variant == rhs.m_variant)
         {
-            // Compare by string
-            return to_string(true) == rhs.to_string(true);
+            return true;
         }
 
-        return g_variant_compare(m_variant.get(), rhs.m_variant.get()) == 0;
+        // Compares the types and the serialised data
+        return g_variant_equal(m_variant.get(), rhs.m_variant.get());
     }
 
     bool operator!=(const Variant &rhs) const
@@ -117,6 +117,26 @@ public:
         return !(*this == rhs);
     }
 
+    /// consistent with operator==
+    std::size_t hash() const
+    {
+        if (!m_variant)
+        {
+            return 0;
+        }
+
+        if (!g_variant_is_container(m_variant.get()))
+        {
+            return g_variant_hash(m_variant.get());
+        }
+
+        // g_variant_hash() only supports basic types
+        auto bytes = g_variant_get_data_as_bytes(m_variant.get());
+        std::size_t result = g_bytes_hash(bytes);
+        g_bytes_unref(bytes);
+        return result * 31 + g_str_hash(g_variant_get_type_string(m_variant.get()));
+    }
+
     std::string to_string(bool type_annotate = false) const
     {
         if (m_variant.get())
@@ -140,6 +160,18 @@ protected:
     GVariantPtr m_variant;
 };
 
+namespace std
+{
+template<>
+struct hash<Variant>
+{
+    std::size_t operator()(const Variant& variant) const
+    {
+        return variant.hash();
+    }
+};
+}
+
 template<typename T>
 class TypedVariant : public Variant
 {
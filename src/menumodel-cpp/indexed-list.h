@@ -0,0 +1,317 @@
+/*
+ * Copyright © 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *     Antti Kaijanmäki <antti.kaijanmaki@canonical.com>
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <random>
+
+/**
+ * Sequence container with stable iterators and logarithmic positional access.
+ *
+ * Elements are kept in an implicit treap (a randomized balanced tree ordered
+ * by position) where every node knows the size of its subtree. This makes
+ * insert(), erase() and index() O(log n) while iterators stay valid until
+ * the element they point to is erased, just like with std::list.
+ */
+template<typename T>
+class IndexedList
+{
+    struct Node
+    {
+        explicit Node(const T &value_, unsigned priority_)
+            : value {value_},
+              priority {priority_}
+        {}
+
+        T value;
+        unsigned priority;
+        std::size_t size = 1;
+        Node *left = nullptr;
+        Node *right = nullptr;
+        Node *parent = nullptr;
+    };
+
+    Node *m_root = nullptr;
+    std::minstd_rand m_random;
+
+    static std::size_t size(Node *node)
+    {
+        return node ? node->size : 0;
+    }
+
+    static void update(Node *node)
+    {
+        node->size = 1 + size(node->left) + size(node->right);
+        if (node->left)
+            node->left->parent = node;
+        if (node->right)
+            node->right->parent = node;
+    }
+
+    static Node *leftmost(Node *node)
+    {
+        while (node && node->left)
+            node = node->left;
+        return node;
+    }
+
+    static Node *rightmost(Node *node)
+    {
+        while (node && node->right)
+            node = node->right;
+        return node;
+    }
+
+    // splits the tree so that the first count elements end up in left
+    static void split(Node *node, std::size_t count, Node *&left, Node *&right)
+    {
+        if (!node) {
+            left = right = nullptr;
+            return;
+        }
+        if (size(node->left) < count) {
+            split(node->right, count - size(node->left) - 1, node->right, right);
+            left = node;
+        } else {
+            split(node->left, count, left, node->left);
+            right = node;
+        }
+        update(node);
+    }
+
+    static Node *merge(Node *left, Node *right)
+    {
+        if (!left)
+            return right;
+        if (!right)
+            return left;
+        if (left->priority > right->priority) {
+            left->right = merge(left->right, right);
+            update(left);
+            return left;
+        }
+        right->left = merge(left, right->left);
+        update(right);
+        return right;
+    }
+
+    static void destroy(Node *node)
+    {
+        if (!node)
+            return;
+        destroy(node->left);
+        destroy(node->right);
+        delete node;
+    }
+
+    void setRoot(Node *root)
+    {
+        m_root = root;
+        if (m_root)
+            m_root->parent = nullptr;
+    }
+
+public:
+    class iterator
+    {
+        friend class IndexedList;
+
+        const IndexedList *m_list = nullptr;
+        Node *m_node = nullptr;
+
+        iterator(const IndexedList *list, Node *node)
+            : m_list {list},
+              m_node {node}
+        {}
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef T* pointer;
+        typedef T& reference;
+
+        iterator() = default;
+
+        T &operator*() const { return m_node->value; }
+        T *operator->() const { return &m_node->value; }
+
+        iterator &operator++()
+        {
+            if (m_node->right) {
+                m_node = leftmost(m_node->right);
+                return *this;
+            }
+            Node *parent = m_node->parent;
+            while (parent && m_node == parent->right) {
+                m_node = parent;
+                parent = parent->parent;
+            }
+            m_node = parent;
+            return *this;
+        }
+
+        iterator &operator--()
+        {
+            if (!m_node) {
+                m_node = rightmost(m_list->m_root);
+                return *this;
+            }
+            if (m_node->left) {
+                m_node = rightmost(m_node->left);
+                return *this;
+            }
+            Node *parent = m_node->parent;
+            while (parent && m_node == parent->left) {
+                m_node = parent;
+                parent = parent->parent;
+            }
+            m_node = parent;
+            return *this;
+        }
+
+        iterator operator++(int) { iterator tmp = *this; ++*this; return tmp; }
+        iterator operator--(int) { iterator tmp = *this; --*this; return tmp; }
+
+        bool operator==(const iterator &other) const { return m_node == other.m_node; }
+        bool operator!=(const iterator &other) const { return m_node != other.m_node; }
+    };
+
+    IndexedList() = default;
+
+    IndexedList(const IndexedList &) = delete;
+    IndexedList &operator=(const IndexedList &) = delete;
+
+    ~IndexedList()
+    {
+        clear();
+    }
+
+    std::size_t size() const
+    {
+        return size(m_root);
+    }
+
+    bool empty() const
+    {
+        return m_root == nullptr;
+    }
+
+    iterator begin() const
+    {
+        return iterator(this, leftmost(m_root));
+    }
+
+    iterator end() const
+    {
+        return iterator(this, nullptr);
+    }
+
+    /// position of the element pointed to by iter, or size() for end()
+    std::size_t index(iterator iter) const
+    {
+        Node *node = iter.m_node;
+        if (!node)
+            return size();
+
+        std::size_t result = size(node->left);
+        while (node->parent) {
+            if (node == node->parent->right)
+                result += size(node->parent->left) + 1;
+            node = node->parent;
+        }
+        return result;
+    }
+
+    /// element at position index, which has to be less than size()
+    T &at(std::size_t index) const
+    {
+        Node *node = m_root;
+        assert(index < size());
+        while (size(node->left) != index) {
+            if (index < size(node->left)) {
+                node = node->left;
+            } else {
+                index -= size(node->left) + 1;
+                node = node->right;
+            }
+        }
+        return node->value;
+    }
+
+    /// inserts value before position and returns an iterator to it
+    iterator insert(iterator position, const T &value)
+    {
+        Node *node = new Node(value, m_random());
+
+        Node *left, *right;
+        split(m_root, index(position), left, right);
+        setRoot(merge(merge(left, node), right));
+
+        return iterator(this, node);
+    }
+
+    /// removes the element and returns an iterator to the following one
+    iterator erase(iterator position)
+    {
+        assert(position.m_node);
+        iterator next = position;
+        ++next;
+
+        Node *left, *middle, *right;
+        split(m_root, index(position), left, right);
+        split(right, 1, middle, right);
+        assert(middle == position.m_node);
+        setRoot(merge(left, right));
+        delete middle;
+
+        return next;
+    }
+
+    /**
+     * Returns the first element for which compare(value, element) is true.
+     *
+     * The elements must be partitioned with respect to that expression,
+     * which is the case if they were sorted using the same comparison.
+     */
+    template<typename Compare>
+    iterator upper_bound(const T &value, Compare compare) const
+    {
+        Node *node = m_root;
+        Node *result = nullptr;
+        while (node) {
+            if (compare(value, node->value)) {
+                result = node;
+                node = node->left;
+            } else {
+                node = node->right;
+            }
+        }
+        return iterator(this, result);
+    }
+
+    void clear()
+    {
+        destroy(m_root);
+        m_root = nullptr;
+    }
+};
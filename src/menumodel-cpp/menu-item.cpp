@@ -18,6 +18,7 @@
  */
 
 #include "menu-item.h"
+#include <QCollator>
 #include <QDebug>
 
 using namespace std;
@@ -62,11 +63,33 @@ QString MenuItem::label()
     return m_label;
 }
 
+const QCollatorSortKey& MenuItem::sortKey()
+{
+    if (!m_sortKey) {
+        // Takes the locale on first use, which is after main() set it up.
+        // Like the translated labels it does not follow later changes, the
+        // indicator is restarted with the session when the locale changes.
+        static QCollator collator = [] {
+            QCollator c;
+            c.setCaseSensitivity(Qt::CaseInsensitive);
+            return c;
+        }();
+        m_sortKey.reset(new QCollatorSortKey(collator.sortKey(m_label)));
+    }
+    return *m_sortKey;
+}
+
+bool MenuItem::labelLessThan(MenuItem::Ptr a, MenuItem::Ptr b)
+{
+    return a->sortKey().compare(b->sortKey()) < 0;
+}
+
 void MenuItem::setLabel(const QString &value)
 {
     if (m_label == value)
         return;
     m_label = value;
+    m_sortKey.reset();
     g_menu_item_set_label(m_gmenuitem.get(), m_label.toUtf8().constData());
     Q_EMIT changed();
 }
@@ -140,3 +163,17 @@ MenuItem::action () const
 {
     return m_action;
 }
+
+Variant
+MenuItem::snapshot() const
+{
+    std::map<std::string, Variant> values;
+    for (const auto& attribute : m_attributes) {
+        values[attribute.first.toStdString()] = attribute.second;
+    }
+    // not valid attribute names, so they cannot clash
+    values[":label"] = TypedVariant<std::string>(m_label.toStdString());
+    values[":action"] = TypedVariant<std::string>(m_action.toStdString());
+    values[":icon"] = TypedVariant<std::string>(m_icon.toStdString());
+    return TypedVariant<std::map<std::string, Variant>>(values);
+}
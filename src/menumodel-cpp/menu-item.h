@@ -29,6 +29,7 @@
 
 #include "menu-model.h"
 
+#include <QCollatorSortKey>
 #include <QObject>
 
 class MenuItem: public QObject
@@ -43,6 +44,9 @@ class MenuItem: public QObject
 
     std::map<QString, Variant> m_attributes;
 
+    // collation key of m_label, computed on first use
+    std::unique_ptr<QCollatorSortKey> m_sortKey;
+
 public:
     typedef std::shared_ptr<MenuItem> Ptr;
 
@@ -59,6 +63,13 @@ public:
 
     QString label();
 
+    /// for ordering by label according to the locale the process started
+    /// with, ignoring case
+    const QCollatorSortKey& sortKey();
+
+    /// compares the sort keys, usable with Menu::insert()
+    static bool labelLessThan(MenuItem::Ptr a, MenuItem::Ptr b);
+
     QString icon();
 
     void clearAttribute(const QString &attribute);
@@ -67,6 +78,9 @@ public:
 
     const QString& action () const;
 
+    /// everything the item exports, for telling whether it really changed
+    Variant snapshot() const;
+
 public Q_SLOTS:
     void setLabel(const QString &value);
 
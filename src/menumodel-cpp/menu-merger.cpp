@@ -0,0 +1,331 @@
+/*
+ * Copyright © 2014 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Authors:
+ *     Antti Kaijanmäki <antti.kaijanmaki@canonical.com>
+ */
+
+#include "menu-merger.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace
+{
+
+struct MergedItem
+{
+    shared_ptr<GHashTable> attributes;
+    shared_ptr<GHashTable> links;
+};
+
+/*
+ * GMenuModel implementation holding a snapshot of the merged items.
+ *
+ * GMenu emits "items-changed" for every single insert and remove, so it
+ * cannot be used to publish a whole range in one go. The snapshot is owned
+ * by the GObject so that it stays valid for as long as someone (e.g. the
+ * D-Bus exporter) keeps a reference to the model.
+ */
+typedef struct
+{
+    GMenuModel parent_instance;
+    vector<MergedItem> *items;
+} MergedMenuModel;
+
+typedef struct
+{
+    GMenuModelClass parent_class;
+} MergedMenuModelClass;
+
+G_DEFINE_TYPE(MergedMenuModel, merged_menu_model, G_TYPE_MENU_MODEL)
+
+vector<MergedItem> &
+merged_items(GMenuModel *model)
+{
+    return *reinterpret_cast<MergedMenuModel*>(model)->items;
+}
+
+gboolean
+merged_menu_model_is_mutable(GMenuModel *)
+{
+    return TRUE;
+}
+
+gint
+merged_menu_model_get_n_items(GMenuModel *model)
+{
+    return merged_items(model).size();
+}
+
+void
+merged_menu_model_get_item_attributes(GMenuModel *model,
+                                      gint        item_index,
+                                      GHashTable **attributes)
+{
+    *attributes = g_hash_table_ref(merged_items(model).at(item_index).attributes.get());
+}
+
+void
+merged_menu_model_get_item_links(GMenuModel *model,
+                                 gint        item_index,
+                                 GHashTable **links)
+{
+    *links = g_hash_table_ref(merged_items(model).at(item_index).links.get());
+}
+
+void
+merged_menu_model_finalize(GObject *object)
+{
+    delete reinterpret_cast<MergedMenuModel*>(object)->items;
+    G_OBJECT_CLASS(merged_menu_model_parent_class)->finalize(object);
+}
+
+void
+merged_menu_model_init(MergedMenuModel *self)
+{
+    self->items = new vector<MergedItem>();
+}
+
+void
+merged_menu_model_class_init(MergedMenuModelClass *klass)
+{
+    GMenuModelClass *model_class = G_MENU_MODEL_CLASS(klass);
+    model_class->is_mutable = merged_menu_model_is_mutable;
+    model_class->get_n_items = merged_menu_model_get_n_items;
+    model_class->get_item_attributes = merged_menu_model_get_item_attributes;
+    model_class->get_item_links = merged_menu_model_get_item_links;
+
+    G_OBJECT_CLASS(klass)->finalize = merged_menu_model_finalize;
+}
+
+// The tables handed out by GMenu (and by MergedMenuModel) are never modified
+// after the item has been inserted, so they can be shared instead of copied.
+MergedItem
+item_from_model(GMenuModel *model, int position)
+{
+    GMenuModelClass *model_class = G_MENU_MODEL_GET_CLASS(model);
+
+    GHashTable *attributes = nullptr;
+    GHashTable *links = nullptr;
+    model_class->get_item_attributes(model, position, &attributes);
+    model_class->get_item_links(model, position, &links);
+
+    return {
+        shared_ptr<GHashTable>(attributes, &g_hash_table_unref),
+        shared_ptr<GHashTable>(links, &g_hash_table_unref)
+    };
+}
+
+}
+
+void
+MenuMerger::items_changed_cb(GMenuModel *model,
+                             gint        position,
+                             gint        removed,
+                             gint        added,
+                             gpointer    user_data)
+{
+    MenuMerger *that = static_cast<MenuMerger*>(user_data);
+    that->itemsChanged(model, position, removed, added);
+}
+
+gboolean
+MenuMerger::flush_cb(gpointer user_data)
+{
+    MenuMerger *that = static_cast<MenuMerger*>(user_data);
+    that->m_flushId = 0;
+    that->flush();
+    return G_SOURCE_REMOVE;
+}
+
+MenuMerger::MenuMerger()
+    : m_offsets {0},
+      m_dirtyStart {-1},
+      m_dirtyTail {0},
+      m_flushId {0}
+{
+    m_gmodel = shared_ptr<GMenuModel>(
+            G_MENU_MODEL(g_object_new(merged_menu_model_get_type(), nullptr)),
+            GObjectDeleter());
+}
+
+MenuMerger::~MenuMerger()
+{
+    clear();
+}
+
+void
+MenuMerger::itemsChanged(GMenuModel *model,
+                         gint        position,
+                         gint        removed,
+                         gint        added)
+{
+    auto iter = find(m_gmodels.begin(), m_gmodels.end(), model);
+    if (iter == m_gmodels.end())
+    {
+        return;
+    }
+    size_t index = iter - m_gmodels.begin();
+
+    int delta = added - removed;
+    for (size_t i = index + 1; i < m_offsets.size(); ++i)
+    {
+        m_offsets[i] += delta;
+    }
+
+    markDirty(m_offsets[index] + position, added);
+    scheduleFlush();
+}
+
+void
+MenuMerger::markDirty(int position, int added)
+{
+    // The items after the change are the same before and after it, so the
+    // length of the untouched tail can be tracked across several changes.
+    int tail = m_offsets.back() - position - added;
+
+    if (m_dirtyStart < 0)
+    {
+        m_dirtyStart = position;
+        m_dirtyTail = tail;
+    }
+    else
+    {
+        m_dirtyStart = min(m_dirtyStart, position);
+        m_dirtyTail = min(m_dirtyTail, tail);
+    }
+}
+
+void
+MenuMerger::scheduleFlush()
+{
+    if (m_flushId == 0)
+    {
+        m_flushId = g_idle_add(MenuMerger::flush_cb, this);
+    }
+}
+
+void
+MenuMerger::flush()
+{
+    if (m_flushId != 0)
+    {
+        g_source_remove(m_flushId);
+        m_flushId = 0;
+    }
+
+    if (m_dirtyStart < 0)
+    {
+        return;
+    }
+
+    auto &items = merged_items(m_gmodel.get());
+
+    int start = m_dirtyStart;
+    int removed = int(items.size()) - start - m_dirtyTail;
+    int added = m_offsets.back() - start - m_dirtyTail;
+    m_dirtyStart = -1;
+    m_dirtyTail = 0;
+
+    vector<MergedItem> replacement;
+    replacement.reserve(added);
+
+    // locate the menu holding the first changed item from the prefix sums
+    size_t menu = upper_bound(m_offsets.begin(), m_offsets.end(), start) - m_offsets.begin() - 1;
+    for (int position = start; position < start + added; ++position)
+    {
+        while (position >= m_offsets[menu + 1])
+        {
+            ++menu;
+        }
+        replacement.push_back(item_from_model(m_gmodels[menu], position - m_offsets[menu]));
+    }
+
+    items.erase(items.begin() + start, items.begin() + start + removed);
+    items.insert(items.begin() + start, replacement.begin(), replacement.end());
+
+    if (removed != 0 || added != 0)
+    {
+        g_menu_model_items_changed(m_gmodel.get(), start, removed, added);
+    }
+}
+
+void
+MenuMerger::append(MenuModel::Ptr menu)
+{
+    int start = m_offsets.back();
+    int n_items = g_menu_model_get_n_items(*menu);
+
+    m_menus.push_back(menu);
+    m_gmodels.push_back(*menu);
+    m_offsets.push_back(start + n_items);
+    m_handlerIds.push_back(g_signal_connect(menu->operator GMenuModel *(),
+                                            "items-changed",
+                                            G_CALLBACK(MenuMerger::items_changed_cb),
+                                            this));
+
+    markDirty(start, n_items);
+    flush();
+}
+
+void
+MenuMerger::remove(MenuModel::Ptr menu)
+{
+    /// @todo menu might have been added multiple times
+    auto iter = find(m_menus.begin(), m_menus.end(), menu);
+    assert(iter != m_menus.end());
+    if (iter == m_menus.end())
+    {
+        return;
+    }
+    size_t index = iter - m_menus.begin();
+
+    g_signal_handler_disconnect(m_gmodels[index], m_handlerIds[index]);
+
+    int start = m_offsets[index];
+    int removed = m_offsets[index + 1] - start;
+    for (size_t i = index + 1; i < m_offsets.size(); ++i)
+    {
+        m_offsets[i] -= removed;
+    }
+
+    m_offsets.erase(m_offsets.begin() + index + 1);
+    m_handlerIds.erase(m_handlerIds.begin() + index);
+    m_gmodels.erase(m_gmodels.begin() + index);
+    m_menus.erase(iter);
+
+    markDirty(start, 0);
+    flush();
+}
+
+void
+MenuMerger::clear()
+{
+    for (size_t i = 0; i < m_menus.size(); ++i)
+    {
+        g_signal_handler_disconnect(m_gmodels[i], m_handlerIds[i]);
+    }
+
+    m_menus.clear();
+    m_gmodels.clear();
+    m_handlerIds.clear();
+    m_offsets.assign(1, 0);
+
+    markDirty(0, 0);
+    flush();
+}
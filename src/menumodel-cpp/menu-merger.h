@@ -19,10 +19,8 @@
 
 #pragma once
 
-#include <algorithm>
 #include <memory>
 #include <vector>
-#include <map>
 
 #include <gio/gio.h>
 
@@ -30,115 +28,62 @@
 #include "menu-model.h"
 #include "menu.h"
 
+/**
+ * Flattens a list of menu models into a single GMenuModel.
+ *
+ * Changes in the merged menus are not forwarded one by one. Instead the
+ * affected range is accumulated and published as a single "items-changed"
+ * emission once the main loop becomes idle.
+ */
 class MenuMerger : public MenuModel
 {
-    GMenuPtr m_gmenu;
+    std::shared_ptr<GMenuModel> m_gmodel;
+
     std::vector<MenuModel::Ptr> m_menus;
+    std::vector<GMenuModel*> m_gmodels;
+    std::vector<gulong> m_handlerIds;
+
+    // m_offsets[i] is the position of the first item of m_menus[i] in the
+    // merged model, m_offsets.back() is the total number of merged items.
+    std::vector<int> m_offsets;
 
-    std::map<GMenuModel*, MenuModel::Ptr> m_gmodelToMenu;
-    std::map<GMenuModel*, int> m_startPositions;
-    std::map<GMenuModel*, gulong> m_handlerId;
+    // Pending change: everything before m_dirtyStart and the last
+    // m_dirtyTail items are identical in the published and current state.
+    int m_dirtyStart;
+    int m_dirtyTail;
+    guint m_flushId;
 
     static void items_changed_cb(GMenuModel *model,
                                  gint        position,
                                  gint        removed,
                                  gint        added,
-                                 gpointer    user_data)
-    {
-        MenuMerger *that = static_cast<MenuMerger*>(user_data);
-        that->itemsChanged(model, position, removed, added);
-    }
+                                 gpointer    user_data);
+
+    static gboolean flush_cb(gpointer user_data);
 
     void itemsChanged(GMenuModel *model,
                       gint        position,
                       gint        removed,
-                      gint        added)
-    {
-        int offset = m_startPositions[model] + position;
-
-        for (int i = 0; i < removed; ++i) {
-            g_menu_remove(m_gmenu.get(), offset);
-        }
-        for (int i = added-1; i >= 0; --i) {
-            auto item = g_menu_item_new_from_model(model, position + i);
-            g_menu_insert_item(m_gmenu.get(), offset, item);
-            g_object_unref(item);
-        }
-
-        int delta = added - removed;
-        bool update = false;
-        for (auto iter : m_menus) {
-            if (update) {
-                m_startPositions[*iter] += delta;
-                continue;
-            }
-            if (m_gmodelToMenu[model] == iter) {
-                // the remaining positions need updating
-                update = true;
-                continue;
-            }
-        }
-    }
+                      gint        added);
+
+    void markDirty(int position, int added);
+
+    void scheduleFlush();
+
+    void flush();
 
 public:
     typedef std::shared_ptr<MenuMerger> Ptr;
 
-    MenuMerger()
-    {
-        m_gmenu = make_gmenu_ptr();
-    }
-
-    ~MenuMerger()
-    {
-        clear();
-//        GMainLoopSync([]{});
-    }
-
-    void append(MenuModel::Ptr menu)
-    {
-        // calculate the start position for the items for the new menu
-        int start_position;
-        if (m_menus.empty()) {
-            start_position = 0;
-        } else {
-            start_position = m_startPositions[*m_menus.back()];
-            start_position += g_menu_model_get_n_items(*m_menus.back());
-        }
-
-        m_menus.push_back(menu);
-        m_gmodelToMenu[*menu] = menu;
-        m_startPositions[*menu] = start_position;
-
-        // add all items
-        itemsChanged(*menu, 0, 0, g_menu_model_get_n_items(*menu));
-        m_handlerId[*menu] = g_signal_connect(menu->operator GMenuModel *(),
-                                              "items-changed",
-                                              G_CALLBACK(MenuMerger::items_changed_cb),
-                                              this);
-    }
-
-    void remove(MenuModel::Ptr menu)
-    {
-        /// @todo menu might have been added multiple times
-        assert(std::find(m_menus.begin(), m_menus.end(), menu) != m_menus.end());
-
-        g_signal_handler_disconnect(menu->operator GMenuModel *(), m_handlerId[*menu]);
-        m_handlerId.erase(*menu);
-
-        // remove all items
-        itemsChanged(*menu, 0, g_menu_model_get_n_items(*menu), 0);
-
-        m_startPositions.erase(*menu);
-        m_gmodelToMenu.erase(*menu);
-        m_menus.erase(std::remove(m_menus.begin(), m_menus.end(), menu), m_menus.end());
-    }
-
-    void clear()
-    {
-        std::vector<MenuModel::Ptr> tmp = m_menus;
-        for (auto menu : tmp)
-            remove(menu);
-    }
-
-    operator GMenuModel*() { return G_MENU_MODEL(m_gmenu.get()); }
+    MenuMerger();
+
+    ~MenuMerger();
+
+    void append(MenuModel::Ptr menu);
+
+    void remove(MenuModel::Ptr menu);
+
+    void clear();
+
+    operator GMenuModel*() { return m_gmodel.get(); }
 };
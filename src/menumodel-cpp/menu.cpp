@@ -22,6 +22,11 @@
 Menu::Menu()
 {
     m_gmenu = make_gmenu_ptr();
+
+    // Collect item changes until the next event loop iteration
+    m_changedTimer.setInterval(0);
+    m_changedTimer.setSingleShot(true);
+    connect(&m_changedTimer, &QTimer::timeout, this, &Menu::flushChanges);
 }
 
 Menu::~Menu()
@@ -31,26 +36,17 @@ Menu::~Menu()
 
 void Menu::append(MenuItem::Ptr item)
 {
-    m_items.push_back(item);
+    auto position = m_items.insert(m_items.end(), item);
     g_menu_append_item(m_gmenu.get(), item->gmenuitem());
-    if (std::count(m_items.begin(), m_items.end(), item) == 1) {
-        connect(item.get(), &MenuItem::changed, this, &Menu::itemChanged);
-    }
+    track(position);
 }
 
 void Menu::insert(MenuItem::Ptr item, iterator position)
 {
-    int index = 0;
-    auto iter = m_items.begin();
-    while (iter != m_items.end()) {
-        if (iter == position)
-            break;
-        ++index;
-        ++iter;
-    }
+    int index = m_items.index(position);
 
     g_menu_insert_item(m_gmenu.get(), index, item->gmenuitem());
-    m_items.insert(position, item);
+    track(m_items.insert(position, item));
 }
 
 /* Binary function that accepts two elements in the range as arguments,
@@ -62,14 +58,7 @@ void Menu::insert(MenuItem::Ptr item, iterator position)
  */
 void Menu::insert(MenuItem::Ptr item, std::function<bool(MenuItem::Ptr a, MenuItem::Ptr b)> compare)
 {
-    for (auto iter = m_items.begin(); iter != m_items.end(); iter++) {
-        if (compare(item, *iter)) {
-            insert(item, iter);
-            return;
-        }
-    }
-    // end of list reached.
-    append(item);
+    insert(item, m_items.upper_bound(item, compare));
 }
 
 //iterator insertAbove(MenuItem::Ptr item, iterator position);
@@ -78,41 +67,30 @@ void Menu::insert(MenuItem::Ptr item, std::function<bool(MenuItem::Ptr a, MenuIt
 void Menu::remove(iterator item)
 {
     /// @todo check that the item actually is part of the menu
-    /// @todo disconnect the changed signal
-    int index = 0;
-    auto iter = m_items.begin();
-    while (iter != item && iter != m_items.end()) {
-        ++index;
-        ++iter;
-    }
-
-    if (iter == m_items.end())
-     return;
+    if (item == m_items.end())
+        return;
 
-    g_menu_remove(m_gmenu.get(), index);
+    g_menu_remove(m_gmenu.get(), m_items.index(item));
+    untrack(item);
     m_items.erase(item);
 }
 
 void Menu::removeAll(MenuItem::Ptr item)
 {
-    /// @todo check that item has been added before.
-    /// @todo disconnect the changed signal
+    auto iter = m_positions.find(item.get());
+    if (iter == m_positions.end())
+        return;
 
-    // work reversed so that GMenu positions match tbe m_items positions
-    int index = m_items.size()-1;
-    for (auto iter = m_items.rbegin(); iter != m_items.rend(); ++iter) {
-        // prevent this-> from being captured
-        auto menu = m_gmenu;
-        if (*iter == item) {
-            g_menu_remove(m_gmenu.get(), index);
-        }
-        --index;
+    // copy, as untrack() modifies the original
+    auto positions = iter->second;
+
+    // work from the bottom up so that the remaining GMenu indices stay valid
+    std::sort(positions.begin(), positions.end(), [this](iterator a, iterator b) {
+        return m_items.index(a) > m_items.index(b);
+    });
+    for (auto position : positions) {
+        remove(position);
     }
-    // after the loop finishes we should be at index -1
-    // which is one above the first g_menu index (=0)
-    assert(index == -1);
-    auto iter = std::remove(m_items.begin(), m_items.end(), item);
-    m_items.erase(iter, m_items.end());
 }
 
 //void removeRange(iterator first, iterator last);
@@ -125,8 +103,9 @@ void Menu::moveTo(iterator item, iterator position)
     if (item == position)
         return;
 
+    auto value = *item;
     remove(item);
-    insert(*item, position);
+    insert(value, position);
 }
 
 //void moveRangeTo(iterator first, iterator last, iterator position);
@@ -134,7 +113,14 @@ void Menu::moveTo(iterator item, iterator position)
 /// finds the first occurence of item
 Menu::iterator Menu::find(MenuItem::Ptr item)
 {
-    return std::find(m_items.begin(), m_items.end(), item);
+    auto iter = m_positions.find(item.get());
+    if (iter == m_positions.end())
+        return m_items.end();
+
+    return *std::min_element(iter->second.begin(), iter->second.end(),
+                             [this](iterator a, iterator b) {
+        return m_items.index(a) < m_items.index(b);
+    });
 }
 
 Menu::iterator Menu::begin()
@@ -150,21 +136,76 @@ Menu::iterator Menu::end()
 // clear the whole menu
 void Menu::clear()
 {
-    // prevent this-> from being captured
+    for (auto pair : m_positions) {
+        disconnect(pair.first, &MenuItem::changed, this, &Menu::itemChanged);
+    }
+    m_positions.clear();
+    m_published.clear();
+    m_changed.clear();
+
     g_menu_remove_all(m_gmenu.get());
     m_items.clear();
 }
 
+void Menu::track(iterator position)
+{
+    auto &positions = m_positions[position->get()];
+    if (positions.empty()) {
+        connect(position->get(), &MenuItem::changed, this, &Menu::itemChanged);
+        m_published[position->get()] = (*position)->snapshot();
+    }
+    positions.push_back(position);
+}
+
+void Menu::untrack(iterator position)
+{
+    auto iter = m_positions.find(position->get());
+    if (iter == m_positions.end())
+        return;
+
+    auto &positions = iter->second;
+    positions.erase(std::remove(positions.begin(), positions.end(), position), positions.end());
+    if (positions.empty()) {
+        disconnect(position->get(), &MenuItem::changed, this, &Menu::itemChanged);
+        m_published.erase(position->get());
+        m_changed.erase(position->get());
+        m_positions.erase(iter);
+    }
+}
+
 void Menu::itemChanged()
 {
     auto item = qobject_cast<MenuItem*>(sender());
 
-    int index = 0;
-    for (auto iter = m_items.begin(); iter != m_items.end(); ++iter) {
-        if (iter->get() == item) {
+    if (m_positions.find(item) == m_positions.end())
+        return;
+
+    m_changed.insert(item);
+    m_changedTimer.start();
+}
+
+void Menu::flushChanges()
+{
+    auto changed = std::move(m_changed);
+    m_changed.clear();
+
+    for (auto item : changed) {
+        auto iter = m_positions.find(item);
+        if (iter == m_positions.end())
+            continue;
+
+        // changed back and forth
+        auto snapshot = item->snapshot();
+        auto &published = m_published[item];
+        if (snapshot == published)
+            continue;
+        published = snapshot;
+
+        // GMenu cannot update an item in place
+        for (auto position : iter->second) {
+            int index = m_items.index(position);
             g_menu_remove(m_gmenu.get(), index);
             g_menu_insert_item(m_gmenu.get(), index, item->gmenuitem());
         }
-        ++index;
     }
 }
@@ -20,27 +20,41 @@
 #pragma once
 
 #include <memory>
-#include <list>
 #include <vector>
-#include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
 
 #include <gio/gio.h>
 
 #include "gio-helpers/util.h"
+#include "indexed-list.h"
 #include "menu-model.h"
 #include "menu-item.h"
 
+#include <QTimer>
+
 class Menu : public MenuModel
 {
     Q_OBJECT
 
     GMenuPtr m_gmenu;
-    std::list<MenuItem::Ptr> m_items;
+    IndexedList<MenuItem::Ptr> m_items;
+
+    // every position of an item in m_items, used to find the GMenu indices
+    // of an item without scanning the whole menu.
+    std::unordered_map<MenuItem*, std::vector<IndexedList<MenuItem::Ptr>::iterator>> m_positions;
+
+    // what the GMenu holds for each item, see MenuItem::snapshot()
+    std::unordered_map<MenuItem*, Variant> m_published;
+
+    // items that changed during this event loop iteration
+    std::unordered_set<MenuItem*> m_changed;
+    QTimer m_changedTimer;
 
 public:
     typedef std::shared_ptr<Menu> Ptr;
-    typedef std::list<MenuItem::Ptr>::iterator iterator;
+    typedef IndexedList<MenuItem::Ptr>::iterator iterator;
 
     Menu();
 
@@ -56,6 +70,9 @@ public:
      * the second in the specific strict weak ordering it defines.
      * The function shall not modify any of its arguments.
      * This can either be a function pointer or a function object.
+     *
+     * The position is found with a binary search, so the menu has to be
+     * ordered according to compare already.
      */
     void insert(MenuItem::Ptr item, std::function<bool(MenuItem::Ptr a, MenuItem::Ptr b)> compare);
 
@@ -84,6 +101,13 @@ public:
 
     operator GMenuModel*() { return G_MENU_MODEL(m_gmenu.get()); }
 
+private:
+    void track(iterator position);
+
+    void untrack(iterator position);
+
 private Q_SLOTS:
     void itemChanged();
+
+    void flushChanges();
 };
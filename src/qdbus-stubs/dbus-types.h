@@ -19,6 +19,7 @@
 #pragma once
 
 #include <QDBusMetaType>
+#include <QDBusObjectPath>
 #include <QtCore>
 #include <QString>
 #include <QVariantMap>
@@ -29,15 +30,21 @@ Q_DECLARE_METATYPE(QVariantDictMap)
 typedef QMap<QString, QString> QStringMap;
 Q_DECLARE_METATYPE(QStringMap)
 
+// org.freedesktop.DBus.ObjectManager.GetManagedObjects
+typedef QMap<QDBusObjectPath, QVariantDictMap> QManagedObjectMap;
+Q_DECLARE_METATYPE(QManagedObjectMap)
+
 namespace DBusTypes
 {
     inline void registerMetaTypes()
     {
         qRegisterMetaType<QVariantDictMap>("QVariantDictMap");
         qRegisterMetaType<QStringMap>("QStringMap");
+        qRegisterMetaType<QManagedObjectMap>("QManagedObjectMap");
 
         qDBusRegisterMetaType<QVariantDictMap>();
         qDBusRegisterMetaType<QStringMap>();
+        qDBusRegisterMetaType<QManagedObjectMap>();
     }
 
     inline QString vpnConnectionPath()
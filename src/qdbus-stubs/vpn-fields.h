@@ -0,0 +1,385 @@
+/*
+ * Copyright © 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <dbus-types.h>
+
+#include <QHash>
+#include <QMetaMethod>
+#include <QMetaObject>
+#include <QMetaProperty>
+#include <QObject>
+#include <QVariant>
+
+#include <type_traits>
+
+/**
+ * The VPN connection properties, as seen by the indicator (nmofono), the
+ * D-Bus service and the connectivity-qt mirrors, together with the
+ * NetworkManager vpn.data / vpn.secrets keys they are stored under.
+ */
+namespace vpnfields
+{
+
+enum class Type
+{
+    String,
+    // "yes" means true
+    Bool,
+    // "yes" means false, e.g. "refuse-pap" for allowPap
+    AntiBool,
+    Int,
+    // index into Field::values, anything unknown is index 0
+    Enum
+};
+
+enum Flags
+{
+    NoFlags = 0,
+    // stored in vpn.secrets rather than vpn.data
+    Secret = 1 << 0,
+    // has a <name>Set bool property, the value is only decoded when the key is present
+    Optional = 1 << 1
+};
+
+struct Field
+{
+    const char* name;
+
+    // nullptr if the field depends on other keys and is decoded by hand
+    const char* key;
+
+    Type type;
+
+    int flags;
+
+    // Enum only, nullptr terminated and in the order of the C++ enum
+    const char* const* values;
+};
+
+namespace openvpn
+{
+
+static constexpr const char* CONNECTION_TYPES[] = {"tls", "password", "password-tls", "static-key", nullptr};
+
+static constexpr const char* KEY_DIRECTIONS[] = {"", "0", "1", nullptr};
+
+static constexpr const char* DEV_TYPES[] = {"tun", "tap", nullptr};
+
+static constexpr const char* CIPHERS[] = {
+    "", "DES-CBC", "RC2-CBC", "DES-EDE-CBC", "DES-EDE3-CBC", "DESX-CBC",
+    "RC2-40-CBC", "CAST5-CBC", "AES-128-CBC", "AES-192-CBC", "AES-256-CBC",
+    "CAMELLIA-128-CBC", "CAMELLIA-192-CBC", "CAMELLIA-256-CBC", "SEED-CBC",
+    "AES-128-CBC-HMAC-SHA1", "AES-256-CBC-HMAC-SHA1", nullptr};
+
+static constexpr const char* AUTHS[] = {
+    "", "none", "RSA-MD4", "MD5", "SHA1", "SHA224", "SHA256", "SHA384",
+    "SHA512", "RIPEMD160", nullptr};
+
+static constexpr const char* TLS_TYPES[] = {"server", "client", nullptr};
+
+static constexpr const char* PROXY_TYPES[] = {"", "http", "socks", nullptr};
+
+static constexpr Field FIELDS[] = {
+    // Basic properties
+    {"ca", "ca", Type::String, NoFlags, nullptr},
+    {"cert", "cert", Type::String, NoFlags, nullptr},
+    {"certPass", "cert-pass", Type::String, Secret, nullptr},
+    {"connectionType", "connection-type", Type::Enum, NoFlags, CONNECTION_TYPES},
+    {"key", "key", Type::String, NoFlags, nullptr},
+    {"localIp", "local-ip", Type::String, NoFlags, nullptr},
+    {"password", "password", Type::String, Secret, nullptr},
+    {"remote", "remote", Type::String, NoFlags, nullptr},
+    {"remoteIp", "remote-ip", Type::String, NoFlags, nullptr},
+    {"staticKey", "static-key", Type::String, NoFlags, nullptr},
+    {"staticKeyDirection", "static-key-direction", Type::Enum, NoFlags, KEY_DIRECTIONS},
+    {"username", "username", Type::String, NoFlags, nullptr},
+
+    // Advanced general properties
+    {"port", "port", Type::Int, Optional, nullptr},
+    {"renegSeconds", "reneg-seconds", Type::Int, Optional, nullptr},
+    {"compLzo", "comp-lzo", Type::Bool, NoFlags, nullptr},
+    {"protoTcp", "proto-tcp", Type::Bool, NoFlags, nullptr},
+    {"dev", nullptr, Type::String, NoFlags, nullptr},
+    {"devType", nullptr, Type::Enum, Optional, DEV_TYPES},
+    {"tunnelMtu", "tunnel-mtu", Type::Int, Optional, nullptr},
+    {"fragmentSize", "fragment-size", Type::Int, Optional, nullptr},
+    {"mssFix", "mssfix", Type::Bool, NoFlags, nullptr},
+    {"remoteRandom", "remote-random", Type::Bool, NoFlags, nullptr},
+
+    // Advanced security properties
+    {"cipher", "cipher", Type::Enum, NoFlags, CIPHERS},
+    {"keysize", "keysize", Type::Int, Optional, nullptr},
+    {"auth", "auth", Type::Enum, NoFlags, AUTHS},
+
+    // Advanced TLS auth properties
+    {"tlsRemote", "tls-remote", Type::String, NoFlags, nullptr},
+    {"remoteCertTls", "remote-cert-tls", Type::Enum, Optional, TLS_TYPES},
+    {"ta", nullptr, Type::String, Optional, nullptr},
+    {"taDir", nullptr, Type::Enum, NoFlags, KEY_DIRECTIONS},
+
+    // Advanced proxy settings
+    {"proxyType", nullptr, Type::Enum, NoFlags, PROXY_TYPES},
+    {"proxyServer", nullptr, Type::String, NoFlags, nullptr},
+    {"proxyPort", nullptr, Type::Int, NoFlags, nullptr},
+    {"proxyRetry", nullptr, Type::Bool, NoFlags, nullptr},
+    {"proxyUsername", nullptr, Type::String, NoFlags, nullptr},
+    {"proxyPassword", nullptr, Type::String, Secret, nullptr}
+};
+
+}
+
+namespace pptp
+{
+
+// these are keys of their own rather than values
+static constexpr const char* MPPE_TYPES[] = {"require-mppe", "require-mppe-128", "require-mppe-40", nullptr};
+
+static constexpr Field FIELDS[] = {
+    // Basic properties
+    {"gateway", "gateway", Type::String, NoFlags, nullptr},
+    {"user", "user", Type::String, NoFlags, nullptr},
+    {"password", "password", Type::String, Secret, nullptr},
+    {"domain", "domain", Type::String, NoFlags, nullptr},
+
+    // Advanced properties
+    {"allowPap", "refuse-pap", Type::AntiBool, NoFlags, nullptr},
+    {"allowChap", "refuse-chap", Type::AntiBool, NoFlags, nullptr},
+    {"allowMschap", "refuse-mschap", Type::AntiBool, NoFlags, nullptr},
+    {"allowMschapv2", "refuse-mschapv2", Type::AntiBool, NoFlags, nullptr},
+    {"allowEap", "refuse-eap", Type::AntiBool, NoFlags, nullptr},
+    {"requireMppe", nullptr, Type::Bool, NoFlags, nullptr},
+    {"mppeType", nullptr, Type::Enum, NoFlags, MPPE_TYPES},
+    {"mppeStateful", "mppe-stateful", Type::Bool, NoFlags, nullptr},
+    {"bsdCompression", "nobsdcomp", Type::AntiBool, NoFlags, nullptr},
+    {"deflateCompression", "nodeflate", Type::AntiBool, NoFlags, nullptr},
+    {"tcpHeaderCompression", "no-vj-comp", Type::AntiBool, NoFlags, nullptr},
+    {"sendPppEchoPackets", nullptr, Type::Bool, NoFlags, nullptr}
+};
+
+}
+
+inline int indexOf(const char* const* values, const QString& value)
+{
+    for (int i = 0; values[i]; ++i)
+    {
+        if (value == QLatin1String(values[i]))
+        {
+            return i;
+        }
+    }
+    return 0;
+}
+
+constexpr bool sameName(const char* a, const char* b)
+{
+    while (*a && *a == *b)
+    {
+        ++a;
+        ++b;
+    }
+    return *a == *b;
+}
+
+// name is field followed by "Set"
+constexpr bool isSetName(const char* name, const char* field)
+{
+    while (*field && *field == *name)
+    {
+        ++field;
+        ++name;
+    }
+    return !*field && sameName(name, "Set");
+}
+
+/**
+ * For static_assert, whether a class's property table has one entry per
+ * field, in table order, each Optional one followed by its Set flag.
+ */
+template<typename Property, std::size_t N, std::size_t M>
+constexpr bool matches(const Field (&fields)[N], const Property (&properties)[M])
+{
+    std::size_t i = 0;
+    for (const auto& field : fields)
+    {
+        if (i == M || !sameName(properties[i++].name, field.name))
+        {
+            return false;
+        }
+        if ((field.flags & Optional) && (i == M || !isSetName(properties[i++].name, field.name)))
+        {
+            return false;
+        }
+    }
+    return i == M;
+}
+
+/**
+ * Decodes the fields that have a key into property name -> value, in one
+ * pass over the table.
+ *
+ * When previous is given, only the keys whose strings differ from it are
+ * decoded, so a refresh that changes one key yields one value (two for an
+ * Optional field).
+ */
+template<std::size_t N>
+QVariantMap decode(const Field (&fields)[N], bool secrets, const QStringMap& data,
+                   const QStringMap* previous = nullptr)
+{
+    QVariantMap result;
+
+    for (const auto& field : fields)
+    {
+        if (!field.key || bool(field.flags & Secret) != secrets)
+        {
+            continue;
+        }
+
+        auto it = data.constFind(field.key);
+        bool found = (it != data.constEnd());
+
+        if (previous)
+        {
+            auto previousIt = previous->constFind(field.key);
+            bool previousFound = (previousIt != previous->constEnd());
+            if (found == previousFound && (!found || *it == *previousIt))
+            {
+                continue;
+            }
+        }
+
+        QString name(field.name);
+        if (field.flags & Optional)
+        {
+            result[name + "Set"] = found;
+            if (!found)
+            {
+                continue;
+            }
+        }
+
+        QString value = found ? *it : QString();
+        switch (field.type)
+        {
+            case Type::String:
+                result[name] = value;
+                break;
+            case Type::Bool:
+                result[name] = (value == "yes");
+                break;
+            case Type::AntiBool:
+                result[name] = (value != "yes");
+                break;
+            case Type::Int:
+                result[name] = value.toInt();
+                break;
+            case Type::Enum:
+                result[name] = indexOf(field.values, value);
+                break;
+        }
+    }
+
+    return result;
+}
+
+template<typename T>
+typename std::enable_if<std::is_enum<T>::value, T>::type fromVariant(const QVariant& value)
+{
+    return static_cast<T>(value.toInt());
+}
+
+template<typename T>
+typename std::enable_if<!std::is_enum<T>::value, T>::type fromVariant(const QVariant& value)
+{
+    return value.value<T>();
+}
+
+/**
+ * Emits the NOTIFY signal of object's property name for the D-Bus value.
+ *
+ * The mirrors only see property names and variants, the table tells them
+ * the type to hand to the signal. Enum properties travel as int, which is
+ * also their representation in the signal's arguments.
+ */
+template<std::size_t N>
+void notify(const Field (&fields)[N], QObject& object, const QString& name, const QVariant& value)
+{
+    struct Signal
+    {
+        QMetaMethod method;
+        Type type;
+    };
+
+    static QHash<const QMetaObject*, QHash<QString, Signal>> cache;
+
+    auto metaObject = object.metaObject();
+    auto entries = cache.find(metaObject);
+    if (entries == cache.end())
+    {
+        QHash<QString, Signal> table;
+        auto add = [&](const QString& propertyName, Type type)
+        {
+            int index = metaObject->indexOfProperty(propertyName.toLatin1().constData());
+            if (index >= 0)
+            {
+                table[propertyName] = {metaObject->property(index).notifySignal(), type};
+            }
+        };
+        for (const auto& field : fields)
+        {
+            add(field.name, field.type);
+            if (field.flags & Optional)
+            {
+                add(QString(field.name) + "Set", Type::Bool);
+            }
+        }
+        entries = cache.insert(metaObject, table);
+    }
+
+    auto signal = entries->constFind(name);
+    if (signal == entries->constEnd() || !signal->method.isValid())
+    {
+        return;
+    }
+
+    QByteArray parameterType = signal->method.parameterTypes().value(0);
+    switch (signal->type)
+    {
+        case Type::String:
+        {
+            QString v = value.toString();
+            signal->method.invoke(&object, Qt::DirectConnection, QGenericArgument(parameterType.constData(), &v));
+            break;
+        }
+        case Type::Bool:
+        case Type::AntiBool:
+        {
+            bool v = value.toBool();
+            signal->method.invoke(&object, Qt::DirectConnection, QGenericArgument(parameterType.constData(), &v));
+            break;
+        }
+        case Type::Int:
+        case Type::Enum:
+        {
+            int v = value.toInt();
+            signal->method.invoke(&object, Qt::DirectConnection, QGenericArgument(parameterType.constData(), &v));
+            break;
+        }
+    }
+}
+
+}
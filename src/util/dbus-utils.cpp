@@ -20,23 +20,23 @@
 
 #include <QDBusConnection>
 #include <QDBusMessage>
+#include <QDebug>
 #include <QStringList>
 #include <QTimer>
 #include <QVariantMap>
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 namespace DBusUtils
 {
 
 namespace
 {
-typedef QPair<QString, QString> QStringPair;
-typedef QPair<QDBusConnection, QVariantMap> ConnectionValues;
-typedef QMap<QStringPair, ConnectionValues> PropertyChangeQueue;
-
 static std::shared_ptr<QTimer> propertyChangeTimer;
 
-static PropertyChangeQueue propertyChangeQueue;
+// notifiers with dirty properties, in the order they were first notified
+static std::vector<PropertyNotifier*> propertyChangeQueue;
 }
 
 void flushPropertyChanges()
@@ -51,35 +51,106 @@ void flushPropertyChanges()
         propertyChangeTimer->stop();
     }
 
-    QMapIterator<QStringPair, ConnectionValues> it(propertyChangeQueue);
-    while (it.hasNext())
+    std::vector<PropertyNotifier*> queue;
+    queue.swap(propertyChangeQueue);
+
+    for (auto notifier : queue)
+    {
+        notifier->flush();
+    }
+}
+
+QString interfaceName(const QMetaObject& adaptor)
+{
+    return adaptor.classInfo(adaptor.indexOfClassInfo("D-Bus Interface")).value();
+}
+
+PropertyNotifier::PropertyNotifier(const QDBusConnection& connection,
+                                   const QObject& o,
+                                   const QString& path,
+                                   const QString& interface,
+                                   const Properties& properties) :
+        m_connection(connection),
+        m_object(o),
+        m_path(path),
+        m_interface(interface)
+{
+    auto metaObject = o.metaObject();
+    for (const auto& property : properties)
+    {
+        addProperty(property.first, property.second,
+                    metaObject->property(metaObject->indexOfProperty(qPrintable(property.second))));
+    }
+}
+
+PropertyNotifier::PropertyNotifier(const QDBusConnection& connection,
+                                   const QObject& o,
+                                   const QString& path,
+                                   const QString& interface,
+                                   const QMetaObject& declaringClass) :
+        m_connection(connection),
+        m_object(o),
+        m_path(path),
+        m_interface(interface)
+{
+    for (int i = declaringClass.propertyOffset(); i < declaringClass.propertyCount(); ++i)
     {
-        it.next();
+        auto property = declaringClass.property(i);
+        addProperty(i - declaringClass.propertyOffset(), property.name(), property);
+    }
+}
 
-        QDBusMessage signal = QDBusMessage::createSignal(
-              it.key().first, // Path
-              "org.freedesktop.DBus.Properties",
-              "PropertiesChanged");
+void PropertyNotifier::addProperty(int index, const QString& name, const QMetaProperty& property)
+{
+    if (!property.isValid())
+    {
+        qWarning() << "Unknown property" << name << "on" << m_path << m_interface;
+    }
 
-        // Interface
-        signal << it.key().second;
-        // Changed properties (name, value)
-        signal << it.value().second;
-        signal << QStringList();
-        // Connection
-        it.value().first.send(signal);
+    if (index >= m_names.size())
+    {
+        m_names.resize(index + 1);
+        m_properties.resize(index + 1);
+        m_dirty.resize(index + 1);
+    }
+    if (!m_names.at(index).isEmpty())
+    {
+        qWarning() << "Properties" << m_names.at(index) << "and" << name
+                << "share an index on" << m_path << m_interface;
     }
 
-    propertyChangeQueue.clear();
+    m_indices.insert(name, index);
+    m_names[index] = name;
+    m_properties[index] = property;
+}
+
+PropertyNotifier::~PropertyNotifier()
+{
+    if (m_queued)
+    {
+        propertyChangeQueue.erase(
+                std::remove(propertyChangeQueue.begin(),
+                            propertyChangeQueue.end(), this),
+                propertyChangeQueue.end());
+    }
 }
 
-void notifyPropertyChanged(
-        const QDBusConnection& connection,
-        const QObject& o,
-        const QString& path,
-        const QString& interface,
-        const QStringList& propertyNames)
+void PropertyNotifier::notify(int index)
 {
+    if (index < 0 || index >= m_names.size() || m_names.at(index).isEmpty())
+    {
+        qWarning() << "Unknown property index" << index << "on" << m_path << m_interface;
+        return;
+    }
+
+    m_dirty.setBit(index);
+
+    if (!m_queued)
+    {
+        m_queued = true;
+        propertyChangeQueue.push_back(this);
+    }
+
     if (!propertyChangeTimer)
     {
         propertyChangeTimer = std::make_shared<QTimer>();
@@ -90,19 +161,57 @@ void notifyPropertyChanged(
         QObject::connect(propertyChangeTimer.get(), &QTimer::timeout, &flushPropertyChanges);
     }
 
-    QStringPair key(path, interface);
-    auto it = propertyChangeQueue.find(key);
-    if (it == propertyChangeQueue.end())
+    propertyChangeTimer->start();
+}
+
+void PropertyNotifier::notify(std::initializer_list<int> indices)
+{
+    for (int index : indices)
+    {
+        notify(index);
+    }
+}
+
+void PropertyNotifier::notify(const QString& propertyName)
+{
+    auto it = m_indices.constFind(propertyName);
+    if (it == m_indices.cend())
     {
-        it = propertyChangeQueue.insert(key, ConnectionValues(connection, QVariantMap()));
+        qWarning() << "Unknown property" << propertyName << "on" << m_path << m_interface;
+        return;
     }
+    notify(*it);
+}
 
-    for (const auto& propertyName: propertyNames)
+void PropertyNotifier::flush()
+{
+    if (!m_queued)
     {
-        it->second.insert(propertyName, o.property(qPrintable(propertyName)));
+        return;
     }
+    m_queued = false;
 
-    propertyChangeTimer->start();
+    QVariantMap changed;
+    for (int i = 0; i < m_dirty.size(); ++i)
+    {
+        if (m_dirty.testBit(i))
+        {
+            changed.insert(m_names.at(i), m_properties.at(i).read(&m_object));
+        }
+    }
+    m_dirty.fill(false);
+
+    QDBusMessage signal = QDBusMessage::createSignal(
+          m_path,
+          "org.freedesktop.DBus.Properties",
+          "PropertiesChanged");
+
+    // Interface
+    signal << m_interface;
+    // Changed properties (name, value)
+    signal << changed;
+    signal << QStringList();
+    m_connection.send(signal);
 }
 
 }
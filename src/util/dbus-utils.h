@@ -18,16 +18,83 @@
 
 #pragma once
 
+#include <QBitArray>
 #include <QDBusConnection>
+#include <QHash>
+#include <QMetaProperty>
 #include <QObject>
 #include <QStringList>
+#include <QVector>
+
+#include <initializer_list>
+#include <utility>
 
 namespace DBusUtils
 {
 
-void notifyPropertyChanged(const QDBusConnection& connection, const QObject& o,
-                           const QString& path, const QString& interface,
-                           const QStringList& propertyNames);
+/**
+ * Queues PropertiesChanged signals for one interface of an exported object.
+ *
+ * The properties are given once, and resolved against the meta-object of the
+ * exporting object up front. Call sites then only set dirty bits by index,
+ * and the values are read and sent in one go when the changes are flushed.
+ */
+class PropertyNotifier
+{
+    Q_DISABLE_COPY(PropertyNotifier)
+
+public:
+    /// the index used with notify(), and the name of the property
+    typedef std::pair<int, QString> Property;
+
+    typedef QVector<Property> Properties;
+
+    PropertyNotifier(const QDBusConnection& connection, const QObject& o,
+                     const QString& path, const QString& interface,
+                     const Properties& properties);
+
+    /// all the properties declared by declaringClass itself, in order
+    PropertyNotifier(const QDBusConnection& connection, const QObject& o,
+                     const QString& path, const QString& interface,
+                     const QMetaObject& declaringClass);
+
+    ~PropertyNotifier();
+
+    void notify(int index);
+
+    void notify(std::initializer_list<int> indices);
+
+    /// for callers that only know the property name
+    void notify(const QString& propertyName);
+
+private:
+    friend void flushPropertyChanges();
+
+    void addProperty(int index, const QString& name, const QMetaProperty& property);
+
+    void flush();
+
+    QDBusConnection m_connection;
+
+    const QObject& m_object;
+
+    QString m_path;
+
+    QString m_interface;
+
+    QVector<QString> m_names;
+
+    QVector<QMetaProperty> m_properties;
+
+    QHash<QString, int> m_indices;
+
+    QBitArray m_dirty;
+
+    bool m_queued = false;
+};
+
+/// the D-Bus interface name of a generated adaptor class
+QString interfaceName(const QMetaObject& adaptor);
 
 void flushPropertyChanges();
 
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <util/startup-timer.h>
+
+#include <QElapsedTimer>
+#include <QMap>
+
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+
+namespace util
+{
+namespace startup
+{
+
+namespace
+{
+
+struct Task
+{
+    qint64 begin = -1;
+    qint64 end = -1;
+};
+
+struct Timeline
+{
+    QElapsedTimer clock;
+    QMap<QString, Task> tasks;
+    int outstanding = 0;
+    qint64 exported = -1;
+    function<void()> done;
+};
+
+Timeline *timeline = nullptr;
+
+double
+toMs(qint64 ns)
+{
+    return ns / 1000000.0;
+}
+
+void
+report()
+{
+    QString criticalPath;
+    qint64 lastEnd = -1;
+
+    cout << fixed << setprecision(1);
+    for (auto it = timeline->tasks.cbegin(); it != timeline->tasks.cend(); ++it)
+    {
+        cout << "startup: " << it.key().toStdString()
+             << " " << toMs(it->begin) << " ms - " << toMs(it->end) << " ms"
+             << " (" << toMs(it->end - it->begin) << " ms)" << endl;
+        if (it->end > lastEnd)
+        {
+            lastEnd = it->end;
+            criticalPath = it.key();
+        }
+    }
+    cout << "startup: exported at " << toMs(timeline->exported) << " ms" << endl;
+    cout << "startup: settled at " << toMs(qMax(lastEnd, timeline->exported)) << " ms";
+    if (!criticalPath.isEmpty())
+    {
+        cout << ", critical path: " << criticalPath.toStdString();
+    }
+    cout << endl;
+
+    auto done = timeline->done;
+    timeline->done = nullptr;
+    if (done)
+    {
+        done();
+    }
+}
+
+}
+
+void
+start(function<void()> done)
+{
+    if (!timeline)
+    {
+        timeline = new Timeline;
+        timeline->clock.start();
+    }
+    timeline->done = done;
+}
+
+void
+begin(const QString &task)
+{
+    if (!timeline)
+    {
+        return;
+    }
+
+    auto &t = timeline->tasks[task];
+    if (t.begin < 0)
+    {
+        t.begin = timeline->clock.nsecsElapsed();
+        ++timeline->outstanding;
+    }
+}
+
+void
+end(const QString &task)
+{
+    if (!timeline)
+    {
+        return;
+    }
+
+    auto it = timeline->tasks.find(task);
+    if (it == timeline->tasks.end() || it->end >= 0)
+    {
+        return;
+    }
+    it->end = timeline->clock.nsecsElapsed();
+    --timeline->outstanding;
+
+    if (timeline->outstanding == 0 && timeline->exported >= 0)
+    {
+        report();
+    }
+}
+
+void
+exported()
+{
+    if (!timeline || timeline->exported >= 0)
+    {
+        return;
+    }
+
+    timeline->exported = timeline->clock.nsecsElapsed();
+
+    if (timeline->outstanding == 0)
+    {
+        report();
+    }
+}
+
+}
+}
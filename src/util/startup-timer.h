@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <functional>
+
+#include <QString>
+
+namespace util
+{
+
+/**
+ * Timeline of the asynchronous startup, printed by --measure-startup.
+ *
+ * Every initial discovery call is bracketed by begin() and end(). These and
+ * exported() are no-ops unless measuring has been started. Once exported()
+ * has been called and every task that was begun has ended, the timeline is
+ * written to stdout and the callback given to start() is invoked.
+ */
+namespace startup
+{
+    void
+    start(std::function<void()> done);
+
+    void
+    begin(const QString &task);
+
+    void
+    end(const QString &task);
+
+    /// the bus name has been acquired, only the first call counts
+    void
+    exported();
+}
+
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <util/strength-filter.h>
+
+#include <algorithm>
+
+namespace util
+{
+
+StrengthFilter::StrengthFilter(const QVector<double>& levels,
+                               double hysteresis, int minimumInterval,
+                               QObject* parent) :
+        QObject(parent), m_levels(levels), m_hysteresis(hysteresis)
+{
+    std::sort(m_levels.begin(), m_levels.end());
+
+    m_timer.setInterval(minimumInterval);
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &StrengthFilter::flush);
+}
+
+void StrengthFilter::setLevels(const QVector<double>& levels)
+{
+    m_levels = levels;
+    std::sort(m_levels.begin(), m_levels.end());
+}
+
+void StrengthFilter::setHysteresis(double hysteresis)
+{
+    m_hysteresis = hysteresis;
+}
+
+void StrengthFilter::setMinimumInterval(int minimumInterval)
+{
+    m_timer.setInterval(minimumInterval);
+}
+
+double StrengthFilter::value() const
+{
+    return m_value;
+}
+
+void StrengthFilter::reset(double value)
+{
+    m_timer.stop();
+    m_value = value;
+    m_latest = value;
+}
+
+void StrengthFilter::update(double value)
+{
+    m_latest = value;
+
+    // Already waiting for the interval to pass
+    if (m_timer.isActive())
+    {
+        return;
+    }
+
+    if (!crossesLevel(value))
+    {
+        return;
+    }
+
+    if (m_lastPublished.isValid())
+    {
+        auto elapsed = m_lastPublished.elapsed();
+        if (elapsed < m_timer.interval())
+        {
+            m_timer.start(m_timer.interval() - elapsed);
+            return;
+        }
+    }
+
+    flush();
+}
+
+void StrengthFilter::flush()
+{
+    m_timer.stop();
+
+    if (!crossesLevel(m_latest))
+    {
+        return;
+    }
+
+    m_value = m_latest;
+    m_lastPublished.start();
+    Q_EMIT valueChanged(m_value);
+}
+
+int StrengthFilter::level(double value) const
+{
+    return std::upper_bound(m_levels.cbegin(), m_levels.cend(), value) - m_levels.cbegin();
+}
+
+bool StrengthFilter::crossesLevel(double value) const
+{
+    int current = level(m_value);
+    if (value > m_value)
+    {
+        return level(value) > current;
+    }
+    else
+    {
+        // Only apply the hysteresis on the way down, so that a value
+        // hovering around a threshold does not flip between two levels
+        return level(value + m_hysteresis) < current;
+    }
+}
+
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+namespace util
+{
+
+/**
+ * Decides which signal strength changes are worth passing on.
+ *
+ * The levels are the thresholds the strength is bucketed into for display.
+ * A new value is only published once it reaches a higher level, or drops
+ * below a lower one by more than the hysteresis, and no sooner than the
+ * minimum interval after the previous change; the latest value is published
+ * when the interval expires.
+ * Fluctuations that stay within a level are dropped.
+ */
+class StrengthFilter: public QObject
+{
+    Q_OBJECT
+
+public:
+    StrengthFilter(const QVector<double>& levels, double hysteresis,
+                   int minimumInterval, QObject* parent = nullptr);
+
+    ~StrengthFilter() = default;
+
+    void setLevels(const QVector<double>& levels);
+
+    void setHysteresis(double hysteresis);
+
+    /// in milliseconds
+    void setMinimumInterval(int minimumInterval);
+
+    /// the last published value
+    double value() const;
+
+    /// sets the value without filtering or publishing it
+    void reset(double value);
+
+public Q_SLOTS:
+    void update(double value);
+
+Q_SIGNALS:
+    void valueChanged(double value);
+
+protected Q_SLOTS:
+    void flush();
+
+protected:
+    int level(double value) const;
+
+    bool crossesLevel(double value) const;
+
+    QVector<double> m_levels;
+
+    double m_hysteresis;
+
+    double m_value = 0;
+
+    double m_latest = 0;
+
+    QElapsedTimer m_lastPublished;
+
+    QTimer m_timer;
+};
+
+}
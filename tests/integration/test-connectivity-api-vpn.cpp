@@ -27,6 +27,7 @@
 
 #include <QDebug>
 #include <QSortFilterProxyModel>
+#include <QTest>
 #include <QTestEventLoop>
 
 using namespace std;
@@ -517,6 +518,67 @@ TEST_F(TestConnectivityApiVpn, WritesOpenvpnProperties)
     EXPECT_EQ("remote2", vpnData["remote"]);
 }
 
+TEST_F(TestConnectivityApiVpn, BatchesOpenvpnPropertyWrites)
+{
+    // Add a single VPN configuration
+    auto appleConnection = createVpnConnection("apple", "org.freedesktop.NetworkManager.openvpn",
+    {
+        {"connection-type", "tls"},
+        {"remote", "remotey"},
+        {"ca", "/my/ca.crt"},
+        {"cert", "/my/cert.crt"},
+        {"cert-pass-flags", "1"},
+        {"key", "/my/key.key"}
+    });
+
+    // Add a physical device to use for the connection
+    setGlobalConnectedState(NM_STATE_CONNECTED_GLOBAL);
+    auto device = createWiFiDevice(NM_DEVICE_STATE_ACTIVATED);
+
+    // Start the indicator
+    ASSERT_NO_THROW(startIndicator());
+
+    // Connect the the service
+    auto connectivity(newConnectivity());
+
+    auto vpnConnections = connectivity->vpnConnections();
+
+    ASSERT_EQ(CSL({{"apple", {false, true}}}), vpnList(*vpnConnections));
+    auto connection = getOpenvpnConnection(vpnConnections, 0);
+    ASSERT_TRUE(connection);
+
+    QSignalSpy settingsWrittenSpy(connection, SIGNAL(settingsWritten(bool)));
+    OrgFreedesktopNetworkManagerSettingsConnectionInterface appleInterface(
+            NM_DBUS_SERVICE, appleConnection,
+            dbusTestRunner.systemConnection());
+    QSignalSpy appleInterfaceSpy(&appleInterface, SIGNAL(Updated()));
+
+    // A burst of edits is written with a single Update
+    connection->setRemote("remote2");
+    connection->setCa("/my/ca2.crt");
+    connection->setPortSet(true);
+    connection->setPort(1234);
+    connection->setCompLzo(true);
+
+    WAIT_FOR_SIGNALS(settingsWrittenSpy, 1);
+    EXPECT_EQ(QVariantList{true}, settingsWrittenSpy.first());
+    WAIT_FOR_SIGNALS(appleInterfaceSpy, 1);
+
+    // Give any further writes the chance to show up
+    QTest::qWait(500);
+    EXPECT_EQ(1, appleInterfaceSpy.size());
+    EXPECT_EQ(1, settingsWrittenSpy.size());
+
+    QStringMap vpnData;
+    QVariantDictMap settings = appleInterface.GetSettings();
+    settings["vpn"]["data"].value<QDBusArgument>() >> vpnData;
+
+    EXPECT_EQ("remote2", vpnData["remote"]);
+    EXPECT_EQ("/my/ca2.crt", vpnData["ca"]);
+    EXPECT_EQ("1234", vpnData["port"]);
+    EXPECT_EQ("yes", vpnData["comp-lzo"]);
+}
+
 TEST_F(TestConnectivityApiVpn, CreatesOpenvpnConnection)
 {
     setGlobalConnectedState(NM_STATE_CONNECTED_GLOBAL);
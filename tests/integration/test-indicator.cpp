@@ -19,6 +19,7 @@
 #include <indicator-network-test-base.h>
 
 #include <QDebug>
+#include <QProcess>
 #include <QTestEventLoop>
 #include <QSignalSpy>
 
@@ -60,6 +61,23 @@ TEST_F(TestIndicator, BasicMenuContents)
         ).match());
 }
 
+TEST_F(TestIndicator, MeasureStartup)
+{
+    setGlobalConnectedState(NM_STATE_DISCONNECTED);
+    auto device = createWiFiDevice(NM_DEVICE_STATE_DISCONNECTED);
+
+    QProcess process;
+    process.start(NETWORK_SERVICE_BIN, QStringList{"--measure-startup"});
+    ASSERT_TRUE(process.waitForFinished(10000));
+    EXPECT_EQ(0, process.exitCode());
+
+    QString output = process.readAllStandardOutput();
+    EXPECT_TRUE(output.contains("startup: nm-devices")) << output.toStdString();
+    EXPECT_TRUE(output.contains("startup: nm-state")) << output.toStdString();
+    EXPECT_TRUE(output.contains("startup: urfkill-flight-mode")) << output.toStdString();
+    EXPECT_TRUE(output.contains("critical path")) << output.toStdString();
+}
+
 TEST_F(TestIndicator, OneDisconnectedAccessPointAtStartup)
 {
     setGlobalConnectedState(NM_STATE_DISCONNECTED);
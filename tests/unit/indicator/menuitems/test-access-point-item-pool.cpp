@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <menuitems/access-point-item-pool.h>
+#include <utils/action-utils.h>
+
+#include <libqtdbustest/DBusTestRunner.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace testing;
+using namespace QtDBusTest;
+using namespace testutils;
+
+using namespace nmofono;
+
+namespace
+{
+
+class MockAccessPoint : public wifi::AccessPoint
+{
+public:
+    MOCK_CONST_METHOD0(ssid, QString());
+
+    MOCK_CONST_METHOD0(bssid, QString());
+
+    MOCK_CONST_METHOD0(raw_ssid, QByteArray());
+
+    MOCK_CONST_METHOD0(object_path, QDBusObjectPath());
+
+    MOCK_CONST_METHOD0(secured, bool());
+
+    MOCK_CONST_METHOD0(enterprise, bool());
+
+    MOCK_CONST_METHOD0(adhoc, bool());
+
+    MOCK_CONST_METHOD0(strength, double());
+};
+
+class TestAccessPointItemPool : public Test
+{
+protected:
+    shared_ptr<MockAccessPoint> accessPoint(const QString& ssid, double strength)
+    {
+        shared_ptr<MockAccessPoint> ap = make_shared<NiceMock<MockAccessPoint>>();
+        ON_CALL(*ap, ssid()).WillByDefault(Return(ssid));
+        ON_CALL(*ap, strength()).WillByDefault(Return(strength));
+        return ap;
+    }
+
+    DBusTestRunner dbus;
+
+    ActionGroupMerger::Ptr merger = make_shared<ActionGroupMerger>();
+};
+
+TEST_F(TestAccessPointItemPool, RecyclesItems)
+{
+    AccessPointItemPool pool(merger, 1);
+
+    auto first = accessPoint("first", 70.0);
+    auto item = pool.acquire(first);
+    pool.commit();
+    EXPECT_EQ(2, merger->actionGroup()->actions().size());
+
+    QString actionName = item->menuItem()->action();
+    QString strengthActionName = string_value(
+            item->menuItem(), "x-canonical-wifi-ap-strength-action");
+
+    pool.release(item);
+    pool.commit();
+    EXPECT_EQ(1, pool.idle());
+    EXPECT_FALSE(item->accessPoint());
+    // the actions of idle items are not exported
+    EXPECT_TRUE(merger->actionGroup()->actions().isEmpty());
+    EXPECT_TRUE(findAction(merger->actionGroup(), actionName).get() == nullptr);
+
+    // no longer followed once released
+    Q_EMIT first->strengthUpdated(20.0);
+
+    auto second = accessPoint("second", 40.0);
+    auto recycled = pool.acquire(second, true);
+    pool.commit();
+    EXPECT_EQ(item, recycled);
+    EXPECT_EQ(0, pool.idle());
+    EXPECT_EQ(second, recycled->accessPoint());
+
+    EXPECT_EQ("second", recycled->menuItem()->label());
+    EXPECT_EQ(actionName, recycled->menuItem()->action());
+
+    auto strengthAction = findAction(merger->actionGroup(), strengthActionName);
+    ASSERT_FALSE(strengthAction.get() == nullptr);
+    EXPECT_EQ(40, strengthAction->state().as<uint8_t>());
+
+    auto activateAction = findAction(merger->actionGroup(), actionName);
+    ASSERT_FALSE(activateAction.get() == nullptr);
+    EXPECT_TRUE(activateAction->state().as<bool>());
+}
+
+TEST_F(TestAccessPointItemPool, DropsItemsBeyondCapacity)
+{
+    AccessPointItemPool pool(merger, 1);
+
+    auto a = pool.acquire(accessPoint("a", 10.0));
+    auto b = pool.acquire(accessPoint("b", 20.0));
+    pool.commit();
+    EXPECT_EQ(4, merger->actionGroup()->actions().size());
+
+    pool.release(a);
+    pool.release(b);
+    pool.commit();
+    EXPECT_EQ(1, pool.idle());
+    EXPECT_TRUE(merger->actionGroup()->actions().isEmpty());
+
+    // the idle one comes back with its actions
+    auto c = pool.acquire(accessPoint("c", 30.0));
+    pool.commit();
+    EXPECT_EQ(2, merger->actionGroup()->actions().size());
+    EXPECT_FALSE(findAction(merger->actionGroup(), c->menuItem()->action()).get() == nullptr);
+}
+
+TEST_F(TestAccessPointItemPool, ReleaseAndAcquireBeforeCommit)
+{
+    AccessPointItemPool pool(merger, 1);
+
+    auto item = pool.acquire(accessPoint("a", 10.0));
+    pool.commit();
+
+    // cancel out without touching the merger
+    pool.release(item);
+    auto recycled = pool.acquire(accessPoint("b", 20.0));
+    pool.commit();
+    EXPECT_EQ(item, recycled);
+    EXPECT_EQ(2, merger->actionGroup()->actions().size());
+}
+
+TEST_F(TestAccessPointItemPool, ForwardsActivation)
+{
+    AccessPointItemPool pool(merger);
+
+    auto ap = accessPoint("the ssid", 70.0);
+    auto item = pool.acquire(ap);
+    pool.commit();
+
+    wifi::AccessPoint::Ptr activated;
+    QObject::connect(&pool, &AccessPointItemPool::activated, [&activated](wifi::AccessPoint::Ptr accessPoint)
+    {
+        activated = accessPoint;
+    });
+
+    auto action = findAction(merger->actionGroup(), item->menuItem()->action());
+    ASSERT_FALSE(action.get() == nullptr);
+    Q_EMIT action->activated(Variant());
+    EXPECT_EQ(ap, activated);
+}
+
+} // namespace
@@ -0,0 +1,235 @@
+/*
+ * Copyright © 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <menuitems/wifi-link-item.h>
+#include <util/qhash-sharedptr.h>
+
+#include <libqtdbustest/DBusTestRunner.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+
+using namespace std;
+using namespace testing;
+using namespace QtDBusTest;
+
+using namespace nmofono;
+
+namespace
+{
+
+class MockAccessPoint : public wifi::AccessPoint
+{
+public:
+    MOCK_CONST_METHOD0(ssid, QString());
+
+    MOCK_CONST_METHOD0(bssid, QString());
+
+    MOCK_CONST_METHOD0(raw_ssid, QByteArray());
+
+    MOCK_CONST_METHOD0(object_path, QDBusObjectPath());
+
+    MOCK_CONST_METHOD0(secured, bool());
+
+    MOCK_CONST_METHOD0(enterprise, bool());
+
+    MOCK_CONST_METHOD0(adhoc, bool());
+
+    MOCK_CONST_METHOD0(strength, double());
+};
+
+class MockWifiLink : public wifi::WifiLink
+{
+public:
+    MOCK_CONST_METHOD0(type, Type());
+
+    MOCK_CONST_METHOD0(characteristics, std::uint32_t());
+
+    MOCK_CONST_METHOD0(status, Status());
+
+    MOCK_CONST_METHOD0(id, Id());
+
+    MOCK_CONST_METHOD0(name, QString());
+
+    MOCK_CONST_METHOD0(accessPoints, QSet<wifi::AccessPoint::Ptr>());
+
+    MOCK_METHOD1(connect_to, void(wifi::AccessPoint::Ptr));
+
+    MOCK_METHOD0(activeAccessPoint, wifi::AccessPoint::Ptr());
+
+    MOCK_CONST_METHOD1(isKnown, bool(wifi::AccessPoint::Ptr));
+
+    MOCK_CONST_METHOD0(mode, Mode());
+
+    MOCK_CONST_METHOD0(signal, Signal());
+
+    MOCK_METHOD1(setDisconnectWifi, void(bool));
+};
+
+class TestWifiLinkItem : public Test
+{
+protected:
+    void SetUp() override
+    {
+        link = make_shared<NiceMock<MockWifiLink>>();
+        ON_CALL(*link, isKnown(_)).WillByDefault(Return(false));
+    }
+
+    shared_ptr<MockAccessPoint> accessPoint(const QString& ssid, double strength)
+    {
+        shared_ptr<MockAccessPoint> ap = make_shared<NiceMock<MockAccessPoint>>();
+        ON_CALL(*ap, ssid()).WillByDefault(Return(ssid));
+        setStrength(ap, strength);
+        accessPoints.insert(ap);
+        return ap;
+    }
+
+    void setStrength(shared_ptr<MockAccessPoint> ap, double strength)
+    {
+        ON_CALL(*ap, strength()).WillByDefault(Return(strength));
+        Q_EMIT ap->strengthUpdated(strength);
+    }
+
+    void setKnown(wifi::AccessPoint::Ptr ap)
+    {
+        ON_CALL(*link, isKnown(Eq(ap))).WillByDefault(Return(true));
+    }
+
+    WifiLinkItem::Ptr newItem(int maximumVisible, wifi::AccessPoint::Ptr active = {})
+    {
+        ON_CALL(*link, accessPoints()).WillByDefault(Return(accessPoints));
+        ON_CALL(*link, activeAccessPoint()).WillByDefault(Return(active));
+        return make_shared<WifiLinkItem>(link, maximumVisible);
+    }
+
+    // run the re-ranking timer and the idle that publishes the menu
+    static void settle()
+    {
+        QCoreApplication::processEvents();
+        while (g_main_context_iteration(nullptr, FALSE))
+        {
+        }
+    }
+
+    static QStringList labels(WifiLinkItem::Ptr item)
+    {
+        settle();
+
+        auto section = shared_ptr<GMenuModel>(
+                g_menu_item_get_link(item->menuItem()->gmenuitem(), G_MENU_LINK_SECTION),
+                GObjectDeleter());
+        QStringList result;
+        for (int i = 0; i < g_menu_model_get_n_items(section.get()); ++i)
+        {
+            gchar* label = nullptr;
+            g_menu_model_get_item_attribute(section.get(), i, G_MENU_ATTRIBUTE_LABEL, "s", &label);
+            result << QString::fromUtf8(label);
+            g_free(label);
+        }
+        return result;
+    }
+
+    DBusTestRunner dbus;
+
+    shared_ptr<MockWifiLink> link;
+
+    QSet<wifi::AccessPoint::Ptr> accessPoints;
+};
+
+TEST_F(TestWifiLinkItem, ListsTheStrongest)
+{
+    accessPoint("a", 10.0);
+    accessPoint("b", 20.0);
+    accessPoint("c", 30.0);
+    accessPoint("d", 40.0);
+    accessPoint("e", 50.0);
+
+    EXPECT_EQ(QStringList({"c", "d", "e"}), labels(newItem(3)));
+    EXPECT_EQ(QStringList({"a", "b", "c", "d", "e"}), labels(newItem(-1)));
+    EXPECT_TRUE(labels(newItem(0)).isEmpty());
+}
+
+TEST_F(TestWifiLinkItem, FollowsScans)
+{
+    accessPoint("a", 10.0);
+    auto b = accessPoint("b", 20.0);
+    accessPoint("c", 30.0);
+    auto item = newItem(2);
+    EXPECT_EQ(QStringList({"b", "c"}), labels(item));
+
+    // the next one in line takes the place of one that is gone
+    Q_EMIT link->accessPointsChanged({}, {b});
+    EXPECT_EQ(QStringList({"a", "c"}), labels(item));
+
+    auto d = accessPoint("d", 90.0);
+    Q_EMIT link->accessPointsChanged({d}, {});
+    EXPECT_EQ(QStringList({"c", "d"}), labels(item));
+}
+
+TEST_F(TestWifiLinkItem, KeepsKnownAndActive)
+{
+    auto a = accessPoint("a", 10.0);
+    auto b = accessPoint("b", 20.0);
+    accessPoint("c", 30.0);
+    accessPoint("d", 40.0);
+    accessPoint("e", 50.0);
+    setKnown(a);
+
+    // the active one first, then the rest by name
+    EXPECT_EQ(QStringList({"b", "a", "d", "e"}), labels(newItem(2, b)));
+}
+
+TEST_F(TestWifiLinkItem, ActiveMovesBackWhenDisconnected)
+{
+    auto known = accessPoint("known", 5.0);
+    auto stranger = accessPoint("stranger", 6.0);
+    accessPoint("a", 30.0);
+    accessPoint("b", 40.0);
+    setKnown(known);
+
+    auto item = newItem(2, known);
+    EXPECT_EQ(QStringList({"known", "a", "b"}), labels(item));
+
+    // a known one stays, in its place by name
+    Q_EMIT link->activeAccessPointUpdated(nullptr);
+    EXPECT_EQ(QStringList({"a", "b", "known"}), labels(item));
+
+    Q_EMIT link->activeAccessPointUpdated(stranger);
+    EXPECT_EQ(QStringList({"stranger", "a", "b", "known"}), labels(item));
+
+    // a weak unknown one drops out
+    Q_EMIT link->activeAccessPointUpdated(nullptr);
+    EXPECT_EQ(QStringList({"a", "b", "known"}), labels(item));
+}
+
+TEST_F(TestWifiLinkItem, DoesNotSwapSimilarStrengths)
+{
+    auto a = accessPoint("a", 10.0);
+    accessPoint("b", 40.0);
+    accessPoint("c", 30.0);
+    auto item = newItem(2);
+    EXPECT_EQ(QStringList({"b", "c"}), labels(item));
+
+    // slightly stronger than a shown one is not enough
+    setStrength(a, 35.0);
+    EXPECT_EQ(QStringList({"b", "c"}), labels(item));
+
+    setStrength(a, 45.0);
+    EXPECT_EQ(QStringList({"a", "b"}), labels(item));
+}
+
+} // namespace
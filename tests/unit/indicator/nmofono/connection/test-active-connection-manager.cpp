@@ -0,0 +1,148 @@
+/*
+ * Copyright © 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmofono/connection/active-connection-manager.h>
+
+#include <libqtdbustest/DBusTestRunner.h>
+#include <libqtdbusmock/DBusMock.h>
+#include <NetworkManager.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <QSignalSpy>
+
+using namespace std;
+using namespace testing;
+using namespace QtDBusTest;
+using namespace QtDBusMock;
+
+using namespace nmofono::connection;
+
+namespace
+{
+
+class TestActiveConnectionManager : public Test
+{
+protected:
+    TestActiveConnectionManager() :
+        dbusMock(dbusTestRunner)
+    {
+    }
+
+    void SetUp() override
+    {
+        dbusMock.registerTemplate(NM_DBUS_SERVICE, NETWORK_MANAGER_TEMPLATE_PATH, {}, QDBusConnection::SystemBus);
+        dbusTestRunner.startServices();
+
+        auto& networkManager(dbusMock.networkManagerInterface());
+        auto deviceReply = networkManager.AddWiFiDevice("device", "wlan0", NM_DEVICE_STATE_DISCONNECTED);
+        deviceReply.waitForFinished();
+        ASSERT_FALSE(deviceReply.isError()) << deviceReply.error().message().toStdString();
+        device = deviceReply;
+
+        for (const QString ssid : {"the ssid", "other ssid"})
+        {
+            auto apReply = networkManager.AddAccessPoint(
+                    device, ssid.split(' ').first(), ssid, "00:00:00:00:00:00",
+                    NM_802_11_MODE_INFRA, 0, 0, 50, NM_802_11_AP_SEC_KEY_MGMT_PSK);
+            apReply.waitForFinished();
+            ASSERT_FALSE(apReply.isError()) << apReply.error().message().toStdString();
+            accessPoints << apReply.value();
+
+            auto connectionReply = networkManager.AddWiFiConnection(device, ssid.split(' ').first(), ssid, "");
+            connectionReply.waitForFinished();
+            ASSERT_FALSE(connectionReply.isError()) << connectionReply.error().message().toStdString();
+            connections << QDBusObjectPath(connectionReply.value());
+        }
+    }
+
+    QString activate(int i, const QString& name)
+    {
+        auto reply = dbusMock.networkManagerInterface().AddActiveConnection(
+                QStringList() << device, connections.at(i).path(), accessPoints.at(i),
+                name, NM_ACTIVE_CONNECTION_STATE_ACTIVATED);
+        reply.waitForFinished();
+        EXPECT_FALSE(reply.isError()) << reply.error().message().toStdString();
+        return reply;
+    }
+
+    DBusTestRunner dbusTestRunner;
+
+    DBusMock dbusMock;
+
+    QString device;
+
+    QStringList accessPoints;
+
+    QList<QDBusObjectPath> connections;
+};
+
+TEST_F(TestActiveConnectionManager, LoadsExistingConnections)
+{
+    auto active = activate(1, "active");
+
+    ActiveConnectionManager manager(dbusTestRunner.systemConnection());
+    QSignalSpy readySpy(&manager, SIGNAL(ready()));
+
+    // nothing is read while constructing
+    EXPECT_FALSE(manager.isReady());
+    EXPECT_TRUE(manager.connections().isEmpty());
+
+    ASSERT_TRUE(readySpy.wait());
+    EXPECT_TRUE(manager.isReady());
+
+    auto activeConnection = manager.activeConnection(connections.at(1));
+    ASSERT_TRUE(activeConnection);
+    EXPECT_EQ(active, activeConnection->path().path());
+    EXPECT_EQ("802-11-wireless", activeConnection->type());
+    EXPECT_EQ(ActiveConnection::State::activated, activeConnection->state());
+    EXPECT_FALSE(manager.activeConnection(connections.at(0)));
+}
+
+TEST_F(TestActiveConnectionManager, IndexesBySettingsConnection)
+{
+    ActiveConnectionManager manager(dbusTestRunner.systemConnection());
+    QSignalSpy readySpy(&manager, SIGNAL(ready()));
+    ASSERT_TRUE(readySpy.wait());
+    QSignalSpy changedSpy(&manager, SIGNAL(activeConnectionChanged(const QDBusObjectPath&)));
+
+    EXPECT_FALSE(manager.activeConnection(connections.at(0)));
+    EXPECT_FALSE(manager.activeConnection(connections.at(1)));
+
+    auto active = activate(0, "active");
+    ASSERT_TRUE(changedSpy.wait());
+
+    // only the connection that changed is reported
+    ASSERT_EQ(1, changedSpy.size());
+    EXPECT_EQ(connections.at(0), changedSpy.first().first().value<QDBusObjectPath>());
+
+    auto activeConnection = manager.activeConnection(connections.at(0));
+    ASSERT_TRUE(activeConnection);
+    EXPECT_EQ(active, activeConnection->path().path());
+    EXPECT_FALSE(manager.activeConnection(connections.at(1)));
+
+    changedSpy.clear();
+    auto reply = dbusMock.networkManagerInterface().RemoveActiveConnection(device, active);
+    reply.waitForFinished();
+    ASSERT_FALSE(reply.isError()) << reply.error().message().toStdString();
+    ASSERT_TRUE(changedSpy.wait());
+
+    ASSERT_EQ(1, changedSpy.size());
+    EXPECT_EQ(connections.at(0), changedSpy.first().first().value<QDBusObjectPath>());
+    EXPECT_FALSE(manager.activeConnection(connections.at(0)));
+}
+
+} // namespace
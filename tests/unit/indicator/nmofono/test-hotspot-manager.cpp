@@ -0,0 +1,275 @@
+/*
+ * Copyright © 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmofono/hotspot-manager.h>
+#include <nmofono/proxy-registry.h>
+#include <NetworkManagerDeviceInterface.h>
+#include <dbus-types.h>
+
+#include <libqtdbustest/DBusTestRunner.h>
+#include <libqtdbusmock/DBusMock.h>
+#include <NetworkManager.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <QSignalSpy>
+
+#include <algorithm>
+
+using namespace std;
+using namespace testing;
+using namespace QtDBusTest;
+using namespace QtDBusMock;
+
+using namespace nmofono;
+
+namespace
+{
+
+// QObject::receivers() is protected, a pointer to it is not
+struct Receivers : public QObject
+{
+    static int count(const QObject& object, const char* signal)
+    {
+        return (object.*(&Receivers::receivers))(signal);
+    }
+};
+
+class TestHotspotManager : public Test
+{
+protected:
+    TestHotspotManager() :
+        dbusMock(dbusTestRunner)
+    {
+    }
+
+    void SetUp() override
+    {
+        dbusMock.registerTemplate(NM_DBUS_SERVICE, NETWORK_MANAGER_TEMPLATE_PATH, {}, QDBusConnection::SystemBus);
+        dbusMock.registerCustomMock(DBusTypes::POWERD_DBUS_NAME,
+                                    DBusTypes::POWERD_DBUS_PATH,
+                                    DBusTypes::POWERD_DBUS_INTERFACE,
+                                    QDBusConnection::SystemBus);
+        dbusMock.registerCustomMock(DBusTypes::WPASUPPLICANT_DBUS_NAME,
+                                    DBusTypes::WPASUPPLICANT_DBUS_PATH,
+                                    DBusTypes::WPASUPPLICANT_DBUS_INTERFACE,
+                                    QDBusConnection::SystemBus);
+        dbusTestRunner.startServices();
+
+        auto& wpaSupplicant = dbusMock.mockInterface(DBusTypes::WPASUPPLICANT_DBUS_NAME,
+                                                     DBusTypes::WPASUPPLICANT_DBUS_PATH,
+                                                     DBusTypes::WPASUPPLICANT_DBUS_INTERFACE,
+                                                     QDBusConnection::SystemBus);
+        wpaSupplicant.AddMethod(DBusTypes::WPASUPPLICANT_DBUS_INTERFACE,
+                                "SetInterfaceFirmware", "os", "", "").waitForFinished();
+
+        auto& powerd = dbusMock.mockInterface(DBusTypes::POWERD_DBUS_NAME,
+                                              DBusTypes::POWERD_DBUS_PATH,
+                                              DBusTypes::POWERD_DBUS_INTERFACE,
+                                              QDBusConnection::SystemBus);
+        powerd.AddMethod(DBusTypes::POWERD_DBUS_INTERFACE,
+                         "requestSysState", "si", "s", "ret = 'dummy_cookie'").waitForFinished();
+        powerd.AddMethod(DBusTypes::POWERD_DBUS_INTERFACE,
+                         "clearSysState", "s", "", "").waitForFinished();
+
+        auto deviceReply = dbusMock.networkManagerInterface().AddWiFiDevice(
+                "device", "wlan0", NM_DEVICE_STATE_DISCONNECTED);
+        deviceReply.waitForFinished();
+        ASSERT_FALSE(deviceReply.isError()) << deviceReply.error().message().toStdString();
+        device = deviceReply;
+
+        firmwareSpy = make_unique<QSignalSpy>(&wpaSupplicant, SIGNAL(MethodCalled(const QString &, const QVariantList &)));
+        nmSpy = make_unique<QSignalSpy>(&dbusMock.mockInterface(NM_DBUS_SERVICE, NM_DBUS_PATH, NM_DBUS_INTERFACE,
+                                                                QDBusConnection::SystemBus),
+                                        SIGNAL(MethodCalled(const QString &, const QVariantList &)));
+
+        activeConnectionManager = make_shared<connection::ActiveConnectionManager>(dbusTestRunner.systemConnection());
+        hotspotManager = make_unique<HotspotManager>(activeConnectionManager, dbusTestRunner.systemConnection());
+
+        // the stored hotspot and the active connections are loaded asynchronously
+        QSignalSpy readySpy(hotspotManager.get(), SIGNAL(ready()));
+        ASSERT_TRUE(hotspotManager->isReady() || readySpy.wait());
+        hotspotManager->setPassword("the password");
+    }
+
+    /// modes passed to SetInterfaceFirmware so far
+    QStringList firmwareModes()
+    {
+        QStringList modes;
+        for (const auto& call : *firmwareSpy)
+        {
+            modes << call.at(1).toList().at(1).toString();
+        }
+        return modes;
+    }
+
+    int nmCalls(const QString& method)
+    {
+        return count_if(nmSpy->begin(), nmSpy->end(), [&method](const QVariantList& call)
+        {
+            return call.first().toString() == method;
+        });
+    }
+
+    void enable()
+    {
+        QSignalSpy enabledSpy(hotspotManager.get(), SIGNAL(enabledChanged(bool)));
+        hotspotManager->setEnabled(true);
+        ASSERT_TRUE(enabledSpy.wait());
+        ASSERT_EQ(QVariantList{true}, enabledSpy.first());
+        ASSERT_TRUE(hotspotManager->enabled());
+    }
+
+    DBusTestRunner dbusTestRunner;
+
+    DBusMock dbusMock;
+
+    QString device;
+
+    unique_ptr<QSignalSpy> firmwareSpy;
+
+    unique_ptr<QSignalSpy> nmSpy;
+
+    connection::ActiveConnectionManager::SPtr activeConnectionManager;
+
+    unique_ptr<HotspotManager> hotspotManager;
+};
+
+TEST_F(TestHotspotManager, Enable)
+{
+    QSignalSpy storedSpy(hotspotManager.get(), SIGNAL(storedChanged(bool)));
+    EXPECT_FALSE(hotspotManager->stored());
+
+    enable();
+
+    EXPECT_EQ(QList<QVariantList>({{true}}), storedSpy);
+    EXPECT_TRUE(hotspotManager->stored());
+    EXPECT_EQ(QStringList{"ap"}, firmwareModes());
+    EXPECT_EQ(1, nmCalls("ActivateConnection"));
+    EXPECT_EQ("wlan0", hotspotManager->interface());
+    ASSERT_EQ(1, activeConnectionManager->connections().size());
+}
+
+TEST_F(TestHotspotManager, Disable)
+{
+    enable();
+
+    QSignalSpy enabledSpy(hotspotManager.get(), SIGNAL(enabledChanged(bool)));
+    hotspotManager->setEnabled(false);
+    ASSERT_EQ(1, enabledSpy.size());
+    EXPECT_EQ(QVariantList{false}, enabledSpy.first());
+
+    // the firmware goes back once the connection is deactivated
+    ASSERT_TRUE(firmwareSpy->wait());
+    EXPECT_EQ(QStringList({"ap", "sta"}), firmwareModes());
+    EXPECT_EQ(1, nmCalls("DeactivateConnection"));
+    EXPECT_TRUE(hotspotManager->stored());
+}
+
+TEST_F(TestHotspotManager, CancelWhileEnabling)
+{
+    QSignalSpy enabledSpy(hotspotManager.get(), SIGNAL(enabledChanged(bool)));
+    QSignalSpy disconnectWifiSpy(hotspotManager.get(), SIGNAL(disconnectWifiChanged(bool)));
+
+    hotspotManager->setEnabled(true);
+    hotspotManager->setEnabled(false);
+    EXPECT_EQ(QList<QVariantList>({{true}, {false}}), disconnectWifiSpy);
+
+    while (firmwareSpy->size() < 2)
+    {
+        ASSERT_TRUE(firmwareSpy->wait());
+    }
+    EXPECT_EQ(QStringList({"ap", "sta"}), firmwareModes());
+
+    // the abandoned attempt does not carry on
+    EXPECT_FALSE(enabledSpy.wait(500));
+    EXPECT_FALSE(hotspotManager->enabled());
+    EXPECT_FALSE(hotspotManager->stored());
+    EXPECT_EQ(0, nmCalls("ActivateConnection"));
+}
+
+TEST_F(TestHotspotManager, ReenableBeforeDeactivated)
+{
+    enable();
+
+    // the late reply to the deactivation must not switch the firmware
+    // back to station mode underneath the new attempt
+    QSignalSpy enabledSpy(hotspotManager.get(), SIGNAL(enabledChanged(bool)));
+    hotspotManager->setEnabled(false);
+    hotspotManager->setEnabled(true);
+    while (enabledSpy.size() < 2)
+    {
+        ASSERT_TRUE(enabledSpy.wait());
+    }
+    EXPECT_EQ(QList<QVariantList>({{false}, {true}}), enabledSpy);
+
+    EXPECT_EQ(QStringList({"ap", "ap"}), firmwareModes());
+    EXPECT_EQ(2, nmCalls("ActivateConnection"));
+}
+
+TEST_F(TestHotspotManager, ReactivatesWhenBooted)
+{
+    enable();
+    ASSERT_EQ(1, activeConnectionManager->connections().size());
+    auto booted = (*activeConnectionManager->connections().begin())->path();
+    nmSpy->clear();
+
+    QSignalSpy enabledSpy(hotspotManager.get(), SIGNAL(enabledChanged(bool)));
+    auto reply = dbusMock.networkManagerInterface().RemoveActiveConnection(device, booted.path());
+    reply.waitForFinished();
+    ASSERT_FALSE(reply.isError()) << reply.error().message().toStdString();
+
+    // activated again on the same device, without touching the firmware
+    while (nmCalls("ActivateConnection") == 0)
+    {
+        ASSERT_TRUE(nmSpy->wait());
+    }
+    EXPECT_EQ(QStringList{"ap"}, firmwareModes());
+    EXPECT_TRUE(enabledSpy.isEmpty());
+    EXPECT_TRUE(hotspotManager->enabled());
+}
+
+TEST_F(TestHotspotManager, ForgetsUnavailableCandidates)
+{
+    auto deviceReply = dbusMock.networkManagerInterface().AddWiFiDevice(
+            "unavailable", "wlan1", NM_DEVICE_STATE_UNAVAILABLE);
+    deviceReply.waitForFinished();
+    ASSERT_FALSE(deviceReply.isError()) << deviceReply.error().message().toStdString();
+
+    // shared with the hotspot manager, and kept alive like the Wi-Fi link would
+    auto unavailable = ProxyRegistry::get<OrgFreedesktopNetworkManagerDeviceInterface>(
+            NM_DBUS_SERVICE, deviceReply.value(), dbusTestRunner.systemConnection());
+    int receivers = Receivers::count(*unavailable, SIGNAL(StateChanged(uint,uint,uint)));
+
+    for (int i = 0; i < 2; ++i)
+    {
+        enable();
+        EXPECT_EQ("wlan0", hotspotManager->interface());
+
+        QSignalSpy enabledSpy(hotspotManager.get(), SIGNAL(enabledChanged(bool)));
+        hotspotManager->setEnabled(false);
+        ASSERT_EQ(1, enabledSpy.size());
+        while (firmwareSpy->size() < 2 * (i + 1))
+        {
+            ASSERT_TRUE(firmwareSpy->wait());
+        }
+
+        // no longer waiting for the other device once one was found
+        EXPECT_EQ(receivers, Receivers::count(*unavailable, SIGNAL(StateChanged(uint,uint,uint))));
+    }
+}
+
+} // namespace
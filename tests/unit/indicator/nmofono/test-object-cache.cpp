@@ -0,0 +1,161 @@
+/*
+ * Copyright © 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmofono/object-cache.h>
+
+#include <libqtdbustest/DBusTestRunner.h>
+#include <libqtdbusmock/DBusMock.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <QSignalSpy>
+#include <QTest>
+
+using namespace std;
+using namespace testing;
+using namespace QtDBusTest;
+using namespace QtDBusMock;
+
+using namespace nmofono;
+
+namespace
+{
+
+static const QString SERVICE("org.example.Service");
+static const QString ROOT("/org/example");
+static const QString OBJECT_MANAGER("org.freedesktop.DBus.ObjectManager");
+static const QString DEVICE_PATH("/org/example/Device/0");
+static const QString DEVICE_IFACE("org.example.Device");
+
+class TestObjectCache : public Test
+{
+protected:
+    TestObjectCache() :
+        dbusMock(dbusTestRunner)
+    {
+        DBusTypes::registerMetaTypes();
+    }
+
+    void SetUp() override
+    {
+        dbusMock.registerCustomMock(SERVICE, ROOT, OBJECT_MANAGER, QDBusConnection::SystemBus);
+        dbusTestRunner.startServices();
+    }
+
+    OrgFreedesktopDBusMockInterface& objectManager()
+    {
+        return dbusMock.mockInterface(SERVICE, ROOT, OBJECT_MANAGER, QDBusConnection::SystemBus);
+    }
+
+    void addGetManagedObjects()
+    {
+        auto reply = objectManager().AddMethod(OBJECT_MANAGER, "GetManagedObjects", "", "a{oa{sa{sv}}}",
+                "ret = {'" + DEVICE_PATH + "': {'" + DEVICE_IFACE + "': "
+                "{'Interface': 'wlan0', 'State': dbus.UInt32(100)}}}");
+        reply.waitForFinished();
+        ASSERT_FALSE(reply.isError()) << reply.error().message().toStdString();
+    }
+
+    // the deltas don't emit anything, so poll until they are applied
+    template<typename F>
+    static bool waitFor(F condition)
+    {
+        for (int i = 0; i < 50 && !condition(); ++i)
+        {
+            QTest::qWait(20);
+        }
+        return condition();
+    }
+
+    DBusTestRunner dbusTestRunner;
+
+    DBusMock dbusMock;
+};
+
+TEST_F(TestObjectCache, LoadsManagedObjects)
+{
+    addGetManagedObjects();
+
+    ObjectCache cache(dbusTestRunner.systemConnection(), SERVICE, ROOT);
+    QSignalSpy loadedSpy(&cache, SIGNAL(loaded(bool)));
+
+    EXPECT_FALSE(cache.isLoaded());
+    ASSERT_TRUE(loadedSpy.wait());
+    EXPECT_EQ(QVariantList{true}, loadedSpy.first());
+    EXPECT_TRUE(cache.isLoaded());
+    EXPECT_TRUE(cache.available());
+
+    QDBusObjectPath device(DEVICE_PATH);
+    EXPECT_TRUE(cache.contains(device, DEVICE_IFACE));
+    EXPECT_FALSE(cache.contains(device, "org.example.Other"));
+    EXPECT_FALSE(cache.contains(QDBusObjectPath("/org/example/Device/1"), DEVICE_IFACE));
+
+    auto properties = cache.properties(device, DEVICE_IFACE);
+    EXPECT_EQ("wlan0", properties.value("Interface").toString());
+    EXPECT_EQ(100u, properties.value("State").toUInt());
+}
+
+TEST_F(TestObjectCache, AppliesDeltas)
+{
+    addGetManagedObjects();
+
+    ObjectCache cache(dbusTestRunner.systemConnection(), SERVICE, ROOT);
+    QSignalSpy loadedSpy(&cache, SIGNAL(loaded(bool)));
+    ASSERT_TRUE(loadedSpy.wait());
+
+    QDBusObjectPath device(DEVICE_PATH);
+
+    // PropertiesChanged on the object itself
+    {
+        auto reply = objectManager().AddObject(DEVICE_PATH, DEVICE_IFACE, {}, {});
+        reply.waitForFinished();
+        ASSERT_FALSE(reply.isError()) << reply.error().message().toStdString();
+    }
+    dbusMock.mockInterface(SERVICE, DEVICE_PATH, DEVICE_IFACE, QDBusConnection::SystemBus).EmitSignal(
+            "org.freedesktop.DBus.Properties", "PropertiesChanged", "sa{sv}as",
+            QVariantList() << DEVICE_IFACE << QVariantMap{{"State", 30u}} << QStringList());
+    EXPECT_TRUE(waitFor([&]{ return cache.properties(device, DEVICE_IFACE).value("State").toUInt() == 30u; }));
+    EXPECT_EQ("wlan0", cache.properties(device, DEVICE_IFACE).value("Interface").toString());
+
+    // a new object
+    QDBusObjectPath added("/org/example/Device/1");
+    objectManager().EmitSignal(OBJECT_MANAGER, "InterfacesAdded", "oa{sa{sv}}",
+            QVariantList() << QVariant::fromValue(added)
+                    << QVariant::fromValue(QVariantDictMap{{DEVICE_IFACE, QVariantMap{{"Interface", "eth0"}}}}));
+    EXPECT_TRUE(waitFor([&]{ return cache.contains(added, DEVICE_IFACE); }));
+    EXPECT_EQ("eth0", cache.properties(added, DEVICE_IFACE).value("Interface").toString());
+
+    // and the old one going away
+    objectManager().EmitSignal(OBJECT_MANAGER, "InterfacesRemoved", "oas",
+            QVariantList() << QVariant::fromValue(device) << QStringList{DEVICE_IFACE});
+    EXPECT_TRUE(waitFor([&]{ return !cache.contains(device, DEVICE_IFACE); }));
+    EXPECT_TRUE(cache.contains(added, DEVICE_IFACE));
+}
+
+TEST_F(TestObjectCache, UnavailableWithoutObjectManager)
+{
+    // no GetManagedObjects method on the mock
+    ObjectCache cache(dbusTestRunner.systemConnection(), SERVICE, ROOT);
+    QSignalSpy loadedSpy(&cache, SIGNAL(loaded(bool)));
+
+    ASSERT_TRUE(loadedSpy.wait());
+    EXPECT_EQ(QVariantList{false}, loadedSpy.first());
+    EXPECT_TRUE(cache.isLoaded());
+    EXPECT_FALSE(cache.available());
+    EXPECT_FALSE(cache.contains(QDBusObjectPath(DEVICE_PATH), DEVICE_IFACE));
+}
+
+} // namespace
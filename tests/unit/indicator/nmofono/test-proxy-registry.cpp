@@ -0,0 +1,80 @@
+/*
+ * Copyright © 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <nmofono/proxy-registry.h>
+#include <NetworkManagerDeviceInterface.h>
+#include <NetworkManagerInterface.h>
+
+#include <libqtdbustest/DBusTestRunner.h>
+#include <NetworkManager.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace testing;
+using namespace QtDBusTest;
+
+using namespace nmofono;
+
+namespace
+{
+
+class TestProxyRegistry : public Test
+{
+protected:
+    DBusTestRunner dbusTestRunner;
+};
+
+TEST_F(TestProxyRegistry, SharesProxiesPerObjectAndInterface)
+{
+    auto connection = dbusTestRunner.systemConnection();
+    int before = ProxyRegistry::size();
+
+    auto nm = ProxyRegistry::get<OrgFreedesktopNetworkManagerInterface>(NM_DBUS_SERVICE, NM_DBUS_PATH, connection);
+    auto sameNm = ProxyRegistry::get<OrgFreedesktopNetworkManagerInterface>(NM_DBUS_SERVICE, NM_DBUS_PATH, connection);
+    EXPECT_EQ(nm, sameNm);
+
+    // different path
+    auto device0 = ProxyRegistry::get<OrgFreedesktopNetworkManagerDeviceInterface>(NM_DBUS_SERVICE, "/org/freedesktop/NetworkManager/Devices/0", connection);
+    auto device1 = ProxyRegistry::get<OrgFreedesktopNetworkManagerDeviceInterface>(NM_DBUS_SERVICE, "/org/freedesktop/NetworkManager/Devices/1", connection);
+    EXPECT_NE(device0, device1);
+
+    // same path, different interface
+    auto nmAsDevice = ProxyRegistry::get<OrgFreedesktopNetworkManagerDeviceInterface>(NM_DBUS_SERVICE, NM_DBUS_PATH, connection);
+    EXPECT_NE(static_pointer_cast<QDBusAbstractInterface>(nm), static_pointer_cast<QDBusAbstractInterface>(nmAsDevice));
+
+    EXPECT_EQ(before + 4, ProxyRegistry::size());
+}
+
+TEST_F(TestProxyRegistry, DropsUnusedProxies)
+{
+    auto connection = dbusTestRunner.systemConnection();
+    int before = ProxyRegistry::size();
+
+    auto device = ProxyRegistry::get<OrgFreedesktopNetworkManagerDeviceInterface>(NM_DBUS_SERVICE, "/org/freedesktop/NetworkManager/Devices/0", connection);
+    EXPECT_EQ(before + 1, ProxyRegistry::size());
+
+    device.reset();
+    EXPECT_EQ(before, ProxyRegistry::size());
+
+    // a new one is made on demand
+    device = ProxyRegistry::get<OrgFreedesktopNetworkManagerDeviceInterface>(NM_DBUS_SERVICE, "/org/freedesktop/NetworkManager/Devices/0", connection);
+    ASSERT_TRUE(bool(device));
+    EXPECT_EQ("/org/freedesktop/NetworkManager/Devices/0", device->path());
+}
+
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright © 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmofono/vpn/openvpn-connection.h>
+#include <dbus-types.h>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <QSignalSpy>
+
+using namespace std;
+using namespace testing;
+
+using namespace nmofono::vpn;
+
+namespace
+{
+
+class TestOpenvpnConnection : public Test
+{
+protected:
+    static QStringMap initialData()
+    {
+        return {
+            {"connection-type", "password-tls"},
+            {"remote", "remotey"},
+            {"ca", "/my/ca.crt"},
+            {"port", "1234"},
+            {"comp-lzo", "yes"},
+            {"cipher", "AES-256-CBC"},
+            {"remote-cert-tls", "client"},
+            {"dev-type", "tap"},
+            {"dev", "tap0"}
+        };
+    }
+};
+
+TEST_F(TestOpenvpnConnection, DecodesData)
+{
+    OpenvpnConnection connection;
+    connection.updateData(initialData());
+
+    EXPECT_EQ(OpenvpnConnection::ConnectionType::PASSWORD_TLS, connection.connectionType());
+    EXPECT_EQ("remotey", connection.remote());
+    EXPECT_EQ("/my/ca.crt", connection.ca());
+    EXPECT_TRUE(connection.portSet());
+    EXPECT_EQ(1234, connection.port());
+    EXPECT_FALSE(connection.renegSecondsSet());
+    EXPECT_TRUE(connection.compLzo());
+    EXPECT_FALSE(connection.protoTcp());
+    EXPECT_EQ(OpenvpnConnection::Cipher::AES_256_CBC, connection.cipher());
+    EXPECT_EQ(OpenvpnConnection::Auth::DEFAULT_AUTH, connection.auth());
+    EXPECT_TRUE(connection.remoteCertTlsSet());
+    EXPECT_EQ(OpenvpnConnection::TlsType::CLIENT, connection.remoteCertTls());
+    EXPECT_TRUE(connection.devTypeSet());
+    EXPECT_EQ(OpenvpnConnection::DevType::TAP, connection.devType());
+    EXPECT_EQ("tap0", connection.dev());
+    EXPECT_EQ(OpenvpnConnection::ProxyType::NOT_REQUIRED, connection.proxyType());
+
+    connection.updateSecrets({{"password", "the password"}, {"cert-pass", "the cert pass"}});
+    EXPECT_EQ("the password", connection.password());
+    EXPECT_EQ("the cert pass", connection.certPass());
+}
+
+TEST_F(TestOpenvpnConnection, RefreshOnlyTouchesChangedFields)
+{
+    OpenvpnConnection connection;
+    connection.updateData(initialData());
+
+    QSignalSpy remoteSpy(&connection, SIGNAL(remoteChanged(const QString &)));
+    QSignalSpy caSpy(&connection, SIGNAL(caChanged(const QString &)));
+    QSignalSpy portSpy(&connection, SIGNAL(portChanged(int)));
+    QSignalSpy portSetSpy(&connection, SIGNAL(portSetChanged(bool)));
+    QSignalSpy compLzoSpy(&connection, SIGNAL(compLzoChanged(bool)));
+
+    // the same settings again
+    connection.updateData(initialData());
+    EXPECT_TRUE(remoteSpy.isEmpty());
+    EXPECT_TRUE(caSpy.isEmpty());
+    EXPECT_TRUE(portSpy.isEmpty());
+    EXPECT_TRUE(compLzoSpy.isEmpty());
+
+    auto data = initialData();
+    data["remote"] = "remote2";
+    data.remove("port");
+    data.remove("comp-lzo");
+    connection.updateData(data);
+
+    EXPECT_EQ(QVariantList{"remote2"}, remoteSpy.takeFirst());
+    EXPECT_TRUE(caSpy.isEmpty());
+    // the port itself is kept, only the flag goes
+    EXPECT_TRUE(portSpy.isEmpty());
+    EXPECT_EQ(QVariantList{false}, portSetSpy.takeFirst());
+    EXPECT_EQ(QVariantList{false}, compLzoSpy.takeFirst());
+    EXPECT_EQ(1234, connection.port());
+}
+
+TEST_F(TestOpenvpnConnection, EncodesEdits)
+{
+    OpenvpnConnection connection;
+    connection.updateData(initialData());
+
+    QSignalSpy dataEditedSpy(&connection, SIGNAL(vpnDataEdited()));
+    connection.setCipher(OpenvpnConnection::Cipher::CAMELLIA_128_CBC);
+    connection.setRemoteCertTls(OpenvpnConnection::TlsType::SERVER);
+    EXPECT_EQ(2, dataEditedSpy.size());
+
+    // the committed values don't change until NetworkManager reports them
+    EXPECT_EQ(OpenvpnConnection::Cipher::AES_256_CBC, connection.cipher());
+
+    auto data = connection.pendingVpnData();
+    EXPECT_EQ("password-tls", data["connection-type"]);
+    EXPECT_EQ("CAMELLIA-128-CBC", data["cipher"]);
+    EXPECT_EQ("server", data["remote-cert-tls"]);
+    EXPECT_EQ("tap", data["dev-type"]);
+    EXPECT_EQ("1234", data["port"]);
+    EXPECT_FALSE(data.contains("auth"));
+}
+
+} // namespace
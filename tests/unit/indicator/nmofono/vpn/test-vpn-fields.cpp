@@ -0,0 +1,173 @@
+/*
+ * Copyright © 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmofono/vpn/openvpn-connection.h>
+#include <nmofono/vpn/pptp-connection.h>
+#include <dbus-types.h>
+#include <vpn-fields.h>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <QMetaProperty>
+
+#include <map>
+#include <memory>
+
+using namespace std;
+using namespace testing;
+
+using namespace nmofono::vpn;
+
+namespace
+{
+
+class Counter : public QObject
+{
+    Q_OBJECT
+
+public:
+    int count = 0;
+
+public Q_SLOTS:
+    void changed()
+    {
+        ++count;
+    }
+};
+
+class TestVpnFields : public Test
+{
+protected:
+    /// a value other than the default for every field that has a key
+    template<size_t N>
+    static void encodeAll(const vpnfields::Field (&fields)[N], QStringMap& data, QStringMap& secrets)
+    {
+        for (const auto& field : fields)
+        {
+            if (!field.key)
+            {
+                continue;
+            }
+
+            QString value;
+            switch (field.type)
+            {
+                case vpnfields::Type::String:
+                    value = "value";
+                    break;
+                case vpnfields::Type::Bool:
+                case vpnfields::Type::AntiBool:
+                    value = "yes";
+                    break;
+                case vpnfields::Type::Int:
+                    value = "42";
+                    break;
+                case vpnfields::Type::Enum:
+                    value = field.values[1];
+                    break;
+            }
+            (field.flags & vpnfields::Secret ? secrets : data)[field.key] = value;
+        }
+    }
+
+    /**
+     * Applies data and secrets to the connection and returns the fields,
+     * and the Set flags of the optional ones, that did not notify a change.
+     */
+    template<typename T, size_t N>
+    static QStringList unchanged(const vpnfields::Field (&fields)[N],
+                                 const QStringMap& data, const QStringMap& secrets)
+    {
+        T connection;
+
+        QStringList names;
+        for (const auto& field : fields)
+        {
+            names << field.name;
+            if (field.flags & vpnfields::Optional)
+            {
+                names << QString(field.name) + "Set";
+            }
+        }
+
+        QStringList result;
+        map<QString, unique_ptr<Counter>> counters;
+        auto metaObject = connection.metaObject();
+        for (const auto& name : names)
+        {
+            int index = metaObject->indexOfProperty(name.toLatin1().constData());
+            if (index < 0)
+            {
+                result << name;
+                continue;
+            }
+
+            auto& counter = counters[name];
+            counter = make_unique<Counter>();
+            QObject::connect(&connection, metaObject->property(index).notifySignal(),
+                             counter.get(), counter->metaObject()->method(
+                                     counter->metaObject()->indexOfSlot("changed()")));
+        }
+
+        connection.updateData(data);
+        connection.updateSecrets(secrets);
+
+        for (const auto& counter : counters)
+        {
+            if (counter.second->count == 0)
+            {
+                result << counter.first;
+            }
+        }
+        return result;
+    }
+};
+
+TEST_F(TestVpnFields, EveryOpenvpnFieldHasASetter)
+{
+    QStringMap data, secrets;
+    encodeAll(vpnfields::openvpn::FIELDS, data, secrets);
+
+    // the keys the hand written decoding looks at
+    data["dev-type"] = "tap";
+    data["dev"] = "tap0";
+    data["ta"] = "/my/ta.key";
+    data["ta-dir"] = "1";
+    data["proxy-type"] = "http";
+    data["proxy-server"] = "proxy";
+    data["proxy-port"] = "8080";
+    data["proxy-retry"] = "yes";
+    data["http-proxy-username"] = "proxy user";
+    secrets["http-proxy-password"] = "proxy password";
+
+    EXPECT_EQ(QStringList(), unchanged<OpenvpnConnection>(vpnfields::openvpn::FIELDS, data, secrets));
+}
+
+TEST_F(TestVpnFields, EveryPptpFieldHasASetter)
+{
+    QStringMap data, secrets;
+    encodeAll(vpnfields::pptp::FIELDS, data, secrets);
+
+    data["require-mppe-128"] = "yes";
+    data["lcp-echo-interval"] = "30";
+
+    EXPECT_EQ(QStringList(), unchanged<PptpConnection>(vpnfields::pptp::FIELDS, data, secrets));
+}
+
+} // namespace
+
+#include "test-vpn-fields.moc"
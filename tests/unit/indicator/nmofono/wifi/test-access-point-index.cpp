@@ -0,0 +1,174 @@
+/*
+ * Copyright © 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmofono/wifi/access-point-impl.h>
+#include <nmofono/wifi/access-point-index.h>
+
+#include <libqtdbustest/DBusTestRunner.h>
+#include <libqtdbusmock/DBusMock.h>
+#include <NetworkManager.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <QDBusMessage>
+#include <QDBusReply>
+
+using namespace std;
+using namespace testing;
+using namespace QtDBusTest;
+using namespace QtDBusMock;
+
+using namespace nmofono;
+
+namespace
+{
+
+class TestAccessPointIndex : public Test
+{
+protected:
+    TestAccessPointIndex() :
+        dbusMock(dbusTestRunner)
+    {
+    }
+
+    void SetUp() override
+    {
+        dbusMock.registerTemplate(NM_DBUS_SERVICE, NETWORK_MANAGER_TEMPLATE_PATH, {}, QDBusConnection::SystemBus);
+        dbusTestRunner.startServices();
+    }
+
+    // Creates count access points spread over ssids networks with
+    // several base stations each.
+    vector<wifi::AccessPointImpl::Ptr> createAccessPoints(int count, int ssids)
+    {
+        auto& networkManager(dbusMock.networkManagerInterface());
+
+        auto deviceReply = networkManager.AddWiFiDevice("device", "wlan0", NM_DEVICE_STATE_DISCONNECTED);
+        deviceReply.waitForFinished();
+        EXPECT_FALSE(deviceReply.isError()) << deviceReply.error().message().toStdString();
+        QString device = deviceReply;
+
+        vector<wifi::AccessPointImpl::Ptr> accessPoints;
+        for (int i = 0; i < count; ++i)
+        {
+            auto reply = networkManager.AddAccessPoint(
+                    device, QString("ap%1").arg(i), QString("ssid%1").arg(i % ssids),
+                    QString("00:00:00:00:%1:%2").arg(i / 256, 2, 16, QChar('0')).arg(i % 256, 2, 16, QChar('0')),
+                    NM_802_11_MODE_INFRA, 0, 0, i % 100, NM_802_11_AP_SEC_KEY_MGMT_PSK);
+            reply.waitForFinished();
+            EXPECT_FALSE(reply.isError()) << reply.error().message().toStdString();
+
+            auto message = QDBusMessage::createMethodCall(NM_DBUS_SERVICE,
+                    reply.value(), "org.freedesktop.DBus.Properties", "GetAll");
+            message << QString(NM_DBUS_INTERFACE_ACCESS_POINT);
+            QDBusReply<QVariantMap> properties = dbusTestRunner.systemConnection().call(message);
+            EXPECT_TRUE(properties.isValid()) << properties.error().message().toStdString();
+
+            auto proxy = make_shared<OrgFreedesktopNetworkManagerAccessPointInterface>(
+                    NM_DBUS_SERVICE, reply.value(), dbusTestRunner.systemConnection());
+            accessPoints.emplace_back(make_shared<wifi::AccessPointImpl>(proxy, properties.value()));
+        }
+        return accessPoints;
+    }
+
+    DBusTestRunner dbusTestRunner;
+
+    DBusMock dbusMock;
+};
+
+TEST_F(TestAccessPointIndex, GroupsByKey)
+{
+    auto accessPoints = createAccessPoints(4, 2);
+    wifi::AccessPointIndex index;
+
+    bool created;
+    auto group0 = index.add(accessPoints[0], created);
+    EXPECT_TRUE(created);
+    auto group1 = index.add(accessPoints[1], created);
+    EXPECT_TRUE(created);
+    EXPECT_EQ(group0, index.add(accessPoints[2], created));
+    EXPECT_FALSE(created);
+    EXPECT_EQ(group1, index.add(accessPoints[3], created));
+    EXPECT_FALSE(created);
+
+    // adding the same path twice is refused
+    EXPECT_FALSE(bool(index.add(accessPoints[0], created)));
+    EXPECT_FALSE(created);
+
+    EXPECT_EQ(4, index.size());
+    EXPECT_EQ(2, index.groupCount());
+    EXPECT_EQ(group0, index.group(accessPoints[2]->object_path()));
+    EXPECT_TRUE(group0->has_object(accessPoints[2]->object_path()));
+
+    bool emptied;
+    EXPECT_EQ(group0, index.remove(accessPoints[0]->object_path(), emptied));
+    EXPECT_FALSE(emptied);
+    EXPECT_EQ(group0, index.remove(accessPoints[2]->object_path(), emptied));
+    EXPECT_TRUE(emptied);
+    EXPECT_FALSE(bool(index.remove(accessPoints[2]->object_path(), emptied)));
+
+    EXPECT_FALSE(index.contains(accessPoints[0]->object_path()));
+    EXPECT_EQ(2, index.size());
+    EXPECT_EQ(1, index.groupCount());
+}
+
+TEST_F(TestAccessPointIndex, ReplaysScanChurn)
+{
+    static const int COUNT = 500;
+    static const int ROUNDS = 2;
+
+    auto accessPoints = createAccessPoints(COUNT, 100);
+    wifi::AccessPointIndex index;
+
+    bool flag;
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        // a full scan comes in
+        for (const auto& ap : accessPoints)
+        {
+            index.add(ap, flag);
+        }
+        ASSERT_EQ(COUNT, index.size());
+        ASSERT_EQ(100, index.groupCount());
+
+        // the active connection lookup
+        for (const auto& ap : accessPoints)
+        {
+            ASSERT_TRUE(bool(index.group(ap->object_path())));
+        }
+
+        // every other base station goes out of range and comes back
+        for (int i = 0; i < COUNT; i += 2)
+        {
+            index.remove(accessPoints[i]->object_path(), flag);
+        }
+        ASSERT_EQ(COUNT / 2, index.size());
+        for (int i = 0; i < COUNT; i += 2)
+        {
+            index.add(accessPoints[i], flag);
+        }
+
+        // and finally everything disappears
+        for (const auto& ap : accessPoints)
+        {
+            index.remove(ap->object_path(), flag);
+        }
+        ASSERT_EQ(0, index.size());
+        ASSERT_EQ(0, index.groupCount());
+    }
+}
+
+} // namespace
@@ -0,0 +1,156 @@
+/*
+ * Copyright © 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmofono/wifi/known-connections.h>
+#include <NetworkManagerSettingsInterface.h>
+#include <dbus-types.h>
+
+#include <libqtdbustest/DBusTestRunner.h>
+#include <libqtdbusmock/DBusMock.h>
+#include <NetworkManager.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <QSignalSpy>
+
+using namespace std;
+using namespace testing;
+using namespace QtDBusTest;
+using namespace QtDBusMock;
+
+using namespace nmofono;
+
+namespace
+{
+
+class TestKnownConnections : public Test
+{
+protected:
+    TestKnownConnections() :
+        dbusMock(dbusTestRunner)
+    {
+    }
+
+    void SetUp() override
+    {
+        dbusMock.registerTemplate(NM_DBUS_SERVICE, NETWORK_MANAGER_TEMPLATE_PATH, {}, QDBusConnection::SystemBus);
+        dbusTestRunner.startServices();
+
+        auto& networkManager(dbusMock.networkManagerInterface());
+        auto deviceReply = networkManager.AddWiFiDevice("device", "wlan0", NM_DEVICE_STATE_DISCONNECTED);
+        deviceReply.waitForFinished();
+        ASSERT_FALSE(deviceReply.isError()) << deviceReply.error().message().toStdString();
+        device = deviceReply;
+
+        for (const QString ssid : {"the ssid", "other ssid"})
+        {
+            auto reply = networkManager.AddAccessPoint(
+                    device, ssid.split(' ').first(), ssid, "00:00:00:00:00:00",
+                    NM_802_11_MODE_INFRA, 0, 0, 50, NM_802_11_AP_SEC_KEY_MGMT_PSK);
+            reply.waitForFinished();
+            ASSERT_FALSE(reply.isError()) << reply.error().message().toStdString();
+        }
+    }
+
+    QString addConnection(const QString& id, const QString& ssid)
+    {
+        auto reply = dbusMock.networkManagerInterface().AddWiFiConnection(device, id, ssid, "");
+        reply.waitForFinished();
+        EXPECT_FALSE(reply.isError()) << reply.error().message().toStdString();
+        return reply;
+    }
+
+    QString addSettings(const QString& id, const QString& ssid, const QString& mode, const QString& interface)
+    {
+        OrgFreedesktopNetworkManagerSettingsInterface settings(
+                NM_DBUS_SERVICE, NM_DBUS_PATH_SETTINGS, dbusTestRunner.systemConnection());
+
+        QVariantDictMap connection;
+        connection["connection"] = QVariantMap {
+            {"type", "802-11-wireless"},
+            {"id", id}
+        };
+        if (!interface.isEmpty())
+        {
+            connection["connection"]["interface-name"] = interface;
+        }
+        connection["802-11-wireless"] = QVariantMap {
+            {"ssid", ssid.toUtf8()},
+            {"mode", mode}
+        };
+
+        auto reply = settings.AddConnection(connection);
+        reply.waitForFinished();
+        EXPECT_FALSE(reply.isError()) << reply.error().message().toStdString();
+        return reply.value().path();
+    }
+
+    DBusTestRunner dbusTestRunner;
+
+    DBusMock dbusMock;
+
+    QString device;
+};
+
+TEST_F(TestKnownConnections, TracksConnections)
+{
+    auto existing = addConnection("existing", "the ssid");
+
+    wifi::KnownConnections knownConnections(dbusTestRunner.systemConnection());
+    QSignalSpy changedSpy(&knownConnections, SIGNAL(changed()));
+
+    // the initial list is loaded asynchronously
+    EXPECT_TRUE(knownConnections.find("the ssid", "wlan0").isEmpty());
+    ASSERT_TRUE(changedSpy.wait());
+    EXPECT_EQ(QList<QDBusObjectPath>{QDBusObjectPath(existing)}, knownConnections.find("the ssid", "wlan0"));
+
+    changedSpy.clear();
+    auto added = addConnection("added", "other ssid");
+    ASSERT_TRUE(changedSpy.wait());
+    EXPECT_EQ(QList<QDBusObjectPath>{QDBusObjectPath(added)}, knownConnections.find("other ssid", "wlan0"));
+    EXPECT_EQ(2, knownConnections.size());
+
+    changedSpy.clear();
+    auto reply = dbusMock.networkManagerInterface().RemoveWifiConnection(device, existing);
+    reply.waitForFinished();
+    ASSERT_FALSE(reply.isError()) << reply.error().message().toStdString();
+    ASSERT_TRUE(changedSpy.wait());
+    EXPECT_TRUE(knownConnections.find("the ssid", "wlan0").isEmpty());
+    EXPECT_EQ(1, knownConnections.size());
+}
+
+TEST_F(TestKnownConnections, IgnoresProfilesThatDoNotJoin)
+{
+    // added first, so its settings arrive before the ones we wait for
+    addSettings("hotspot", "the ssid", "ap", "");
+    auto client = addConnection("client", "the ssid");
+    auto bound = addSettings("bound", "the ssid", "infrastructure", "wlan1");
+
+    wifi::KnownConnections knownConnections(dbusTestRunner.systemConnection());
+    QSignalSpy changedSpy(&knownConnections, SIGNAL(changed()));
+    while (knownConnections.size() < 2)
+    {
+        ASSERT_TRUE(changedSpy.wait());
+    }
+
+    // the hotspot is never a candidate, the bound one only on its interface
+    EXPECT_EQ(QList<QDBusObjectPath>{QDBusObjectPath(client)}, knownConnections.find("the ssid", "wlan0"));
+    EXPECT_EQ(QSet<QDBusObjectPath>({QDBusObjectPath(client), QDBusObjectPath(bound)}),
+              knownConnections.find("the ssid", "wlan1").toSet());
+    EXPECT_EQ(2, knownConnections.size());
+}
+
+} // namespace
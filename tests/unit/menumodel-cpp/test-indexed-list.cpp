@@ -0,0 +1,184 @@
+/*
+ * Copyright © 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <menumodel-cpp/indexed-list.h>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace testing;
+
+namespace
+{
+
+class TestIndexedList : public Test
+{
+protected:
+    vector<int> contents()
+    {
+        return vector<int>(list.begin(), list.end());
+    }
+
+    IndexedList<int> list;
+};
+
+TEST_F(TestIndexedList, InsertAndErase)
+{
+    EXPECT_TRUE(list.empty());
+    EXPECT_TRUE(list.begin() == list.end());
+
+    auto two = list.insert(list.end(), 2);
+    list.insert(list.end(), 4);
+    list.insert(list.begin(), 1);
+    list.insert(++two, 3);
+    EXPECT_EQ(vector<int>({1, 2, 3, 4}), contents());
+    EXPECT_EQ(4u, list.size());
+
+    auto next = list.erase(list.begin());
+    EXPECT_EQ(2, *next);
+    next = list.erase(--list.end());
+    EXPECT_TRUE(next == list.end());
+    EXPECT_EQ(vector<int>({2, 3}), contents());
+
+    list.clear();
+    EXPECT_TRUE(list.empty());
+    EXPECT_EQ(0u, list.size());
+}
+
+TEST_F(TestIndexedList, PositionalAccess)
+{
+    vector<IndexedList<int>::iterator> iterators;
+    for (int i = 0; i < 10; ++i)
+    {
+        iterators.push_back(list.insert(list.end(), i * 10));
+    }
+
+    for (size_t i = 0; i < iterators.size(); ++i)
+    {
+        EXPECT_EQ(i, list.index(iterators[i]));
+        EXPECT_EQ(int(i) * 10, list.at(i));
+    }
+    EXPECT_EQ(10u, list.index(list.end()));
+
+    list.at(3) = 33;
+    EXPECT_EQ(33, *iterators[3]);
+}
+
+TEST_F(TestIndexedList, UpperBound)
+{
+    for (int value : {10, 20, 20, 30})
+    {
+        list.insert(list.end(), value);
+    }
+
+    auto less = [](int a, int b) { return a < b; };
+    EXPECT_EQ(0u, list.index(list.upper_bound(5, less)));
+    EXPECT_EQ(1u, list.index(list.upper_bound(10, less)));
+    EXPECT_EQ(3u, list.index(list.upper_bound(20, less)));
+    EXPECT_EQ(3u, list.index(list.upper_bound(25, less)));
+    EXPECT_TRUE(list.upper_bound(30, less) == list.end());
+}
+
+TEST_F(TestIndexedList, IteratorsStayValid)
+{
+    auto a = list.insert(list.end(), 1);
+    auto b = list.insert(list.end(), 2);
+    auto c = list.insert(list.end(), 3);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        list.insert(i % 2 ? list.begin() : list.end(), 0);
+    }
+    list.erase(b);
+
+    EXPECT_EQ(1, *a);
+    EXPECT_EQ(3, *c);
+    EXPECT_EQ(list.index(a) + 1, list.index(c));
+    auto next = a;
+    EXPECT_TRUE(++next == c);
+    EXPECT_TRUE(--next == a);
+}
+
+TEST_F(TestIndexedList, MatchesVector)
+{
+    mt19937 random(42);
+    vector<int> reference;
+    vector<IndexedList<int>::iterator> iterators;
+
+    for (int step = 0; step < 2000; ++step)
+    {
+        if (reference.empty() || random() % 3 != 0)
+        {
+            size_t position = random() % (reference.size() + 1);
+            int value = random() % 1000;
+            auto iter = position == reference.size() ? list.end() : iterators[position];
+
+            auto inserted = list.insert(iter, value);
+            reference.insert(reference.begin() + position, value);
+            iterators.insert(iterators.begin() + position, inserted);
+        }
+        else
+        {
+            size_t position = random() % reference.size();
+
+            auto next = list.erase(iterators[position]);
+            reference.erase(reference.begin() + position);
+            iterators.erase(iterators.begin() + position);
+            EXPECT_TRUE(next == (position == reference.size() ? list.end() : iterators[position]));
+        }
+
+        ASSERT_EQ(reference.size(), list.size());
+        if (step % 100 == 0)
+        {
+            ASSERT_EQ(reference, contents());
+            for (size_t i = 0; i < reference.size(); ++i)
+            {
+                ASSERT_EQ(i, list.index(iterators[i]));
+                ASSERT_EQ(reference[i], list.at(i));
+            }
+        }
+    }
+
+    ASSERT_EQ(reference, contents());
+    vector<int> reversed(reference.rbegin(), reference.rend());
+    vector<int> backwards;
+    for (auto iter = list.end(); iter != list.begin();)
+    {
+        backwards.push_back(*--iter);
+    }
+    EXPECT_EQ(reversed, backwards);
+
+    // sorted contents are found with a binary search
+    list.clear();
+    sort(reference.begin(), reference.end());
+    for (int value : reference)
+    {
+        list.insert(list.end(), value);
+    }
+    auto less = [](int a, int b) { return a < b; };
+    for (int value : {-1, 0, 250, 500, 999, 1000})
+    {
+        size_t expected = upper_bound(reference.begin(), reference.end(), value) - reference.begin();
+        EXPECT_EQ(expected, list.index(list.upper_bound(value, less)));
+    }
+}
+
+} // namespace
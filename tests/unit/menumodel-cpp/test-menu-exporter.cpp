@@ -156,4 +156,60 @@ TEST_F(TestMenuExporter, ParameterizedActionActivation)
     EXPECT_EQ("hello", v.as<string>());
 }
 
+TEST_F(TestMenuExporter, InsertSortedByLabel)
+{
+    menu->insert(make_shared<MenuItem>("cherry", "app.cherry"), &MenuItem::labelLessThan);
+    menu->insert(make_shared<MenuItem>("apple", "app.apple"), &MenuItem::labelLessThan);
+    menu->insert(make_shared<MenuItem>("Banana", "app.banana"), &MenuItem::labelLessThan);
+    menuExporter.reset(new MenuExporter(sessionBus, "/menus/path", menu));
+
+    EXPECT_MATCHRESULT(mh::MenuMatcher(parameters("app"))
+        .item(mh::MenuItemMatcher()
+            .label("apple")
+        )
+        .item(mh::MenuItemMatcher()
+            .label("Banana")
+        )
+        .item(mh::MenuItemMatcher()
+            .label("cherry")
+        ).match());
+}
+
+TEST_F(TestMenuExporter, SetState)
+{
+    auto apple = make_shared< ::Action>("apple", nullptr, TypedVariant<bool>(false));
+    auto banana = make_shared< ::Action>("banana", nullptr, TypedVariant<bool>(true));
+    actionGroup->add(apple);
+    actionGroup->add(banana);
+    actionGroupExporter.reset(
+            new ActionGroupExporter(sessionBus, actionGroup, "/actions/path"));
+
+    menu->append(make_shared<MenuItem>("Apple", "app.apple"));
+    menu->append(make_shared<MenuItem>("Banana", "app.banana"));
+    menuExporter.reset(new MenuExporter(sessionBus, "/menus/path", menu));
+
+    QSignalSpy appleSpy(apple.get(), SIGNAL(stateUpdated(const Variant&)));
+    QSignalSpy bananaSpy(banana.get(), SIGNAL(stateUpdated(const Variant&)));
+
+    apple->setState(TypedVariant<bool>(true));
+    banana->setState(TypedVariant<bool>(true));
+
+    // only the action that actually changed is notified
+    EXPECT_EQ(1, appleSpy.size());
+    EXPECT_TRUE(bananaSpy.isEmpty());
+    EXPECT_TRUE(apple->state().as<bool>());
+
+    EXPECT_MATCHRESULT(mh::MenuMatcher(parameters("app"))
+        .item(mh::MenuItemMatcher()
+            .label("Apple")
+            .action("app.apple")
+            .toggled(true)
+        )
+        .item(mh::MenuItemMatcher()
+            .label("Banana")
+            .action("app.banana")
+            .toggled(true)
+        ).match());
+}
+
 } // namespace
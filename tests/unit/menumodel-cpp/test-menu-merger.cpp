@@ -0,0 +1,186 @@
+/*
+ * Copyright © 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <menumodel-cpp/menu.h>
+#include <menumodel-cpp/menu-merger.h>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <tuple>
+
+using namespace std;
+using namespace testing;
+
+namespace
+{
+
+typedef tuple<int, int, int> ItemsChanged;
+
+class TestMenuMerger : public Test
+{
+protected:
+    void SetUp() override
+    {
+        merger = make_shared<MenuMerger>();
+        handlerId = g_signal_connect(static_cast<GMenuModel*>(*merger), "items-changed",
+                                     G_CALLBACK(itemsChangedCb), &changes);
+    }
+
+    void TearDown() override
+    {
+        g_signal_handler_disconnect(static_cast<GMenuModel*>(*merger), handlerId);
+    }
+
+    static void itemsChangedCb(GMenuModel*, gint position, gint removed,
+                               gint added, gpointer userData)
+    {
+        static_cast<vector<ItemsChanged>*>(userData)->emplace_back(position, removed, added);
+    }
+
+    static Menu::Ptr newMenu(const vector<QString>& labels)
+    {
+        auto menu = make_shared<Menu>();
+        for (const auto& label : labels)
+        {
+            menu->append(make_shared<MenuItem>(label));
+        }
+        return menu;
+    }
+
+    // run the idle handler that publishes the pending changes
+    static void idle()
+    {
+        while (g_main_context_iteration(nullptr, FALSE))
+        {
+        }
+    }
+
+    vector<QString> labels()
+    {
+        GMenuModel* model = *merger;
+        vector<QString> result;
+        for (int i = 0; i < g_menu_model_get_n_items(model); ++i)
+        {
+            gchar* label = nullptr;
+            g_menu_model_get_item_attribute(model, i, G_MENU_ATTRIBUTE_LABEL, "s", &label);
+            result.emplace_back(QString::fromUtf8(label));
+            g_free(label);
+        }
+        return result;
+    }
+
+    MenuMerger::Ptr merger;
+
+    gulong handlerId = 0;
+
+    vector<ItemsChanged> changes;
+};
+
+TEST_F(TestMenuMerger, AppendAndRemoveMenus)
+{
+    auto first = newMenu({"a0", "a1"});
+    auto second = newMenu({"b0"});
+    auto third = newMenu({"c0", "c1"});
+
+    merger->append(first);
+    merger->append(second);
+    merger->append(third);
+    EXPECT_EQ(vector<ItemsChanged>({{0, 0, 2}, {2, 0, 1}, {3, 0, 2}}), changes);
+    EXPECT_EQ(vector<QString>({"a0", "a1", "b0", "c0", "c1"}), labels());
+
+    changes.clear();
+    merger->remove(second);
+    EXPECT_EQ(vector<ItemsChanged>({{2, 1, 0}}), changes);
+    EXPECT_EQ(vector<QString>({"a0", "a1", "c0", "c1"}), labels());
+
+    // the removed menu is no longer followed
+    changes.clear();
+    second->append(make_shared<MenuItem>("b1"));
+    idle();
+    EXPECT_TRUE(changes.empty());
+
+    merger->clear();
+    EXPECT_EQ(vector<ItemsChanged>({{0, 4, 0}}), changes);
+    EXPECT_TRUE(labels().empty());
+}
+
+TEST_F(TestMenuMerger, OffsetsNestedChanges)
+{
+    auto first = newMenu({"a0", "a1"});
+    auto second = newMenu({"b0", "b1"});
+    auto third = newMenu({"c0"});
+    merger->append(first);
+    merger->append(second);
+    merger->append(third);
+    changes.clear();
+
+    // inserting into the second menu is shifted by the size of the first
+    second->insert(make_shared<MenuItem>("new"), ++second->begin());
+    EXPECT_TRUE(changes.empty());
+    idle();
+    EXPECT_EQ(vector<ItemsChanged>({{3, 0, 1}}), changes);
+    EXPECT_EQ(vector<QString>({"a0", "a1", "b0", "new", "b1", "c0"}), labels());
+
+    // removing from the last menu is shifted by both before it
+    changes.clear();
+    third->remove(third->begin());
+    idle();
+    EXPECT_EQ(vector<ItemsChanged>({{5, 1, 0}}), changes);
+    EXPECT_EQ(vector<QString>({"a0", "a1", "b0", "new", "b1"}), labels());
+
+    // and the following menus are shifted by a change in the first
+    changes.clear();
+    first->remove(first->begin());
+    idle();
+    EXPECT_EQ(vector<ItemsChanged>({{0, 1, 0}}), changes);
+
+    changes.clear();
+    second->append(make_shared<MenuItem>("b2"));
+    idle();
+    EXPECT_EQ(vector<ItemsChanged>({{4, 0, 1}}), changes);
+    EXPECT_EQ(vector<QString>({"a1", "b0", "new", "b1", "b2"}), labels());
+}
+
+TEST_F(TestMenuMerger, CoalescesChanges)
+{
+    auto first = newMenu({"a0", "a1"});
+    auto second = newMenu({"b0", "b1"});
+    auto third = newMenu({"c0"});
+    merger->append(first);
+    merger->append(second);
+    merger->append(third);
+    changes.clear();
+
+    second->insert(make_shared<MenuItem>("new"), ++second->begin());
+    first->remove(first->begin());
+    EXPECT_TRUE(changes.empty());
+
+    // one emission spanning both changes, the untouched tail is left alone
+    idle();
+    EXPECT_EQ(vector<ItemsChanged>({{0, 3, 3}}), changes);
+    EXPECT_EQ(vector<QString>({"a1", "b0", "new", "b1", "c0"}), labels());
+
+    // a change that is undone before the idle publishes nothing
+    changes.clear();
+    third->append(make_shared<MenuItem>("c1"));
+    third->remove(++third->begin());
+    idle();
+    EXPECT_TRUE(changes.empty());
+    EXPECT_EQ(vector<QString>({"a1", "b0", "new", "b1", "c0"}), labels());
+}
+
+} // namespace
@@ -0,0 +1,167 @@
+/*
+ * Copyright © 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <menumodel-cpp/menu.h>
+#include <menumodel-cpp/menu-merger.h>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+
+#include <tuple>
+
+using namespace std;
+using namespace testing;
+
+namespace
+{
+
+typedef tuple<int, int, int> ItemsChanged;
+
+class TestMenu : public Test
+{
+protected:
+    void SetUp() override
+    {
+        menu = make_shared<Menu>();
+        for (const auto& label : {"a", "b", "c"})
+        {
+            items.push_back(make_shared<MenuItem>(label, "app.action"));
+            menu->append(items.back());
+        }
+
+        merger = make_shared<MenuMerger>();
+        merger->append(menu);
+
+        follow(*menu, &menuChanges);
+        follow(*merger, &mergerChanges);
+    }
+
+    void TearDown() override
+    {
+        for (auto& handler : handlers)
+        {
+            g_signal_handler_disconnect(handler.first, handler.second);
+        }
+    }
+
+    void follow(GMenuModel* model, vector<ItemsChanged>* changes)
+    {
+        handlers.emplace_back(model, g_signal_connect(model, "items-changed",
+                                                      G_CALLBACK(itemsChangedCb), changes));
+    }
+
+    static void itemsChangedCb(GMenuModel*, gint position, gint removed,
+                               gint added, gpointer userData)
+    {
+        static_cast<vector<ItemsChanged>*>(userData)->emplace_back(position, removed, added);
+    }
+
+    // run the timer that flushes item changes and the merger's idle
+    static void settle()
+    {
+        QCoreApplication::processEvents();
+        while (g_main_context_iteration(nullptr, FALSE))
+        {
+        }
+    }
+
+    string stringAttribute(int position, const char* attribute)
+    {
+        gchar* value = nullptr;
+        g_menu_model_get_item_attribute(*menu, position, attribute, "s", &value);
+        string result = value ? value : "";
+        g_free(value);
+        return result;
+    }
+
+    Menu::Ptr menu;
+
+    MenuMerger::Ptr merger;
+
+    vector<MenuItem::Ptr> items;
+
+    vector<pair<GMenuModel*, gulong>> handlers;
+
+    vector<ItemsChanged> menuChanges;
+
+    vector<ItemsChanged> mergerChanges;
+};
+
+TEST_F(TestMenu, CoalescesItemChanges)
+{
+    auto item = items[1];
+    item->setLabel("b2");
+    item->setAttribute("x-canonical-type", TypedVariant<string>("type"));
+    item->setAttribute("x-canonical-extra", TypedVariant<string>("extra"));
+    item->setAction("app.other");
+
+    // nothing is published before the event loop runs
+    EXPECT_TRUE(menuChanges.empty());
+
+    // the item is replaced once for all of them
+    settle();
+    EXPECT_EQ(vector<ItemsChanged>({{1, 1, 0}, {1, 0, 1}}), menuChanges);
+    EXPECT_EQ(vector<ItemsChanged>({{1, 1, 1}}), mergerChanges);
+
+    EXPECT_EQ("b2", stringAttribute(1, G_MENU_ATTRIBUTE_LABEL));
+    EXPECT_EQ("app.other", stringAttribute(1, G_MENU_ATTRIBUTE_ACTION));
+    EXPECT_EQ("type", stringAttribute(1, "x-canonical-type"));
+    EXPECT_EQ("extra", stringAttribute(1, "x-canonical-extra"));
+}
+
+TEST_F(TestMenu, IgnoresChangesThatAreUndone)
+{
+    auto item = items[2];
+    item->setAttribute("x-canonical-type", TypedVariant<string>("type"));
+    settle();
+    menuChanges.clear();
+    mergerChanges.clear();
+
+    item->setLabel("changed");
+    item->setAttribute("x-canonical-type", TypedVariant<string>("other"));
+    item->setLabel("c");
+    item->setAttribute("x-canonical-type", TypedVariant<string>("type"));
+
+    settle();
+    EXPECT_TRUE(menuChanges.empty());
+    EXPECT_TRUE(mergerChanges.empty());
+    EXPECT_EQ("c", stringAttribute(2, G_MENU_ATTRIBUTE_LABEL));
+}
+
+TEST_F(TestMenu, ReplacesEveryPosition)
+{
+    // the same item twice
+    menu->append(items[0]);
+    settle();
+    menuChanges.clear();
+
+    items[0]->setLabel("a2");
+    settle();
+    EXPECT_EQ(vector<ItemsChanged>({{0, 1, 0}, {0, 0, 1}, {3, 1, 0}, {3, 0, 1}}), menuChanges);
+    EXPECT_EQ("a2", stringAttribute(0, G_MENU_ATTRIBUTE_LABEL));
+    EXPECT_EQ("a2", stringAttribute(3, G_MENU_ATTRIBUTE_LABEL));
+
+    // a removed item no longer causes any changes
+    menu->removeAll(items[0]);
+    menuChanges.clear();
+    items[0]->setLabel("a3");
+    settle();
+    EXPECT_TRUE(menuChanges.empty());
+}
+
+} // namespace
@@ -0,0 +1,99 @@
+/*
+ * Copyright © 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <menumodel-cpp/gio-helpers/variant.h>
+
+#include <unordered_set>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace testing;
+
+namespace
+{
+
+class TestVariant : public Test
+{
+protected:
+    static Variant icon(const string& name)
+    {
+        auto gicon = shared_ptr<GIcon>(g_themed_icon_new_with_default_fallbacks(name.c_str()), GObjectDeleter());
+        return Variant::fromGVariant(g_icon_serialize(gicon.get()));
+    }
+
+    /// Looks like what RootState publishes
+    static Variant rootState(const vector<string>& iconNames)
+    {
+        map<string, Variant> state;
+        vector<Variant> icons;
+        for (const auto& name : iconNames)
+        {
+            icons.push_back(icon(name));
+        }
+        state["icon"] = icon(iconNames.back());
+        state["icons"] = TypedVariant<vector<Variant>>(icons);
+        state["title"] = TypedVariant<string>("Network");
+        state["visible"] = TypedVariant<bool>(true);
+        return TypedVariant<map<string, Variant>>(state);
+    }
+};
+
+TEST_F(TestVariant, CompareBasicTypes)
+{
+    EXPECT_EQ(TypedVariant<string>("a"), TypedVariant<string>("a"));
+    EXPECT_NE(TypedVariant<string>("a"), TypedVariant<string>("b"));
+    EXPECT_EQ(TypedVariant<int32_t>(1), TypedVariant<int32_t>(1));
+    EXPECT_NE(TypedVariant<int32_t>(1), TypedVariant<int32_t>(2));
+    EXPECT_NE(TypedVariant<int32_t>(1), TypedVariant<uint8_t>(1));
+    EXPECT_NE(Variant(), TypedVariant<bool>(false));
+    EXPECT_EQ(Variant(), Variant());
+}
+
+TEST_F(TestVariant, CompareContainers)
+{
+    auto a = rootState({"gsm-3g-full", "nm-signal-100"});
+    auto b = rootState({"gsm-3g-full", "nm-signal-100"});
+    auto c = rootState({"gsm-3g-full", "nm-signal-75"});
+    auto d = rootState({"gsm-3g-full", "nm-signal-100", "hotspot-active"});
+
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_NE(a, d);
+
+    EXPECT_EQ(TypedVariant<vector<int32_t>>({1, 2}), TypedVariant<vector<int32_t>>({1, 2}));
+    EXPECT_NE(TypedVariant<vector<int32_t>>({1, 2}), TypedVariant<vector<int32_t>>({2, 1}));
+}
+
+TEST_F(TestVariant, HashIsConsistentWithEquality)
+{
+    auto a = rootState({"gsm-3g-full", "nm-signal-100"});
+    auto b = rootState({"gsm-3g-full", "nm-signal-100"});
+    EXPECT_EQ(hash<Variant>()(a), hash<Variant>()(b));
+    EXPECT_EQ(hash<Variant>()(TypedVariant<string>("a")), hash<Variant>()(TypedVariant<string>("a")));
+    EXPECT_EQ(0u, hash<Variant>()(Variant()));
+
+    unordered_set<Variant> set;
+    set.insert(a);
+    set.insert(b);
+    set.insert(rootState({"gsm-3g-full", "nm-signal-75"}));
+    set.insert(TypedVariant<string>("a"));
+    set.insert(TypedVariant<string>("a"));
+    EXPECT_EQ(3u, set.size());
+}
+
+} // namespace
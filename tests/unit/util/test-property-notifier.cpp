@@ -0,0 +1,140 @@
+/*
+ * Copyright © 2016 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <util/dbus-utils.h>
+
+#include <libqtdbustest/DBusTestRunner.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <QDBusArgument>
+#include <QSignalSpy>
+
+using namespace std;
+using namespace testing;
+using namespace QtDBusTest;
+
+namespace
+{
+
+class Exported : public QObject
+{
+    Q_OBJECT
+
+public:
+    Q_PROPERTY(int Alpha MEMBER m_alpha)
+    Q_PROPERTY(QString Beta MEMBER m_beta)
+    Q_PROPERTY(bool Gamma MEMBER m_gamma)
+
+    // deliberately not in the order of the properties
+    enum Property
+    {
+        Gamma,
+        Alpha,
+        Beta
+    };
+
+    int m_alpha = 1;
+    QString m_beta = "one";
+    bool m_gamma = false;
+};
+
+class Listener : public QObject
+{
+    Q_OBJECT
+
+Q_SIGNALS:
+    void changed(const QString& interface, const QVariantMap& properties);
+
+public Q_SLOTS:
+    void propertiesChanged(const QString& interface, const QVariantMap& properties,
+                           const QStringList&)
+    {
+        Q_EMIT changed(interface, properties);
+    }
+};
+
+class TestPropertyNotifier : public Test
+{
+protected:
+    void SetUp() override
+    {
+        auto connection = dbusTestRunner.sessionConnection();
+        ASSERT_TRUE(connection.connect("", "/exported", "org.freedesktop.DBus.Properties",
+                                       "PropertiesChanged", &listener,
+                                       SLOT(propertiesChanged(const QString&, const QVariantMap&, const QStringList&))));
+
+        notifier = make_unique<DBusUtils::PropertyNotifier>(
+                connection, exported, "/exported", "org.example.Exported",
+                DBusUtils::PropertyNotifier::Properties{
+                    {Exported::Alpha, "Alpha"},
+                    {Exported::Beta, "Beta"},
+                    {Exported::Gamma, "Gamma"}
+                });
+    }
+
+    DBusTestRunner dbusTestRunner;
+
+    Exported exported;
+
+    Listener listener;
+
+    unique_ptr<DBusUtils::PropertyNotifier> notifier;
+};
+
+TEST_F(TestPropertyNotifier, CoalescesChanges)
+{
+    QSignalSpy spy(&listener, SIGNAL(changed(const QString&, const QVariantMap&)));
+
+    exported.m_alpha = 2;
+    notifier->notify(Exported::Alpha);
+    exported.m_beta = "two";
+    notifier->notify({Exported::Beta, Exported::Alpha});
+    exported.m_alpha = 3;
+    notifier->notify("Alpha");
+
+    ASSERT_TRUE(spy.wait());
+    ASSERT_EQ(1, spy.size());
+    EXPECT_EQ("org.example.Exported", spy.first().at(0).toString());
+    EXPECT_EQ(QVariantMap({{"Alpha", 3}, {"Beta", "two"}}), spy.first().at(1).toMap());
+
+    // the next change is sent on its own, so nothing else was queued
+    spy.clear();
+    exported.m_gamma = true;
+    notifier->notify(Exported::Gamma);
+    ASSERT_TRUE(spy.wait());
+    ASSERT_EQ(1, spy.size());
+    EXPECT_EQ(QVariantMap({{"Gamma", true}}), spy.first().at(1).toMap());
+}
+
+TEST_F(TestPropertyNotifier, FlushesOnRequest)
+{
+    QSignalSpy spy(&listener, SIGNAL(changed(const QString&, const QVariantMap&)));
+
+    notifier->notify(Exported::Beta);
+    DBusUtils::flushPropertyChanges();
+
+    // nothing is left for the timer
+    notifier->notify("Unknown");
+    ASSERT_TRUE(spy.wait());
+    EXPECT_FALSE(spy.wait(200));
+    ASSERT_EQ(1, spy.size());
+    EXPECT_EQ(QVariantMap({{"Beta", "one"}}), spy.first().at(1).toMap());
+}
+
+} // namespace
+
+#include "test-property-notifier.moc"
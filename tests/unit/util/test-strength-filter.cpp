@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2016 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3, as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranties of
+ * MERCHANTABILITY, SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <util/strength-filter.h>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <QSignalSpy>
+
+using namespace std;
+using namespace testing;
+
+namespace
+{
+
+class TestStrengthFilter : public Test
+{
+protected:
+    util::StrengthFilter filter{{20, 40, 60, 80}, 5, 100};
+};
+
+TEST_F(TestStrengthFilter, DropsChangesWithinALevel)
+{
+    QSignalSpy spy(&filter, SIGNAL(valueChanged(double)));
+    filter.reset(45);
+
+    filter.update(50);
+    filter.update(59);
+    filter.update(41);
+
+    EXPECT_TRUE(spy.isEmpty());
+    EXPECT_EQ(45, filter.value());
+}
+
+TEST_F(TestStrengthFilter, PublishesLevelChangesImmediately)
+{
+    QSignalSpy spy(&filter, SIGNAL(valueChanged(double)));
+    filter.reset(45);
+
+    filter.update(60);
+    ASSERT_EQ(1, spy.size());
+    EXPECT_EQ(60, spy.first().first().toDouble());
+    EXPECT_EQ(60, filter.value());
+}
+
+TEST_F(TestStrengthFilter, AppliesHysteresisOnTheWayDown)
+{
+    QSignalSpy spy(&filter, SIGNAL(valueChanged(double)));
+    filter.reset(60);
+
+    // just under the threshold, but within the hysteresis
+    filter.update(57);
+    EXPECT_TRUE(spy.isEmpty());
+
+    filter.update(54);
+    ASSERT_EQ(1, spy.size());
+    EXPECT_EQ(54, spy.first().first().toDouble());
+}
+
+TEST_F(TestStrengthFilter, RateLimitsAndPublishesLatestValue)
+{
+    QSignalSpy spy(&filter, SIGNAL(valueChanged(double)));
+    filter.reset(45);
+
+    filter.update(65);
+    ASSERT_EQ(1, spy.size());
+
+    // within the minimum interval, so these are held back
+    filter.update(85);
+    filter.update(90);
+    EXPECT_EQ(1, spy.size());
+
+    ASSERT_TRUE(spy.wait());
+    ASSERT_EQ(2, spy.size());
+    EXPECT_EQ(90, spy.last().first().toDouble());
+}
+
+TEST_F(TestStrengthFilter, DropsHeldBackValueThatReturnsToLevel)
+{
+    QSignalSpy spy(&filter, SIGNAL(valueChanged(double)));
+    filter.reset(45);
+
+    filter.update(65);
+    filter.update(85);
+    filter.update(70);
+
+    EXPECT_FALSE(spy.wait(300));
+    ASSERT_EQ(1, spy.size());
+    EXPECT_EQ(65, filter.value());
+}
+
+} // namespace
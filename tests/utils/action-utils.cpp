@@ -53,14 +53,5 @@ testutils::findAction (ActionGroup::Ptr actionGroup, const QString &name)
     auto pos = name.indexOf('.');
     QString shortName = name.mid(pos + 1);
 
-    ::Action::Ptr action;
-    std::set< ::Action::Ptr> actions = actionGroup->actions();
-    for (auto it(actions.begin()); it != actions.end(); ++it)
-    {
-        if ((*it)->name() == shortName)
-        {
-            action = *it;
-        }
-    }
-    return action;
+    return actionGroup->action(shortName);
 }